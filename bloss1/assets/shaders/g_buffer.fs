@@ -1,21 +1,14 @@
 #version 460 core
 
-layout (location = 0) out vec3 gPosition;
-layout (location = 1) out vec3 gNormal;
-layout (location = 2) out vec4 gAlbedo;
-layout (location = 3) out vec3 gARM;
-layout (location = 4) out vec3 gEmissive;
-layout (location = 5) out float gDepth;
-layout (location = 6) out vec3 gViewFragPos;
-layout (location = 7) out vec3 gViewNormal;
+// Packed layout: the position is rebuilt from the depth texture in the lighting pass
+layout (location = 0) out vec2 gNormal; // Octahedral encoded, [0,1]
+layout (location = 1) out vec4 gAlbedo;
+layout (location = 2) out vec4 gARM;
+layout (location = 3) out vec4 gEmissive;
 
 in VS_OUT {
     vec2 TexCoords;
     mat3 TBN;
-    vec3 FragPos;
-
-    vec3 viewFragPos;
-    vec3 viewNormal;
 } fs_in;
 
 struct Material {
@@ -30,17 +23,26 @@ struct Material {
 
 uniform Material material;
 
+vec2 OctahedralEncode(vec3 n);
+
 void main() {    
     // Store data in the gbuffer textures
-    gPosition = fs_in.FragPos;
     gAlbedo = texture(material.diffuse, fs_in.TexCoords);
-    gARM = texture(material.metalness, fs_in.TexCoords).rgb; // ARM = AO, Roughness, Metalness (1 for each RGB channel)
-    gEmissive = texture(material.emissive, fs_in.TexCoords).rgb;
-    gDepth = gl_FragCoord.z;
+    gARM = vec4(texture(material.metalness, fs_in.TexCoords).rgb, 1.0); // ARM = AO, Roughness, Metalness (1 for each RGB channel)
+    gEmissive = vec4(texture(material.emissive, fs_in.TexCoords).rgb, 1.0);
 
     vec3 normal = texture(material.normal, fs_in.TexCoords).rgb;
-    gNormal = normalize(fs_in.TBN * (normal * 2.0 - 1.0)); // range [0,1] -> [-1,1]
+    gNormal = OctahedralEncode(normalize(fs_in.TBN * (normal * 2.0 - 1.0))); // range [0,1] -> [-1,1]
+}
+
+// Unit vector -> octahedron -> square, mapped to [0,1] for the unsigned normalized target
+vec2 OctahedralEncode(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+
+    vec2 e = n.xy;
+    if (n.z < 0.0) {
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
 
-    gViewFragPos = fs_in.viewFragPos;
-    gViewNormal = normalize(fs_in.viewNormal);
+    return e * 0.5 + 0.5;
 }
@@ -8,24 +8,40 @@ layout (location = 4) in vec3 bitangent;
 layout (location = 5) in ivec4 boneIDs;
 layout (location = 6) in vec4 weights;
 
+// Per instance index of the draw, selects the model matrix
+layout (location = 7) in int drawIndex;
+
+layout (std430, binding = 2) readonly buffer DrawData
+{
+    mat4 modelMatrices[];
+};
+
 out VS_OUT {
     vec2 TexCoords;
     mat3 TBN;
-    vec3 FragPos;
-
-    vec3 viewFragPos;
-    vec3 viewNormal;
 } vs_out;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Camera and frame constants, written once per frame (must match FrameUniforms)
+layout (std140, binding = 1) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection;
+    vec3 viewPos; // Camera position
+    float near;
+    vec3 lightDir; // Light direction for shadow mapping
+    float far;
+    vec2 viewport;
+    float time;
+    float dt;
+};
 
 const int MAX_BONES = 100;
 const int MAX_BONE_PER_VERTEX = 4;
 uniform mat4 finalBonesMatrices[MAX_BONES];
 
 void main() {
+    mat4 model = modelMatrices[drawIndex];
 
     // Bone influence
     vec4 positionAfterWeights = vec4(0.0);
@@ -55,15 +71,8 @@ void main() {
     vec3 N = normalize(vec3(model * vec4(normal, 0.0)));
     mat3 tbnMatrix = mat3(T, B, N);
 
-    vs_out.FragPos = fragPos.xyz;
     vs_out.TexCoords = texCoords;
     vs_out.TBN = tbnMatrix;
 
-    // View matrices
-    mat3 normalViewMatrix = transpose(inverse(mat3(view * model)));
-
-    vs_out.viewNormal = normalViewMatrix * normal;
-    vs_out.viewFragPos = (view * model * positionAfterWeights).xyz;
-
     gl_Position = projection * view * fragPos;
 }
@@ -15,7 +15,21 @@ uniform float heights[MAX_LAYERS];
 uniform bool toggleGradient;
 
 uniform mat4 model;
-uniform mat4 view;
+
+// Camera and frame constants, written once per frame (must match FrameUniforms)
+layout (std140, binding = 1) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection;
+    vec3 viewPos; // Camera position
+    float near;
+    vec3 lightDir; // Light direction for shadow mapping
+    float far;
+    vec2 viewport;
+    float time;
+    float dt;
+};
 
 struct DirLight {
     vec3 direction;
@@ -77,8 +91,6 @@ void main()
     // Gamma correction
     color.rgb = pow(color.rgb, vec3(1.0 / 2.2));
 
-    vec3 viewPos = view[3].xyz;
-
     vec3 x = dFdx(FragPos);
     vec3 y = dFdy(FragPos);
     vec3 normal = inverse(mat3(model)) * normalize(cross(x, y));
@@ -1,6 +1,7 @@
 #version 460 core
 
-layout (quads, fractional_odd_spacing, cw) in;
+// Equal spacing: an edge at level 2n has the vertices of the two level n edges of a finer neighbour
+layout (quads, equal_spacing, cw) in;
 
 // FBM
 uniform int octaves;
@@ -14,8 +15,21 @@ uniform float perlin_height;
 uniform int noise_algorithm;
 uniform vec2 displacement;
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Camera and frame constants, written once per frame (must match FrameUniforms)
+layout (std140, binding = 1) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection;
+    vec3 viewPos; // Camera position
+    float near;
+    vec3 lightDir; // Light direction for shadow mapping
+    float far;
+    vec2 viewport;
+    float time;
+    float dt;
+};
 
 in vec2 TextureCoord[];
 
@@ -2,11 +2,14 @@
 
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoord;
+layout (location = 2) in vec4 edgeLevels;
 
 out vec2 TexCoord;
+out vec4 EdgeLevels;
 
 void main()
 {
     gl_Position = vec4(position, 1.0);
     TexCoord = texCoord;
+    EdgeLevels = edgeLevels;
 }
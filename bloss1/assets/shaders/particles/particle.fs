@@ -2,8 +2,8 @@
 
 layout (location = 0) out vec4 FragColor;
 
-uniform vec4 color;
+in vec4 Color;
 
 void main() {
-    FragColor = color;
+    FragColor = Color;
 }
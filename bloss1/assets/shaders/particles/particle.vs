@@ -3,13 +3,29 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoord;
 
+// Per instance data
+layout (location = 7) in mat4 instanceModel;
+layout (location = 11) in vec4 instanceColor;
+
 out vec2 TexCoord;
+out vec4 Color;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
+// Camera and frame constants, written once per frame (must match FrameUniforms)
+layout (std140, binding = 1) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection;
+    vec3 viewPos; // Camera position
+    float near;
+    vec3 lightDir; // Light direction for shadow mapping
+    float far;
+    vec2 viewport;
+    float time;
+    float dt;
+};
 
 void main() {
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    gl_Position = projection * view * instanceModel * vec4(position, 1.0);
     TexCoord = texCoord;
+    Color = instanceColor;
 }
@@ -3,14 +3,14 @@
 layout (location = 0) out vec4 FragColor;
 
 in vec2 TexCoord;
+in vec4 Color;
 
 uniform sampler2D particleTexture;
-uniform vec4 color;
 
 void main() {
     vec4 particleColor = texture(particleTexture, TexCoord);
     if (particleColor.a < 0.5)
         discard;
 
-    FragColor = particleColor * color;
+    FragColor = particleColor * Color;
 }
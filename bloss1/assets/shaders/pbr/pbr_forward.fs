@@ -27,34 +27,64 @@ struct Textures
     samplerCube irradianceMap;
     samplerCube prefilterMap;
     sampler2D brdfLut;
-    sampler2DArray shadowMap;
+    sampler2D shadowMap; // Atlas with one square region per cascade
 };
 
-// Lights
-const int numberOfLights = 16;
-struct Lights
+// Lights: every light of the frame, the point lights are found through the cluster of the pixel
+const int numberOfLights = 16; // Directional lights
+const uvec3 clusterCounts = uvec3(16, 9, 24);
+
+struct PointLight
 {
-    // Point lights
-    vec3 pointLightColors[numberOfLights];
-    vec3 pointLightPositions[numberOfLights];
+    vec4 positionRange; // World position (xyz) and range (w)
+    vec4 color;
+};
 
-    // Directional lights
-    vec3 dirLightDirections[numberOfLights];
-    vec3 dirLightColors[numberOfLights];
+layout (std430, binding = 3) readonly buffer LightData
+{
+    uint pointLightCount;
+    uint dirLightCount;
+    vec4 dirLightDirections[numberOfLights];
+    vec4 dirLightColors[numberOfLights];
+    PointLight pointLights[];
 };
 
+layout (std430, binding = 4) readonly buffer LightClusters
+{
+    uvec2 clusterRanges[]; // Offset and count in the light indices
+};
+
+layout (std430, binding = 5) readonly buffer LightIndices
+{
+    uint lightIndices[];
+};
+
+uniform vec2 clusterTileSize;
+uniform float clusterScale; // slice = log(depth) * scale + bias
+uniform float clusterBias;
+
 uniform Material material;
 uniform Textures textures;
-uniform Lights lights;
 
-uniform vec3 viewPos; // Camera position
-uniform float near;
-uniform float far;
-uniform vec3 lightDir; // Light direction for shadow mapping
+// Camera and frame constants, written once per frame (must match FrameUniforms)
+layout (std140, binding = 1) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection;
+    vec3 viewPos; // Camera position
+    float near;
+    vec3 lightDir; // Light direction for shadow mapping
+    float far;
+    vec2 viewport;
+    float time;
+    float dt;
+};
 
 // Shadow mapping
 uniform float cascadePlaneDistances[16];
 uniform int cascadeCount;   // number of frusta - 1
+uniform vec4 cascadeAtlasRects[16]; // Offset (xy) and scale (zw) of each cascade in the atlas
 
 layout (std140, binding = 0) uniform LightSpaceMatrices
 {
@@ -69,6 +99,7 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness);
 vec3 FresnelSchlick(float cosTheta, vec3 F0);
 vec3 FresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness);
 float DirectShadowCalculation(vec3 fragPosWorldSpace, vec3 normalizedNormal, float Depth);
+float LinearizeDepth(float depth);
 
 void main()
 {
@@ -101,17 +132,26 @@ void main()
 
     // Reflectance equation
     vec3 Lo = vec3(0.0);
-    for (int i = 0; i < numberOfLights; i++) {
+
+    // Point lights of the pixel cluster
+    float viewDepth = abs(LinearizeDepth(gl_FragCoord.z));
+    uint slice = uint(max(log(viewDepth) * clusterScale + clusterBias, 0.0));
+    uvec3 cluster = min(uvec3(uvec2(gl_FragCoord.xy / clusterTileSize), slice), clusterCounts - 1);
+
+    uvec2 clusterRange = clusterRanges[(cluster.z * clusterCounts.y + cluster.y) * clusterCounts.x + cluster.x];
+    for (uint i = 0; i < clusterRange.y; i++) {
+        PointLight light = pointLights[lightIndices[clusterRange.x + i]];
 
         // Calculate per-light radiance
-        vec3 L = normalize(lights.pointLightPositions[i] - fs_in.FragPos);
+        vec3 L = normalize(light.positionRange.xyz - fs_in.FragPos);
         vec3 H = normalize(V + L);
 
-        float distance = length(lights.pointLightPositions[i] - fs_in.FragPos);
-        float attenuation = 1.0 / (distance * distance);
+        // Fade out at the range so the light does not end at a cluster border
+        float distance = length(light.positionRange.xyz - fs_in.FragPos);
+        float window = clamp(1.0 - pow(distance / light.positionRange.w, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (distance * distance);
 
-        vec3 pointLightRadiance = lights.pointLightColors[i] * attenuation;
-        vec3 dirLightRadiance = lights.dirLightColors[i] * max(dot(N, -lights.dirLightDirections[i]), 0.0) * Diffuse.rgb;
+        vec3 pointLightRadiance = light.color.rgb * attenuation;
 
         // Cook-Torrance BRDF
         float NDF = DistributionGGX(N, H, Roughness);
@@ -129,10 +169,12 @@ void main()
 
         // Add to outgoing radiance Lo
         float NdotL = max(dot(N, L), 0.0);
+        Lo += (kD * Diffuse.rgb / PI + specular) * pointLightRadiance * NdotL;
+    }
 
-        // Add to Lo
-        Lo += (kD * Diffuse.rgb / PI + specular) * pointLightRadiance * NdotL; // Point light influence
-        Lo += dirLightRadiance;                                                // Dir light influence
+    // Directional lights
+    for (uint i = 0; i < dirLightCount; i++) {
+        Lo += dirLightColors[i].rgb * max(dot(N, -dirLightDirections[i].xyz), 0.0) * Diffuse.rgb;
     }
 
     // Irradiance (ambient light)
@@ -149,7 +191,7 @@ void main()
     vec2 brdf = texture(textures.brdfLut, vec2(max(dot(N, V), 0.0), Roughness)).rg;
     vec3 specular = prefilteredColor * (F * brdf.x + brdf.y);
 
-    vec3 ambient = (kD * diffuse + specular) * AO * lights.dirLightColors[0]; /* control amount of ambient color */
+    vec3 ambient = (kD * diffuse + specular) * AO * dirLightColors[0].rgb; /* control amount of ambient color */
 
     vec3 color = ambient + ((1.0 - directShadow) * Lo) + Emissive;
 
@@ -241,6 +283,11 @@ float DirectShadowCalculation(vec3 fragPosWorldSpace, vec3 normalizedNormal, flo
         return 0.0;
     }
 
+    // Outside the cascade region there is nothing to sample (the atlas has no border of its own)
+    if (any(lessThan(projCoords.xy, vec2(0.0))) || any(greaterThan(projCoords.xy, vec2(1.0)))) {
+        return 0.0;
+    }
+
     // Calculate bias (based on depth map resolution and slope)
     float bias = max(0.05 * (1.0 - dot(normalizedNormal, lightDir)), 0.005);
     const float biasModifier = 0.5;
@@ -254,9 +301,17 @@ float DirectShadowCalculation(vec3 fragPosWorldSpace, vec3 normalizedNormal, flo
     // PCF
     float shadow = 0.0;
     vec2 texelSize = 1.0 / vec2(textureSize(textures.shadowMap, 0));
+    vec4 atlasRect = cascadeAtlasRects[layer];
+    vec2 atlasCoords = atlasRect.xy + projCoords.xy * atlasRect.zw;
+
+    // Keep the samples inside the cascade region
+    vec2 minCoords = atlasRect.xy + 0.5 * texelSize;
+    vec2 maxCoords = atlasRect.xy + atlasRect.zw - 0.5 * texelSize;
+
     for (int x = -1; x <= 1; x++) {
         for (int y = -1; y <= 1; y++) {
-            float pcfDepth = texture(textures.shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, layer)).r;
+            vec2 sampleCoords = clamp(atlasCoords + vec2(x, y) * texelSize, minCoords, maxCoords);
+            float pcfDepth = texture(textures.shadowMap, sampleCoords).r;
             shadow += (currentDepth - bias) > pcfDepth ? 1.0 : 0.0;
         }
     }
@@ -0,0 +1,8 @@
+// Base pass: drops the 'transparent' pixels ('$' is replaced by the pass prefix)
+vec4 $apply(vec4 color, vec2 uv) {
+    if (color.a < 0.5) {
+        discard;
+    }
+
+    return color;
+}
@@ -7,37 +7,17 @@ in VS_OUT {
 } fs_in;
 
 uniform sampler2D screenTexture;
+uniform sampler2D bloomTexture; // Sum of the blurred levels: bright color and its coverage in the alpha
 
-uniform int samples;
-uniform float spread;
-uniform float threshold;
+uniform int levels;
 uniform float amount;
 
 void main() {
-
-    float value = 0.0;
-    float count = 0.0;
-
-    vec4 result = vec4(0.0);
     vec4 screenColor = texture(screenTexture, fs_in.TexCoords);
+    vec4 bloom = texture(bloomTexture, fs_in.TexCoords) / float(levels);
 
-    vec2 texSize = textureSize(screenTexture, 0).xy;
-
-    for (int i = -samples; i <= samples; i++) {
-        for (int j = -samples; j <= samples; j++) {
-            vec4 color = texture(screenTexture, (gl_FragCoord.xy + (vec2(i, j) * spread)) / texSize);
-
-            value = max(color.r, max(color.g, color.b));
-            if (value < threshold) {
-                color = screenColor;
-            }
-
-            result += color;
-            count += 1.0;
-        }
-    }
-
-    result /= count;
+    // Average of the neighbourhood where the dim neighbours count as the pixel itself
+    vec4 result = vec4(screenColor.rgb * (1.0 - bloom.a) + bloom.rgb, screenColor.a);
 
     fragColor = mix(screenColor, result, amount);
 }
@@ -0,0 +1,45 @@
+#version 460 core
+
+layout (location = 0) out vec4 fragColor;
+
+in VS_OUT {
+    vec2 TexCoords;
+} fs_in;
+
+uniform sampler2D screenTexture; // The level above (the screen for the first level)
+
+uniform bool prefilter; // First level: only keep the bright pixels
+uniform float threshold;
+
+// Bright part of a screen sample: the color when it is over the threshold and its coverage in the alpha
+vec4 Tap(vec2 uv) {
+    vec4 color = texture(screenTexture, uv);
+    if (!prefilter) {
+        return color;
+    }
+
+    float bright = step(threshold, max(color.r, max(color.g, color.b)));
+    return vec4(color.rgb * bright, bright);
+}
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(screenTexture, 0));
+    vec2 uv = fs_in.TexCoords;
+
+    // 13 taps weighted as five overlapping 2x2 boxes: the center one counts half, the four corner ones the rest
+    vec4 a = Tap(uv + texel * vec2(-2.0,  2.0));
+    vec4 b = Tap(uv + texel * vec2( 0.0,  2.0));
+    vec4 c = Tap(uv + texel * vec2( 2.0,  2.0));
+    vec4 d = Tap(uv + texel * vec2(-2.0,  0.0));
+    vec4 e = Tap(uv);
+    vec4 f = Tap(uv + texel * vec2( 2.0,  0.0));
+    vec4 g = Tap(uv + texel * vec2(-2.0, -2.0));
+    vec4 h = Tap(uv + texel * vec2( 0.0, -2.0));
+    vec4 i = Tap(uv + texel * vec2( 2.0, -2.0));
+    vec4 j = Tap(uv + texel * vec2(-1.0,  1.0));
+    vec4 k = Tap(uv + texel * vec2( 1.0,  1.0));
+    vec4 l = Tap(uv + texel * vec2(-1.0, -1.0));
+    vec4 m = Tap(uv + texel * vec2( 1.0, -1.0));
+
+    fragColor = e * 0.125 + (a + c + g + i) * 0.03125 + (b + d + f + h) * 0.0625 + (j + k + l + m) * 0.125;
+}
@@ -0,0 +1,28 @@
+#version 460 core
+
+layout (location = 0) out vec4 fragColor;
+
+in VS_OUT {
+    vec2 TexCoords;
+} fs_in;
+
+uniform sampler2D screenTexture; // The levels below, already added up
+uniform sampler2D levelTexture; // This level of the downsample chain
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(screenTexture, 0));
+    vec2 uv = fs_in.TexCoords;
+
+    // 3x3 tent filter over the smaller level
+    vec4 below = texture(screenTexture, uv) * 4.0;
+    below += texture(screenTexture, uv + texel * vec2(-1.0,  0.0)) * 2.0;
+    below += texture(screenTexture, uv + texel * vec2( 1.0,  0.0)) * 2.0;
+    below += texture(screenTexture, uv + texel * vec2( 0.0, -1.0)) * 2.0;
+    below += texture(screenTexture, uv + texel * vec2( 0.0,  1.0)) * 2.0;
+    below += texture(screenTexture, uv + texel * vec2(-1.0, -1.0));
+    below += texture(screenTexture, uv + texel * vec2( 1.0, -1.0));
+    below += texture(screenTexture, uv + texel * vec2(-1.0,  1.0));
+    below += texture(screenTexture, uv + texel * vec2( 1.0,  1.0));
+
+    fragColor = texture(levelTexture, uv) + below / 16.0;
+}
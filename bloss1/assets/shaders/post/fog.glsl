@@ -0,0 +1,23 @@
+// Fog pass ('$' is replaced by the pass prefix)
+uniform sampler2D $depthTexture; // Gbuffer depth texture, the position is rebuilt from it
+uniform vec3 $fogColor; // Color for fog calculation
+uniform vec2 $fogMinMax; // Range of the fog relative to the camera
+
+vec4 $apply(vec4 color, vec2 uv) {
+
+    // Rebuild the position from the gbuffer depth (only filled up to the render size)
+    float depth = texture($depthTexture, uv * viewport / vec2(textureSize($depthTexture, 0))).r;
+    if (depth >= 1.0) {
+        return color; // Nothing drawn, the skybox goes here
+    }
+
+    vec4 position = inverseViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    vec3 FragPos = position.xyz / position.w;
+
+    // Fog influence
+    float dist = length(FragPos - viewPos); // Fog increases as distance to camera increases
+    float fogFactor = ($fogMinMax.y - dist) / ($fogMinMax.y - $fogMinMax.x);
+    fogFactor = clamp(fogFactor, 0.0, 1.0);
+
+    return mix(vec4($fogColor, 1.0), color, fogFactor);
+}
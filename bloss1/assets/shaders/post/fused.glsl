@@ -0,0 +1,26 @@
+#version 460 core
+
+// Header of the generated post processing shaders. The per pixel passes are appended as '<prefix>apply'
+// functions and main applies them in order to the sampled input
+
+layout (location = 0) out vec4 fragColor;
+
+in VS_OUT {
+    vec2 TexCoords;
+} fs_in;
+
+uniform sampler2D screenTexture;
+
+// Camera and frame constants, written once per frame (must match FrameUniforms)
+layout (std140, binding = 1) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection;
+    vec3 viewPos; // Camera position
+    float near;
+    vec3 lightDir; // Light direction for shadow mapping
+    float far;
+    vec2 viewport;
+    float time;
+    float dt;
+};
@@ -7,101 +7,40 @@ in VS_OUT {
 } fs_in;
 
 uniform sampler2D screenTexture;
+uniform sampler2D leftTexture; // Half row means (see kuwahara_rows.fs)
+uniform sampler2D rightTexture;
 uniform int radius;
 
-void main() {
-    fragColor = texture(screenTexture, fs_in.TexCoords);
-    if (fragColor.a < 0.5) {
-        discard;
-    }
-
-    vec2 texSize  = textureSize(screenTexture, 0).xy;
+// Mean color and variance of the quadrant made of the half rows below (-1) or above (1) the pixel
+vec4 Quadrant(sampler2D rows, float direction) {
+    vec2 texel = 1.0 / vec2(textureSize(rows, 0));
 
-    vec2 src_size = vec2(1.0 / texSize.x, 1.0 / texSize.y);
-    vec2 uv = fs_in.TexCoords;
-    float n = float((radius + 1) * (radius + 1));
-    vec3 m0 = vec3(0.0); vec3 m1 = vec3(0.0); vec3 m2 = vec3(0.0); vec3 m3 = vec3(0.0);
-    vec3 s0 = vec3(0.0); vec3 s1 = vec3(0.0); vec3 s2 = vec3(0.0); vec3 s3 = vec3(0.0);
-    vec3 c;
-
-    for (int j = -radius; j <= 0; j++)
-    {
-        for (int i = -radius; i <= 0; i++)
-        {
-            c = texture(screenTexture, uv + vec2(i,j) * src_size).rgb;
-            m0 += c;
-            s0 += c * c;
-        }
+    vec4 sum = vec4(0.0);
+    for (int j = 0; j <= radius; j++) {
+        sum += texture(rows, fs_in.TexCoords + vec2(0.0, j * direction) * texel);
     }
 
-    for (int j = -radius; j <= 0; j++)
-    {
-        for (int i = 0; i <= radius; i++)
-        {
-            c = texture(screenTexture, uv + vec2(i,j) * src_size).rgb;
-            m1 += c;
-            s1 += c * c;
-        }
-    }
+    sum /= float(radius + 1);
+    return vec4(sum.rgb, max(sum.a - dot(sum.rgb, sum.rgb), 0.0));
+}
 
-    for (int j = 0; j <= radius; j++)
-    {
-        for (int i = 0; i <= radius; i++)
-        {
-            c = texture(screenTexture, uv + vec2(i,j) * src_size).rgb;
-            m2 += c;
-            s2 += c * c;
-        }
+void main() {
+    fragColor = texture(screenTexture, fs_in.TexCoords);
+    if (fragColor.a < 0.5) {
+        discard;
     }
 
-    for (int j = 0; j <= radius; j++)
-    {
-        for (int i = -radius; i <= 0; i++)
-        {
-            c = texture(screenTexture, uv + vec2(i,j) * src_size).rgb;
-            m3 += c;
-            s3 += c * c;
-        }
-    }
+    // The quadrants in the same order as the full kernel, the first with the lowest variance wins
+    vec4 quadrants[4] = vec4[4](Quadrant(leftTexture, -1.0),
+                                Quadrant(rightTexture, -1.0),
+                                Quadrant(rightTexture, 1.0),
+                                Quadrant(leftTexture, 1.0));
 
     float min_sigma2 = 1e+2;
-    m0 /= n;
-    s0 = abs(s0 / n - m0 * m0);
-
-    float sigma2 = s0.r + s0.g + s0.b;
-    if (sigma2 < min_sigma2)
-    {
-        min_sigma2 = sigma2;
-        fragColor = vec4(m0, 1.0);
-    }
-
-    m1 /= n;
-    s1 = abs(s1 / n - m1 * m1);
-
-    sigma2 = s1.r + s1.g + s1.b;
-    if (sigma2 < min_sigma2)
-    {
-        min_sigma2 = sigma2;
-        fragColor = vec4(m1, 1.0);
-    }
-
-    m2 /= n;
-    s2 = abs(s2 / n - m2 * m2);
-
-    sigma2 = s2.r + s2.g + s2.b;
-    if (sigma2 < min_sigma2)
-    {
-        min_sigma2 = sigma2;
-        fragColor = vec4(m2, 1.0);
-    }
-
-    m3 /= n;
-    s3 = abs(s3 / n - m3 * m3);
-
-    sigma2 = s3.r + s3.g + s3.b;
-    if (sigma2 < min_sigma2)
-    {
-        min_sigma2 = sigma2;
-        fragColor = vec4(m3, 1.0);
+    for (int i = 0; i < 4; i++) {
+        if (quadrants[i].a < min_sigma2) {
+            min_sigma2 = quadrants[i].a;
+            fragColor = vec4(quadrants[i].rgb, 1.0);
+        }
     }
 }
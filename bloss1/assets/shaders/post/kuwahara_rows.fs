@@ -0,0 +1,27 @@
+#version 460 core
+
+layout (location = 0) out vec4 fragColor;
+
+in VS_OUT {
+    vec2 TexCoords;
+} fs_in;
+
+uniform sampler2D screenTexture;
+uniform int radius;
+uniform float side; // -1: the left half of the row (x - radius to x), 1: the right half (x to x + radius)
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(screenTexture, 0));
+
+    vec3 mean = vec3(0.0);
+    float squared = 0.0;
+    for (int i = 0; i <= radius; i++) {
+        vec3 c = texture(screenTexture, fs_in.TexCoords + vec2(i * side, 0.0) * texel).rgb;
+        mean += c;
+        squared += dot(c, c);
+    }
+
+    // Mean color and mean squared length, the variance of the channels summed is squared - dot(mean, mean)
+    float n = float(radius + 1);
+    fragColor = vec4(mean / n, squared / n);
+}
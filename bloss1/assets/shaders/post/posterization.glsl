@@ -0,0 +1,18 @@
+// Posterization pass ('$' is replaced by the pass prefix)
+uniform float $levels;
+
+vec4 $apply(vec4 color, vec2 uv) {
+
+    float greyscale = max(color.r, max(color.g, color.b));
+
+    float lower = floor(greyscale * $levels) / $levels;
+    float lowerDiff = abs(greyscale - lower);
+
+    float upper = ceil(greyscale * $levels) / $levels;
+    float upperDiff = abs(upper - greyscale);
+
+    float level = lowerDiff <= upperDiff ? lower : upper;
+    float adjustment = level / greyscale;
+
+    return vec4(color.rgb * adjustment, color.a);
+}
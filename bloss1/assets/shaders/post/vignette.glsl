@@ -0,0 +1,11 @@
+// Vignette pass ('$' is replaced by the pass prefix)
+uniform float $lens_radius;
+uniform float $lens_feathering;
+
+vec4 $apply(vec4 color, vec2 uv) {
+    float dist = distance(uv, vec2(0.5, 0.5));
+    vec3 vig = vec3(smoothstep($lens_radius, ($lens_radius - 0.001) * $lens_feathering, dist));
+    color.xyz *= vig;
+
+    return color;
+}
@@ -4,13 +4,28 @@ layout (location = 0) in vec3 position;
 layout (location = 5) in ivec4 boneIDs;
 layout (location = 6) in vec4 weights;
 
-uniform mat4 model;
+// Per instance index of the draw, selects the model matrix
+layout (location = 7) in int drawIndex;
+
+layout (std430, binding = 2) readonly buffer DrawData
+{
+    mat4 modelMatrices[];
+};
+
+layout (std140, binding = 0) uniform LightSpaceMatrices
+{
+    mat4 lightSpaceMatrices[16];
+};
+
+// Cascade (array layer) being rendered
+uniform int cascade;
 
 const int MAX_BONES = 100;
 const int MAX_BONE_PER_VERTEX = 4;
 uniform mat4 finalBonesMatrices[MAX_BONES];
 
 void main() {
+    mat4 model = modelMatrices[drawIndex];
 
     // Bone influence
     vec4 positionAfterWeights = vec4(0.0);
@@ -31,5 +46,5 @@ void main() {
         positionAfterWeights = vec4(position, 1.0);
     }
 
-    gl_Position = model * positionAfterWeights;
+    gl_Position = lightSpaceMatrices[cascade] * model * positionAfterWeights;
 }
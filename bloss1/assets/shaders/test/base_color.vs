@@ -2,8 +2,20 @@
 
 layout(location = 0) in vec3 position;
 
-uniform mat4 projection;
-uniform mat4 view;
+// Camera and frame constants, written once per frame (must match FrameUniforms)
+layout (std140, binding = 1) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection;
+    vec3 viewPos; // Camera position
+    float near;
+    vec3 lightDir; // Light direction for shadow mapping
+    float far;
+    vec2 viewport;
+    float time;
+    float dt;
+};
+
 uniform mat4 model;
 
 void main() {
@@ -4,10 +4,10 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
-uniform sampler2DArray depthMap;
+uniform sampler2D depthMap;
 uniform float near;
 uniform float far;
-uniform int layer;
+uniform vec4 atlasRect; // Region of the atlas to show (offset and scale)
 
 // required when using a perspective projection matrix
 float LinearizeDepth(float depth) {
@@ -16,7 +16,7 @@ float LinearizeDepth(float depth) {
 }
 
 void main() {
-    float depthValue = texture(depthMap, vec3(TexCoords, layer)).r;
+    float depthValue = texture(depthMap, atlasRect.xy + TexCoords * atlasRect.zw).r;
     // FragColor = vec4(vec3(LinearizeDepth(depthValue) / far), 1.0); // perspective
     FragColor = vec4(vec3(depthValue), 1.0); // orthographic
 }
@@ -5,12 +5,32 @@
 namespace bls
 {
     u32 AppStats::vertices = 0;
+    u32 AppStats::draw_calls = 0;
+    u32 AppStats::binds_avoided = 0;
+    u32 AppStats::meshes_visible = 0;
+    u32 AppStats::meshes_culled = 0;
+    u32 AppStats::animations_updated = 0;
+    u32 AppStats::animations_skipped = 0;
     f32 AppStats::framerate = 0.0f;
     f32 AppStats::ms_per_frame = 0.0f;
+    f32 AppStats::sim_ms = 0.0f;
+    f32 AppStats::render_ms = 0.0f;
+    f32 AppStats::submit_wait_ms = 0.0f;
+    f32 AppStats::frame_latency_ms = 0.0f;
+    f32 AppStats::frame_interval_ms = 0.0f;
+    f32 AppStats::frame_jitter_ms = 0.0f;
+    u64 AppStats::render_target_bytes = 0;
+    u64 AppStats::render_target_unaliased_bytes = 0;
+    f32 AppStats::gpu_ms = 0.0f;
+    f32 AppStats::resolution_scale = 1.0f;
     std::vector<Log> AppStats::log_messages = {};
+    RenderStats AppStats::render_stats = {};
 
     std::vector<PassConfig> AppConfig::render_passes = {};
     SkyboxConfig AppConfig::skybox_config = {1024, 32, 1024, 1024, 10};
+    AnimationLodConfig AppConfig::animation_lod_config = {true, 50.0f, 150.0f, 2, 4};
+    ShadowConfig AppConfig::shadow_config = {true, {1, 1, 1, 2, 4}, {4096, 2048, 2048, 1024, 1024}, 16};
+    DynamicResolutionConfig AppConfig::dynamic_resolution_config = {true, 16.6f, 0.5f, 1.0f, 0.05f, 30};
     bool AppConfig::render_colliders = true;
     bool AppConfig::tess_wireframe = false;
 };  // namespace bls
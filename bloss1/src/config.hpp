@@ -28,22 +28,86 @@ namespace bls
             u32 max_mip_levels;
     };
 
+    struct AnimationLodConfig
+    {
+            bool enabled;
+            f32 full_rate_distance;     // Closer than this: update every frame
+            f32 reduced_rate_distance;  // Closer than this: update every 'reduced_rate_interval' frames
+            u32 reduced_rate_interval;
+            u32 far_rate_interval;  // Anything further (but visible) updates every 'far_rate_interval' frames
+    };
+
+    struct ShadowConfig
+    {
+            bool cache_static_casters;                  // Static casters are rendered once into a cached layer
+            std::vector<u32> cascade_update_intervals;  // Each cascade is rendered every 'interval' frames
+            std::vector<u32> cascade_resolutions;       // Size of each cascade region in the atlas
+            u32 depth_bits;                             // 16, 24 or 32 (float)
+    };
+
+    struct DynamicResolutionConfig
+    {
+            bool enabled;
+            f32 target_ms;             // Frame time budget
+            f32 min_scale, max_scale;  // Bounds of the internal resolution, relative to the window
+            f32 scale_step;            // The scale moves in steps, so the targets are not resized every frame
+            u32 cooldown_frames;       // Frames between two changes
+    };
+
     class AppConfig
     {
         public:
             static std::vector<PassConfig> render_passes;
             static SkyboxConfig skybox_config;
+            static AnimationLodConfig animation_lod_config;
+            static ShadowConfig shadow_config;
+            static DynamicResolutionConfig dynamic_resolution_config;
             static bool render_colliders;
             static bool tess_wireframe;
     };
 
+    // Stats of the frame packets being drawn. Only the thread that draws writes them, RenderThread copies them to
+    // AppStats on submit, while no frame is in flight
+    struct RenderStats
+    {
+            u32 vertices, draw_calls, binds_avoided, meshes_visible, meshes_culled;
+            f32 render_ms, gpu_ms;
+            f32 frame_latency_ms, frame_interval_ms, frame_jitter_ms;
+            u64 render_target_bytes, render_target_unaliased_bytes;
+    };
+
     struct Log;
     class AppStats
     {
         public:
             static u32 vertices;
+            static u32 draw_calls;
+            static u32 binds_avoided;
+            static u32 meshes_visible;
+            static u32 meshes_culled;
+            static u32 animations_updated;
+            static u32 animations_skipped;
             static f32 framerate;
             static f32 ms_per_frame;
+
+            // Frame pacing, smoothed over the last frames (see RenderThread)
+            static f32 sim_ms;             // Main thread work per frame
+            static f32 render_ms;          // Time spent drawing a frame packet
+            static f32 submit_wait_ms;     // Main thread blocked on the frame in flight
+            static f32 frame_latency_ms;   // From the start of a frame to its present
+            static f32 frame_interval_ms;  // Between two presents
+            static f32 frame_jitter_ms;    // Deviation of the interval from its average
+
+            // Render targets of the frame graph: aliased (what is allocated) and if every target was its own
+            static u64 render_target_bytes;
+            static u64 render_target_unaliased_bytes;
+
+            // Dynamic resolution: GPU time of the frame graph (0 when it can not be measured) and the current scale
+            static f32 gpu_ms;
+            static f32 resolution_scale;
             static std::vector<Log> log_messages;
+
+            // Written by the drawing thread only, the fields above are the copies the main thread reads
+            static RenderStats render_stats;
     };
 };  // namespace bls
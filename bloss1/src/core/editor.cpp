@@ -10,6 +10,7 @@
 #include "renderer/height_map.hpp"
 #include "renderer/model.hpp"
 #include "renderer/post/post_processing.hpp"
+#include "renderer/shadow_map.hpp"
 #include "renderer/skybox.hpp"
 
 namespace bls
@@ -182,12 +183,32 @@ namespace bls
                                  ImVec2(0, 60.0f));
         }
 
+        ImGui::Text("Draw calls: %u (%u redundant binds avoided)", AppStats::draw_calls, AppStats::binds_avoided);
+        ImGui::Text("Meshes (all passes): %u visible, %u culled", AppStats::meshes_visible, AppStats::meshes_culled);
+        ImGui::Text("Animations: %u updated, %u skipped", AppStats::animations_updated, AppStats::animations_skipped);
+
+        ImGui::Separator();
+        ImGui::Text("Simulation: %.3f ms, render: %.3f ms", AppStats::sim_ms, AppStats::render_ms);
+        ImGui::Text("Submit wait: %.3f ms", AppStats::submit_wait_ms);
+        ImGui::Text("Latency: %.3f ms", AppStats::frame_latency_ms);
+        ImGui::Text("Present interval: %.3f ms (jitter %.3f ms)",
+                    AppStats::frame_interval_ms,
+                    AppStats::frame_jitter_ms);
+
+        ImGui::Separator();
+        ImGui::Text("GPU: %.3f ms", AppStats::gpu_ms);
+        ImGui::Text("Resolution scale: %.2f", AppStats::resolution_scale);
+        ImGui::Text("Render targets: %.1f MB (%.1f MB without aliasing)",
+                    AppStats::render_target_bytes / (1024.0f * 1024.0f),
+                    AppStats::render_target_unaliased_bytes / (1024.0f * 1024.0f));
+
         ImGui::End();
 
-        // Reset stats
+        // Reset stats (the render stats are per frame already, see RenderThread)
         AppStats::framerate = {};
         AppStats::ms_per_frame = {};
-        AppStats::vertices = {};
+        AppStats::animations_updated = {};
+        AppStats::animations_skipped = {};
     }
 
     void Editor::render_config()
@@ -207,6 +228,94 @@ namespace bls
             ImGui::Dummy(ImVec2(10.0f, 10.0f));
         }
 
+        if (ImGui::CollapsingHeader("Animation"))
+        {
+            auto &lod_config = AppConfig::animation_lod_config;
+
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+            ImGui::Text("Animation LOD");
+            ImGui::Separator();
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+            ImGui::Checkbox("Enabled", &lod_config.enabled);
+            ImGui::InputFloat("Full Rate Distance", &lod_config.full_rate_distance);
+            ImGui::InputFloat("Reduced Rate Distance", &lod_config.reduced_rate_distance);
+            if (ImGui::InputInt("Reduced Rate Interval", reinterpret_cast<i32 *>(&lod_config.reduced_rate_interval)))
+                lod_config.reduced_rate_interval =
+                    static_cast<u32>(max(static_cast<i32>(lod_config.reduced_rate_interval), 1));
+
+            if (ImGui::InputInt("Far Rate Interval", reinterpret_cast<i32 *>(&lod_config.far_rate_interval)))
+                lod_config.far_rate_interval = static_cast<u32>(max(static_cast<i32>(lod_config.far_rate_interval), 1));
+
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+        }
+
+        if (ImGui::CollapsingHeader("Shadows"))
+        {
+            auto &shadow_config = AppConfig::shadow_config;
+
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+            ImGui::Text("Shadow Options");
+            ImGui::Separator();
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+            ImGui::Checkbox("Cache Static Casters", &shadow_config.cache_static_casters);
+
+            auto &intervals = shadow_config.cascade_update_intervals;
+            for (u32 i = 0; i < intervals.size(); i++)
+            {
+                const str label = "Cascade " + to_str(i) + " Update Interval";
+                if (ImGui::InputInt(label.c_str(), reinterpret_cast<i32 *>(&intervals[i])))
+                    intervals[i] = static_cast<u32>(max(static_cast<i32>(intervals[i]), 1));
+            }
+
+            // Atlas layout and format (only applied on request since the atlas is recreated)
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+
+            const i32 max_resolution = static_cast<i32>(ShadowMap::get_max_atlas_size());
+            auto &resolutions = shadow_config.cascade_resolutions;
+            for (u32 i = 0; i < resolutions.size(); i++)
+            {
+                const str label = "Cascade " + to_str(i) + " Resolution";
+                if (ImGui::InputInt(label.c_str(), reinterpret_cast<i32 *>(&resolutions[i])))
+                    resolutions[i] = static_cast<u32>(clamp(static_cast<i32>(resolutions[i]), 1, max_resolution));
+            }
+
+            ImGui::InputInt("Depth Bits (16, 24, 32)", reinterpret_cast<i32 *>(&shadow_config.depth_bits));
+
+            auto &shadow_map = renderer.get_shadow_map();
+            if (shadow_map)
+            {
+                if (ImGui::SmallButton("Apply")) shadow_map->apply_config();
+
+                ImGui::Text("Atlas: %ux%u, %.1f MB",
+                            shadow_map->get_atlas_width(),
+                            shadow_map->get_atlas_height(),
+                            shadow_map->get_memory_usage() / (1024.0f * 1024.0f));
+            }
+
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+        }
+
+        if (ImGui::CollapsingHeader("Dynamic Resolution"))
+        {
+            auto &resolution_config = AppConfig::dynamic_resolution_config;
+
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+            ImGui::Text("Dynamic Resolution Options");
+            ImGui::Separator();
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+            ImGui::Checkbox("Enabled##resolution", &resolution_config.enabled);
+            ImGui::InputFloat("Frame Budget (ms)", &resolution_config.target_ms);
+            ImGui::InputFloat("Min Scale", &resolution_config.min_scale);
+            ImGui::InputFloat("Max Scale", &resolution_config.max_scale);
+            ImGui::InputFloat("Scale Step", &resolution_config.scale_step);
+            ImGui::InputInt("Cooldown Frames", reinterpret_cast<i32 *>(&resolution_config.cooldown_frames));
+
+            resolution_config.min_scale = glm::clamp(resolution_config.min_scale, 0.25f, 1.0f);
+            resolution_config.max_scale = glm::clamp(resolution_config.max_scale, resolution_config.min_scale, 1.0f);
+            resolution_config.scale_step = max(resolution_config.scale_step, 0.01f);
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+        }
+
         if (ImGui::CollapsingHeader("Skybox"))
         {
             ImGui::Dummy(ImVec2(10.0f, 10.0f));
@@ -253,10 +362,12 @@ namespace bls
             ImGui::Dummy(ImVec2(10.0f, 10.0f));
             ImGui::InputInt("Min tesselation level", reinterpret_cast<i32 *>(&height_map->min_tess_level));
             ImGui::InputInt("Max tesselation level", reinterpret_cast<i32 *>(&height_map->max_tess_level));
-            ImGui::InputFloat("Min distance", &height_map->min_distance);
-            ImGui::InputFloat("Max distance", &height_map->max_distance);
+            ImGui::InputFloat("Pixels per edge", &height_map->pixels_per_edge);
             ImGui::InputFloat2("Displacement Multiplier", value_ptr(height_map->displacement_multiplier));
             ImGui::InputInt("Noise Algorithm", reinterpret_cast<i32 *>(&height_map->noise_algorithm));
+            ImGui::Text("Patches: %u visible, %u nodes culled",
+                        height_map->get_visible_patches(),
+                        height_map->get_culled_nodes());
             ImGui::Dummy(ImVec2(10.0f, 10.0f));
 
             ImGui::Text("Layers");
@@ -343,6 +454,10 @@ namespace bls
                 if (pass.id > 0) post_processing->set_pass(pass.id, pass.enabled, pass.position);
             }
             ImGui::EndTable();
+
+            // Consecutive per pixel passes are fused in a single draw
+            ImGui::Dummy(ImVec2(10.0f, 10.0f));
+            ImGui::Text("Full screen draws: %u", post_processing->get_chain_size());
         }
         ImGui::End();
     }
@@ -576,7 +691,8 @@ namespace bls
 
             if (ecs.transform_animations.count(id))
             {
-                auto &key_frames = ecs.transform_animations[id]->key_frames;
+                auto &animation = ecs.transform_animations[id];
+                auto &key_frames = animation->key_frames;
 
                 ImGui::Text("transform_animation");
                 ImGui::Separator();
@@ -585,10 +701,13 @@ namespace bls
                     auto &key_frame = key_frames[i];
 
                     ImGui::Text("%s", ("frame: " + to_str(i)).c_str());
-                    ImGui::InputFloat3(("position_" + to_str(i)).c_str(), value_ptr(key_frame.transform.position));
-                    ImGui::InputFloat3(("rotation_" + to_str(i)).c_str(), value_ptr(key_frame.transform.rotation));
-                    ImGui::InputFloat3(("scale_" + to_str(i)).c_str(), value_ptr(key_frame.transform.scale));
-                    ImGui::InputFloat(("duration_" + to_str(i)).c_str(), &key_frame.duration);
+                    animation->dirty |= ImGui::InputFloat3(("position_" + to_str(i)).c_str(),
+                                                           value_ptr(key_frame.transform.position));
+                    animation->dirty |= ImGui::InputFloat3(("rotation_" + to_str(i)).c_str(),
+                                                           value_ptr(key_frame.transform.rotation));
+                    animation->dirty |= ImGui::InputFloat3(("scale_" + to_str(i)).c_str(),
+                                                           value_ptr(key_frame.transform.scale));
+                    animation->dirty |= ImGui::InputFloat(("duration_" + to_str(i)).c_str(), &key_frame.duration);
                     ImGui::Dummy(ImVec2(5.0f, 5.0f));
                 }
 
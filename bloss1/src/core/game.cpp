@@ -1,6 +1,8 @@
 #include "core/game.hpp"
 
 #include "core/logger.hpp"
+#include "core/render_thread.hpp"
+#include "ecs/systems/render_system.hpp"
 #include "stages/menu_stage.hpp"
 #include "stages/test_stage.hpp"
 #include "tools/profiler.hpp"
@@ -15,6 +17,7 @@ namespace bls
         if (instance != nullptr) throw std::runtime_error("there can be only one instance of game");
 
         instance = this;
+        max_frames = 0;
 
         // Create the window
         window = std::unique_ptr<Window>(Window::create(title, width, height));
@@ -24,9 +27,9 @@ namespace bls
         renderer = std::unique_ptr<Renderer>(Renderer::create());
         renderer->initialize();
 
-// Create the editor
+// Create the editor (it draws with OpenGL, so headless runs go without it)
 #if !defined(_RELEASE)
-        editor = std::make_unique<Editor>(*window.get());
+        if (Renderer::get_backend() != RendererBackend::Null) editor = std::make_unique<Editor>(*window.get());
 #endif
 
         // Create the audio engine
@@ -44,6 +47,15 @@ namespace bls
 
     Game::~Game()
     {
+        // The resources are destroyed with the context back in this thread
+        if (RenderThread::get().is_running())
+        {
+            RenderThread::get().stop();
+            window->set_context_current(true);
+        }
+
+        // Before the window takes the context with it
+        release_render_resources();
     }
 
     void Game::run()
@@ -62,14 +74,25 @@ namespace bls
 
         window_open = true;
         minimized = false;
+        u64 frame_count = 0;
+
+        auto &render_thread = RenderThread::get();
 
         // The game loop
         while (stage && window_open)
         {
+            // Stop after the requested number of frames (benchmarks)
+            if (max_frames > 0 && frame_count++ >= max_frames) break;
+
             // Don't render if the application is minimized
             if (minimized)
             {
-                window->update();
+                if (render_thread.is_running())
+                    window->poll_events();
+
+                else
+                    window->update();
+
                 continue;
             }
 
@@ -78,6 +101,9 @@ namespace bls
             dt = clamp(static_cast<f32>(current_time - last_time), 0.0f, 0.1f);
             last_time = current_time;
 
+            // The render systems fill the frame packet
+            render_thread.begin_frame();
+
             // Update running stage
             stage->update(dt);
 
@@ -85,11 +111,18 @@ namespace bls
 
                 // Update editor
 #if !defined(_RELEASE)
-            if (stage->ecs != nullptr) editor->update(*stage->ecs, dt);
+            if (editor && stage->ecs != nullptr) editor->update(*stage->ecs, dt);
 #endif
 
-            // Update window
-            window->update();
+            // Update window. The render thread presents its frames, only the events are left here
+            if (render_thread.is_running())
+                window->poll_events();
+
+            else
+            {
+                window->update();
+                render_thread.frame_presented();
+            }
 
             // Sleep to match target spf
             f64 elapsed = window->get_time() - last_time;
@@ -101,6 +134,9 @@ namespace bls
 
     void Game::change_stage(Stage *new_stage)
     {
+        // Stages create and destroy resources
+        RenderContextScope context;
+
         stage.reset();
         if (new_stage)
         {
@@ -166,6 +202,34 @@ namespace bls
         return *stage;
     }
 
+    void Game::set_max_frames(u32 frames)
+    {
+        max_frames = frames;
+    }
+
+    void Game::set_render_thread(bool enabled)
+    {
+        auto &render_thread = RenderThread::get();
+        if (enabled == render_thread.is_running()) return;
+
+        if (!enabled)
+        {
+            render_thread.stop();
+            window->set_context_current(true);
+            return;
+        }
+
+        // The editor draws with the context in this thread
+        if (editor)
+        {
+            LOG_WARNING("the render thread is not available with the editor");
+            return;
+        }
+
+        window->set_context_current(false);
+        render_thread.start(*window);
+    }
+
     void Game::set_target_fps(u32 fps)
     {
         fps = (fps == 0) ? 100'000 : fps;
@@ -36,6 +36,8 @@ namespace bls
             Stage &get_curr_stage();
 
             void set_target_fps(u32 fps);
+            void set_max_frames(u32 frames);  // 0 runs until the window is closed
+            void set_render_thread(bool enabled);  // Draw the frames one frame behind on a dedicated thread
 
         private:
             void on_window_close(const WindowCloseEvent &event);
@@ -53,6 +55,7 @@ namespace bls
             std::unique_ptr<Stage> stage;
 
             f64 target_spf;
+            u32 max_frames;
             f64 last_time, current_time, dt;
             bool window_open, minimized;
     };
@@ -13,6 +13,10 @@ namespace bls
     class Input
     {
         public:
+            virtual ~Input()
+            {
+            }
+
             static bool is_key_pressed(i32 keycode)
             {
                 return instance->is_key_pressed_native(keycode);
@@ -48,6 +52,13 @@ namespace bls
                 return instance->get_mouse_y_native();
             }
 
+            // Replace the platform input (e.g. a headless run has no devices)
+            static void set_instance(Input *input)
+            {
+                delete instance;
+                instance = input;
+            }
+
         protected:
             virtual bool is_key_pressed_native(i32 keycode) = 0;
             virtual bool is_mouse_button_pressed_native(i32 button) = 0;
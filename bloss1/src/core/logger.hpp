@@ -60,6 +60,9 @@ namespace bls
                         break;
                 }
 
+                // The render thread logs too ('localtime' is not thread safe either)
+                std::lock_guard lock(get_mutex());
+
                 auto current_time = std::chrono::system_clock::now();
                 std::time_t current_time_t = std::chrono::system_clock::to_time_t(current_time);
                 std::tm* current_time_tm = std::localtime(&current_time_t);
@@ -78,6 +81,13 @@ namespace bls
 
                 AppStats::log_messages.push_back({buf.c_str(), log_type, color, timestamp});
             }
+
+        private:
+            static std::mutex& get_mutex()
+            {
+                static std::mutex mutex;
+                return mutex;
+            }
     };
 
 #if !defined(_RELEASE)
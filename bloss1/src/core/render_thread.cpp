@@ -0,0 +1,265 @@
+#include "core/render_thread.hpp"
+
+#include "config.hpp"
+#include "tools/profiler.hpp"
+
+#define RENDER_THREAD_SMOOTHING 0.1f  // Weight of the newest sample in the pacing averages
+
+namespace bls
+{
+    // Set in the thread that currently has the rendering context (while the render thread is running)
+    thread_local bool has_context = false;
+
+    f32 elapsed_ms(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+    {
+        return std::chrono::duration<f32, std::milli>(end - begin).count();
+    }
+
+    void smooth(f32 &average, f32 sample)
+    {
+        average += (sample - average) * RENDER_THREAD_SMOOTHING;
+    }
+
+    RenderThread::RenderThread()
+    {
+        window = nullptr;
+        write_index = 0;
+        running = false;
+        pending = context_requested = context_lent = false;
+        presented_once = false;
+    }
+
+    RenderThread::~RenderThread()
+    {
+        stop();
+    }
+
+    void RenderThread::start(Window &window)
+    {
+        if (running) return;
+
+        this->window = &window;
+        running = true;
+        thread = std::thread(&RenderThread::thread_loop, this);
+    }
+
+    void RenderThread::stop()
+    {
+        if (!running) return;
+
+        // The packet in flight is still drawn
+        {
+            std::lock_guard lock(mutex);
+            running = false;
+        }
+
+        wake.notify_all();
+        thread.join();
+
+        // The stats of the last frame
+        publish_stats();
+    }
+
+    bool RenderThread::is_running() const
+    {
+        return running;
+    }
+
+    void RenderThread::begin_frame()
+    {
+        auto &packet = packets[write_index];
+        packet.clear();
+        packet.frame_start = Clock::now();
+    }
+
+    FramePacket &RenderThread::get_packet()
+    {
+        return packets[write_index];
+    }
+
+    void RenderThread::submit(RenderFunction render)
+    {
+        auto &packet = packets[write_index];
+        packet.render = render;
+
+        const auto submit_time = Clock::now();
+        smooth(AppStats::sim_ms, elapsed_ms(packet.frame_start, submit_time));
+
+        if (!running)
+        {
+            draw(packet);
+            drawn_frame_start = packet.frame_start;
+            smooth(AppStats::render_stats.render_ms, elapsed_ms(submit_time, Clock::now()));
+
+            publish_stats();
+            return;
+        }
+
+        // The other packet is free once the frame before is drawn
+        std::unique_lock lock(mutex);
+        done.wait(lock, [this] { return !pending; });
+
+        smooth(AppStats::submit_wait_ms, elapsed_ms(submit_time, Clock::now()));
+
+        // Nothing is drawn until the packets are swapped, so the render stats can be read
+        publish_stats();
+
+        write_index = 1 - write_index;
+        pending = true;
+        lock.unlock();
+
+        wake.notify_one();
+    }
+
+    void RenderThread::frame_presented()
+    {
+        record_present();
+    }
+
+    void RenderThread::acquire_context()
+    {
+        {
+            std::unique_lock lock(mutex);
+            context_requested = true;
+            wake.notify_one();
+            done.wait(lock, [this] { return context_lent; });
+        }
+
+        window->set_context_current(true);
+        has_context = true;
+    }
+
+    void RenderThread::release_context()
+    {
+        window->set_context_current(false);
+        has_context = false;
+
+        {
+            std::lock_guard lock(mutex);
+            context_requested = false;
+        }
+
+        wake.notify_one();
+    }
+
+    RenderThread &RenderThread::get()
+    {
+        static RenderThread instance;
+        return instance;
+    }
+
+    void RenderThread::thread_loop()
+    {
+        window->set_context_current(true);
+        has_context = true;
+
+        std::unique_lock lock(mutex);
+        while (true)
+        {
+            wake.wait(lock, [this] { return pending || context_requested || !running; });
+
+            // Draw the frame in flight first, a context request waits for it
+            if (pending)
+            {
+                const auto &packet = packets[1 - write_index];
+                lock.unlock();
+
+                const auto render_start = Clock::now();
+                draw(packet);
+
+                window->swap_buffers();
+                smooth(AppStats::render_stats.render_ms, elapsed_ms(render_start, Clock::now()));
+
+                drawn_frame_start = packet.frame_start;
+                record_present();
+
+                lock.lock();
+                pending = false;
+                done.notify_all();
+            }
+
+            // Lend the context until it is given back
+            else if (context_requested)
+            {
+                window->set_context_current(false);
+                has_context = false;
+
+                context_lent = true;
+                done.notify_all();
+                wake.wait(lock, [this] { return !context_requested; });
+                context_lent = false;
+
+                window->set_context_current(true);
+                has_context = true;
+            }
+
+            else
+                break;
+        }
+
+        // The main thread takes the context back
+        window->set_context_current(false);
+        has_context = false;
+    }
+
+    void RenderThread::draw(const FramePacket &packet)
+    {
+        BLS_PROFILE_SCOPE("render_frame");
+
+        // The counters are per frame
+        auto &stats = AppStats::render_stats;
+        stats.vertices = stats.draw_calls = stats.binds_avoided = 0;
+        stats.meshes_visible = stats.meshes_culled = 0;
+
+        packet.render(packet);
+    }
+
+    void RenderThread::record_present()
+    {
+        const auto now = Clock::now();
+        auto &stats = AppStats::render_stats;
+
+        smooth(stats.frame_latency_ms, elapsed_ms(drawn_frame_start, now));
+
+        if (presented_once)
+        {
+            const f32 interval = elapsed_ms(last_present, now);
+            smooth(stats.frame_interval_ms, interval);
+            smooth(stats.frame_jitter_ms, std::abs(interval - stats.frame_interval_ms));
+        }
+
+        last_present = now;
+        presented_once = true;
+    }
+
+    void RenderThread::publish_stats()
+    {
+        const auto &stats = AppStats::render_stats;
+
+        AppStats::vertices = stats.vertices;
+        AppStats::draw_calls = stats.draw_calls;
+        AppStats::binds_avoided = stats.binds_avoided;
+        AppStats::meshes_visible = stats.meshes_visible;
+        AppStats::meshes_culled = stats.meshes_culled;
+        AppStats::render_ms = stats.render_ms;
+        AppStats::gpu_ms = stats.gpu_ms;
+        AppStats::frame_latency_ms = stats.frame_latency_ms;
+        AppStats::frame_interval_ms = stats.frame_interval_ms;
+        AppStats::frame_jitter_ms = stats.frame_jitter_ms;
+        AppStats::render_target_bytes = stats.render_target_bytes;
+        AppStats::render_target_unaliased_bytes = stats.render_target_unaliased_bytes;
+    }
+
+    RenderContextScope::RenderContextScope()
+    {
+        auto &render_thread = RenderThread::get();
+
+        acquired = render_thread.is_running() && !has_context;
+        if (acquired) render_thread.acquire_context();
+    }
+
+    RenderContextScope::~RenderContextScope()
+    {
+        if (acquired) RenderThread::get().release_context();
+    }
+};  // namespace bls
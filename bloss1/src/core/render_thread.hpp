@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * @brief Renders the frame packets. While running, the thread owns the rendering context and draws (and presents)
+ * the packet of frame N while the main thread simulates frame N + 1. The packets are double buffered: submitting
+ * only waits when the previous frame is still being drawn. When not running, packets are drawn on submit.
+ */
+
+#include "core/core.hpp"
+#include "core/window.hpp"
+#include "renderer/frame_packet.hpp"
+
+namespace bls
+{
+    class RenderThread
+    {
+        public:
+            // The window context must not be current in the calling thread
+            void start(Window &window);
+            void stop();
+            bool is_running() const;
+
+            // Clear the packet of the new frame and mark its start (latency is measured from here)
+            void begin_frame();
+            FramePacket &get_packet();
+
+            // Draw the packet with 'render', on the render thread when running
+            void submit(RenderFunction render);
+
+            // Called after the main thread presented a frame drawn on submit
+            void frame_presented();
+
+            // Borrow the rendering context (e.g. to create resources). Waits until the render thread is idle
+            void acquire_context();
+            void release_context();
+
+            static RenderThread &get();
+
+        private:
+            RenderThread();
+            ~RenderThread();
+
+            void thread_loop();
+            void draw(const FramePacket &packet);
+            void record_present();
+
+            // Copy the stats of the drawn frames to AppStats. Only while no frame is drawn
+            void publish_stats();
+
+            using Clock = std::chrono::steady_clock;
+
+            Window *window;
+            FramePacket packets[2];
+            u32 write_index;  // Packet filled by the main thread, the other one is drawn
+
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable wake, done;
+            std::atomic<bool> running;  // Also read by RenderContextScope on the render thread
+            bool pending, context_requested, context_lent;
+
+            // Pacing
+            Clock::time_point last_present, drawn_frame_start;
+            bool presented_once;
+    };
+
+    // Makes the rendering context current in the calling thread for the scope lifetime. Does nothing when the
+    // context is already current: the render thread is not running or this is the render thread
+    class RenderContextScope
+    {
+        public:
+            RenderContextScope();
+            ~RenderContextScope();
+
+        private:
+            bool acquired;
+    };
+};  // namespace bls
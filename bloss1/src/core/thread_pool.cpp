@@ -0,0 +1,116 @@
+#include "core/thread_pool.hpp"
+
+namespace bls
+{
+    ThreadPool::ThreadPool()
+    {
+        running = true;
+
+        // The caller thread also works, so leave one core for it
+        const u32 cores = std::thread::hardware_concurrency();
+        const u32 worker_count = cores > 1 ? cores - 1 : 0;
+
+        for (u32 i = 0; i < worker_count; i++) workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(mutex);
+            running = false;
+        }
+
+        job_available.notify_all();
+        for (auto &worker : workers) worker.join();
+    }
+
+    void ThreadPool::parallel_for(u32 count, u32 batch_size, const std::function<void(u32 begin, u32 end)> &func)
+    {
+        if (count == 0) return;
+
+        batch_size = std::max(batch_size, 1U);
+        const u32 batches = (count + batch_size - 1) / batch_size;
+
+        // Not worth waking anyone up
+        if (batches == 1 || workers.empty())
+        {
+            func(0, count);
+            return;
+        }
+
+        std::atomic<u32> remaining = batches - 1;
+        {
+            std::lock_guard lock(mutex);
+            for (u32 i = 1; i < batches; i++)
+            {
+                const u32 begin = i * batch_size;
+                const u32 end = std::min(begin + batch_size, count);
+
+                jobs.push(
+                    [this, &func, &remaining, begin, end]()
+                    {
+                        func(begin, end);
+                        if (--remaining == 0)
+                        {
+                            std::lock_guard lock(mutex);
+                            jobs_done.notify_all();
+                        }
+                    });
+            }
+        }
+
+        job_available.notify_all();
+
+        // First batch runs on the caller thread
+        func(0, batch_size);
+
+        // Help with the remaining jobs until every batch is done
+        while (remaining > 0)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(mutex);
+                if (jobs.empty())
+                {
+                    jobs_done.wait(lock, [&remaining] { return remaining == 0; });
+                    break;
+                }
+
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+
+            job();
+        }
+    }
+
+    u32 ThreadPool::get_worker_count()
+    {
+        return static_cast<u32>(workers.size());
+    }
+
+    void ThreadPool::worker_loop()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(mutex);
+                job_available.wait(lock, [this] { return !running || !jobs.empty(); });
+
+                if (!running && jobs.empty()) return;
+
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+
+            job();
+        }
+    }
+
+    ThreadPool &ThreadPool::get()
+    {
+        static ThreadPool instance;
+        return instance;
+    }
+};  // namespace bls
@@ -0,0 +1,33 @@
+#pragma once
+
+/**
+ * @brief A small pool of worker threads to split batched work (parallel for loops).
+ */
+
+#include "core/core.hpp"
+
+namespace bls
+{
+    class ThreadPool
+    {
+        public:
+            // Calls func(begin, end) over [0, count) in batches of at most batch_size, the caller thread helps out
+            void parallel_for(u32 count, u32 batch_size, const std::function<void(u32 begin, u32 end)> &func);
+            u32 get_worker_count();
+
+            static ThreadPool &get();
+
+        private:
+            ThreadPool();
+            ~ThreadPool();
+
+            void worker_loop();
+
+            std::vector<std::thread> workers;
+            std::queue<std::function<void()>> jobs;
+            std::mutex mutex;
+            std::condition_variable job_available;
+            std::condition_variable jobs_done;
+            bool running;
+    };
+};  // namespace bls
@@ -4,11 +4,21 @@
 #include "core/input.hpp"
 #include "platform/glfw/input.hpp"
 #include "platform/glfw/window.hpp"
+#include "platform/null/input.hpp"
+#include "platform/null/window.hpp"
+#include "renderer/renderer.hpp"
 
 namespace bls
 {
     Window *Window::create(const str &title, const u32 &width, const u32 &height)
     {
+        // The null renderer doesn't need a context, so there is nothing to open
+        if (Renderer::get_backend() == RendererBackend::Null)
+        {
+            Input::set_instance(new NullInput());
+            return new NullWindow(title, width, height);
+        }
+
 #ifdef _GLFW
         return new GlfwWindow(title, width, height);
 #else
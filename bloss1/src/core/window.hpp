@@ -18,7 +18,14 @@ namespace bls
             {
             }
 
+            // Poll the events and present the frame
             virtual void update() = 0;
+            virtual void poll_events() = 0;
+            virtual void swap_buffers() = 0;
+
+            // The rendering context is current in one thread at a time (see RenderThread)
+            virtual void set_context_current(bool current) = 0;
+
             virtual void sleep(f64 seconds) = 0;
 
             virtual u32 get_width() const = 0;
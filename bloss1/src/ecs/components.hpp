@@ -153,7 +153,8 @@ namespace bls
             enum class ColliderType
             {
                 Box,
-                Sphere
+                Sphere,
+                Terrain
             };
 
             enum ColliderMask
@@ -176,6 +177,10 @@ namespace bls
                         return "box";
                         break;
 
+                    case ColliderType::Terrain:
+                        return "terrain";
+                        break;
+
                     default:
                         LOG_ERROR("invalid collider type");
                         return "";
@@ -234,6 +239,19 @@ namespace bls
             f32 radius;
     };
 
+    // The ground under the entity position, from the height field of the renderer height map
+    class TerrainCollider : public Collider
+    {
+        public:
+            TerrainCollider(const vec3 &offset = vec3(0.0f),
+                            bool immovable = true,
+                            u32 description_mask = ColliderMask::World,
+                            u32 interaction_mask = ColliderMask::World)
+                : Collider(ColliderType::Terrain, offset, immovable, description_mask, interaction_mask)
+            {
+            }
+    };
+
     class Timer : public Component
     {
         public:
@@ -283,28 +301,45 @@ namespace bls
             f32 duration;
     };
 
+    // Key frames compiled to a looping Hermite curve (Catmull-Rom tangents), one array per channel
+    struct TransformTrack
+    {
+            std::vector<f32> times;
+            std::vector<vec3> positions, rotations, scales;
+            std::vector<vec3> position_tangents, rotation_tangents, scale_tangents;
+            f32 duration = 0.0f;
+    };
+
     class TransformAnimation : public Component
     {
         public:
-            TransformAnimation(std::vector<KeyFrame> key_frames) : key_frames(key_frames), curr_frame_idx(0)
+            TransformAnimation(std::vector<KeyFrame> key_frames) : key_frames(key_frames), time(0.0f), dirty(true)
             {
             }
 
             std::vector<KeyFrame> key_frames;
-            u32 curr_frame_idx;
+            TransformTrack track;
+            f32 time;    // Absolute playback time
+            bool dirty;  // Rebuild the track when the key frames change
     };
 
     class State;
     class StateMachine : public Component
     {
         public:
-            StateMachine(const str &current_state) : current_state(current_state)
+            StateMachine(const str &current_state)
+                : current_state(current_state), lod(AnimationLod::Full), frames_since_update(0), accumulated_dt(0.0f)
             {
                 state = std::make_unique<State>();
             }
 
             std::unique_ptr<State> state;
             str current_state;
+
+            // Animation LOD bookkeeping. The animator is shared by the model, so all its instances keep the same values
+            AnimationLod lod;
+            u32 frames_since_update;
+            f32 accumulated_dt;
     };
 
     class Projectile : public Component
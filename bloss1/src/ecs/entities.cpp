@@ -198,6 +198,17 @@ namespace bls
         return id;
     }
 
+    u32 terrain(ECS &ecs, const Transform &transform)
+    {
+        u32 id = ecs.get_id();
+
+        ecs.names[id] = "terrain";
+        ecs.transforms[id] = std::make_unique<Transform>(transform);
+        ecs.colliders[id] = std::make_unique<TerrainCollider>();
+
+        return id;
+    }
+
     u32 directional_light(ECS &ecs, const Transform &transform, const DirectionalLight &light)
     {
         u32 id = ecs.get_id();
@@ -22,6 +22,7 @@ namespace bls
     u32 vampire(ECS &ecs, const Transform &transform);
     u32 abomination(ECS &ecs, const Transform &transform);
     u32 floor(ECS &ecs, const Transform &transform);
+    u32 terrain(ECS &ecs, const Transform &transform);
     u32 directional_light(ECS &ecs, const Transform &transform, const DirectionalLight &light);
     u32 point_light(ECS &ecs, const Transform &transform, const PointLight &light);
     u32 text(ECS &ecs, const Transform &transform, const str &text, const vec3 &color);
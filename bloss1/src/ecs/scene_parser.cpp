@@ -7,6 +7,7 @@
 #include "renderer/font.hpp"
 #include "renderer/model.hpp"
 #include "renderer/post/post_processing.hpp"
+#include "renderer/shadow_map.hpp"
 
 namespace bls
 {
@@ -424,6 +425,27 @@ namespace bls
             }
         }
 
+        scene << "}"
+              << "\n\n";
+
+        // Shadows
+        const auto &shadow_config = AppConfig::shadow_config;
+        const auto write_list = [&scene](const std::vector<u32> &list)
+        {
+            for (u32 i = 0; i < list.size(); i++) scene << to_str(list[i]) << (i + 1 < list.size() ? ", " : "; ");
+        };
+
+        scene << "<shadows>\n";
+        scene << "{"
+              << "\n";
+        scene << "\tcache_static_casters: " << to_str(shadow_config.cache_static_casters) << "; \n";
+        scene << "\tcascade_update_intervals: ";
+        write_list(shadow_config.cascade_update_intervals);
+        scene << "\n";
+        scene << "\tcascade_resolutions: ";
+        write_list(shadow_config.cascade_resolutions);
+        scene << "\n";
+        scene << "\tdepth_bits: " << to_str(shadow_config.depth_bits) << "; \n";
         scene << "}"
               << "\n\n";
 
@@ -512,6 +534,17 @@ namespace bls
                     dimensions, offset, stoi(immovable), std::stoul(description_mask), std::stoul(interaction_mask));
             }
 
+            else if (type == "terrain")
+            {
+                offset = read_vec3(&iline, ',');
+                std::getline(iline, immovable, ',');
+                std::getline(iline, description_mask, ',');
+                std::getline(iline, interaction_mask, ';');
+
+                ecs.colliders[entity_id] = std::make_unique<TerrainCollider>(
+                    offset, stoi(immovable), std::stoul(description_mask), std::stoul(interaction_mask));
+            }
+
             else
                 LOG_ERROR("invalid collider type");
         }
@@ -923,6 +956,44 @@ namespace bls
                 }
             }
         }
+
+        else if (config_name == "shadows")
+        {
+            str parameter, values;
+
+            std::istringstream iline(line);
+            std::getline(iline, parameter, ':');
+            std::getline(iline, values, ';');
+
+            // Every shadow parameter is a list of unsigned values
+            std::vector<u32> list;
+            std::istringstream ivalues(values);
+            for (str value; std::getline(ivalues, value, ',');) list.push_back(std::stoul(value));
+
+            if (list.empty()) return;
+
+            auto &shadow_config = AppConfig::shadow_config;
+            auto &shadow_map = Game::get().get_renderer().get_shadow_map();
+
+            if (parameter == "cache_static_casters")
+                shadow_config.cache_static_casters = list[0];
+
+            else if (parameter == "cascade_update_intervals")
+                shadow_config.cascade_update_intervals = list;
+
+            // The atlas is only recreated when its layout or format actually changes
+            else if (parameter == "cascade_resolutions" && shadow_config.cascade_resolutions != list)
+            {
+                shadow_config.cascade_resolutions = list;
+                if (shadow_map) shadow_map->apply_config();
+            }
+
+            else if (parameter == "depth_bits" && shadow_config.depth_bits != list[0])
+            {
+                shadow_config.depth_bits = list[0];
+                if (shadow_map) shadow_map->apply_config();
+            }
+        }
     }
 
     vec3 SceneParser::read_vec3(std::istringstream *iline, char delimiter)
@@ -36,6 +36,18 @@ namespace bls
         animator->update_blended(dt);
     }
 
+    void State::update_keyed(ECS &ecs, u32 id, f32 dt)
+    {
+        auto &animator = ecs.models[id]->model->animator;
+        animator->update_blended_keyed(dt);
+    }
+
+    void State::interpolate(ECS &ecs, u32 id, f32 alpha)
+    {
+        auto &animator = ecs.models[id]->model->animator;
+        animator->interpolate_palette(alpha);
+    }
+
     void State::exit()
     {
     }
@@ -20,6 +20,14 @@ namespace bls
     class ECS;
     class SkeletalAnimation;
 
+    // Animation update rate tiers
+    enum class AnimationLod
+    {
+        Full,     // Every frame
+        Reduced,  // Every Nth frame, palettes interpolated in between
+        Frozen    // Off-screen, pose is kept as is
+    };
+
     void update_state_machine(ECS &ecs, u32 id, const str &state, f32 dt);
 
     class State
@@ -27,6 +35,8 @@ namespace bls
         public:
             virtual void enter(ECS &ecs, u32 id, const str &state);
             virtual void update(ECS &ecs, u32 id, f32 dt);
+            virtual void update_keyed(ECS &ecs, u32 id, f32 dt);
+            virtual void interpolate(ECS &ecs, u32 id, f32 alpha);
             virtual void exit();
 
         protected:
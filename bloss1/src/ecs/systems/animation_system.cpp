@@ -1,39 +1,135 @@
+#include "core/thread_pool.hpp"
 #include "ecs/ecs.hpp"
 #include "tools/profiler.hpp"
 
+#define ANIMATION_BATCH_SIZE 256U
+
 namespace bls
 {
+    void build_track(TransformAnimation &animation);
+    void sample_track(const TransformTrack &track, f32 time, Transform &transform);
+
     void animation_system(ECS &ecs, f32 dt)
     {
         BLS_PROFILE_SCOPE("animation_system");
 
-        auto &animations = ecs.transform_animations;
+        // Gather the work once so the batched pass does no map lookups
+        std::vector<std::pair<TransformAnimation *, Transform *>> batch;
+        batch.reserve(ecs.transform_animations.size());
+
         auto &transforms = ecs.transforms;
-        auto &timers = ecs.timers;
-        for (const auto &[id, animation] : animations)
+        for (const auto &[id, animation] : ecs.transform_animations)
+        {
+            if (!transforms.count(id)) continue;
+
+            if (animation->dirty) build_track(*animation);
+
+            batch.push_back({animation.get(), transforms[id].get()});
+        }
+
+        // Sample every track at its absolute time, each entity is independent so batches can run in parallel
+        ThreadPool::get().parallel_for(batch.size(),
+                                       ANIMATION_BATCH_SIZE,
+                                       [&batch, dt](u32 begin, u32 end)
+                                       {
+                                           for (u32 i = begin; i < end; i++)
+                                           {
+                                               auto &[animation, transform] = batch[i];
+                                               const auto &track = animation->track;
+
+                                               animation->time += dt;
+                                               if (track.duration > 0.0f)
+                                                   animation->time = fmod(animation->time, track.duration);
+
+                                               sample_track(track, animation->time, *transform);
+                                           }
+                                       });
+    }
+
+    // Tracks
+    // -----------------------------------------------------------------------------------------------------------------
+    void build_track(TransformAnimation &animation)
+    {
+        const auto &key_frames = animation.key_frames;
+        auto &track = animation.track;
+
+        track = {};
+        animation.dirty = false;
+
+        const u32 count = static_cast<u32>(key_frames.size());
+        if (count == 0) return;
+
+        // Each key frame is reached after its duration, so the loop starts from the last key frame
+        track.times.push_back(0.0f);
+        track.positions.push_back(key_frames[count - 1].transform.position);
+        track.rotations.push_back(key_frames[count - 1].transform.rotation);
+        track.scales.push_back(key_frames[count - 1].transform.scale);
+
+        for (const auto &key_frame : key_frames)
         {
-            auto &key_frames = animation->key_frames;
-            auto &curr_frame_idx = animation->curr_frame_idx;
-            auto curr_frame = key_frames[curr_frame_idx];
-            auto transform = transforms[id].get();
-            auto timer = timers[id].get();
-
-            // Set transform as curr frame transform
-            if (timer->time < curr_frame.duration)
-            {
-                f32 interpolation_factor = dt / (curr_frame.duration - timer->time);
-                transform->position = mix(transform->position, curr_frame.transform.position, interpolation_factor);
-                transform->rotation = mix(transform->rotation, curr_frame.transform.rotation, interpolation_factor);
-                transform->scale = mix(transform->scale, curr_frame.transform.scale, interpolation_factor);
-            }
-
-            // Update curr frame when frame duration ends
-            timer->time += dt;
-            if (timer->time > curr_frame.duration)
-            {
-                timer->time = 0.0f;
-                curr_frame_idx = (curr_frame_idx + 1) % key_frames.size();
-            }
+            track.duration += max(key_frame.duration, 0.0f);
+            track.times.push_back(track.duration);
+            track.positions.push_back(key_frame.transform.position);
+            track.rotations.push_back(key_frame.transform.rotation);
+            track.scales.push_back(key_frame.transform.scale);
         }
+
+        // Catmull-Rom tangents for non uniform knots, wrapping around the loop
+        auto tangent = [&](const std::vector<vec3> &values, u32 knot)
+        {
+            const u32 key = (knot + count - 1) % count;  // Knot 0 repeats the last key frame
+            const u32 prev = (key + count - 1) % count;
+            const u32 next = (key + 1) % count;
+
+            const f32 span = key_frames[key].duration + key_frames[next].duration;
+            if (span <= 0.0f) return vec3(0.0f);
+
+            return (values[next + 1] - values[prev + 1]) / span;
+        };
+
+        for (u32 knot = 0; knot < track.times.size(); knot++)
+        {
+            track.position_tangents.push_back(tangent(track.positions, knot));
+            track.rotation_tangents.push_back(tangent(track.rotations, knot));
+            track.scale_tangents.push_back(tangent(track.scales, knot));
+        }
+    }
+
+    void sample_track(const TransformTrack &track, f32 time, Transform &transform)
+    {
+        const auto &times = track.times;
+        if (times.empty()) return;
+
+        if (times.size() == 1 || track.duration <= 0.0f)
+        {
+            transform.position = track.positions.back();
+            transform.rotation = track.rotations.back();
+            transform.scale = track.scales.back();
+            return;
+        }
+
+        // Find the segment [k0, k1] containing the time
+        const u32 k1 = clamp(static_cast<u32>(std::upper_bound(times.begin(), times.end(), time) - times.begin()),
+                             1U,
+                             static_cast<u32>(times.size() - 1));
+        const u32 k0 = k1 - 1;
+
+        const f32 h = times[k1] - times[k0];
+        const f32 s = h > 0.0f ? (time - times[k0]) / h : 1.0f;
+        const f32 s2 = s * s;
+        const f32 s3 = s2 * s;
+
+        // Cubic Hermite basis
+        const f32 h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+        const f32 h10 = (s3 - 2.0f * s2 + s) * h;
+        const f32 h01 = -2.0f * s3 + 3.0f * s2;
+        const f32 h11 = (s3 - s2) * h;
+
+        auto hermite = [&](const std::vector<vec3> &values, const std::vector<vec3> &tangents)
+        { return values[k0] * h00 + tangents[k0] * h10 + values[k1] * h01 + tangents[k1] * h11; };
+
+        transform.position = hermite(track.positions, track.position_tangents);
+        transform.rotation = hermite(track.rotations, track.rotation_tangents);
+        transform.scale = hermite(track.scales, track.scale_tangents);
     }
 };  // namespace bls
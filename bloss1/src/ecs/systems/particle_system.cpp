@@ -2,18 +2,25 @@
 
 #include "core/game.hpp"
 #include "ecs/ecs.hpp"
+#include "renderer/frame_packet.hpp"
 #include "renderer/model.hpp"
 #include "renderer/primitives/quad.hpp"
 #include "renderer/shader.hpp"
 #include "renderer/texture.hpp"
 #include "tools/profiler.hpp"
 
+#define PARTICLE_INSTANCE_LOCATION 7  // Right after the model vertex attributes
+#define PARTICLE_INSTANCE_CAPACITY 1024
+
 namespace bls
 {
     std::map<u32, Timer> emission_timers;
+    std::unique_ptr<ParticleRenderer> particle_renderer;
 
-    void particle_system(ECS &ecs, f32 dt)
+    void particle_system(ECS &ecs, f32 dt, FramePacket &packet)
     {
+        BLS_PROFILE_SCOPE("particle_system");
+
         // Emit particles
         for (auto &[id, particle_sys] : ecs.particle_systems)
         {
@@ -36,26 +43,34 @@ namespace bls
             emission_timers[id].time += dt;
             if (emission_timers[id].time >= particle_sys->time_to_emit) emission_timers[id].time = 0.0f;
 
-            // Render particle
-            particle_sys->emitter->render_particle(ecs, dt);
+            // Update particles and gather the live ones
+            auto &emitter = particle_sys->emitter;
+            emitter->update(dt, emitter->particle_2D ? packet.particles_2D : packet.particles_3D);
         }
     }
 
+    void render_particles(const FramePacket &packet)
+    {
+        BLS_PROFILE_SCOPE("render_particles");
+
+        // Created where it draws, the render thread owns the context
+        if (!particle_renderer) particle_renderer = std::make_unique<ParticleRenderer>();
+
+        // Render all particles at once
+        particle_renderer->render(packet.particles_2D, packet.particles_3D);
+    }
+
+    void release_particle_renderer()
+    {
+        particle_renderer.reset();
+    }
+
     // Emitter
     // -----------------------------------------------------------------------------------------------------------------
     Emitter::Emitter(const vec3 &center, EmitterType type, bool particle_2D) : type(type)
     {
-        auto &renderer = Game::get().get_renderer();
-
-        particle_shader = Shader::create("particle",
-                                         "bloss1/assets/shaders/particles/particle.vs",
-                                         "bloss1/assets/shaders/particles/particle_texture.fs");
-        quad = std::make_unique<Quad>(renderer);
         pool_index = 9999;
         particle_pool.resize(pool_index + 1);
-        particle_texture =
-            Texture::create("particle", "bloss1/assets/textures/particles/particle_black.png", TextureType::Diffuse);
-        model = Model::create("particle", "bloss1/assets/models/particles/particle.obj", false);
 
         particle_to_emit.color_begin = {0.9f, 0.9f, 0.3f, 1.0f};
         particle_to_emit.color_end = {0.3f, 0.9f, 0.9f, 1.0f};
@@ -71,16 +86,8 @@ namespace bls
         this->particle_2D = particle_2D;
     }
 
-    void Emitter::render_particle(ECS &ecs, f32 dt)
+    void Emitter::update(f32 dt, std::vector<ParticleInstance> &instances)
     {
-        BLS_PROFILE_SCOPE("particle_system");
-
-        auto &renderer = Game::get().get_renderer();
-        renderer.set_blending(true);
-        renderer.set_face_culling(false);
-
-        auto camera = ecs.cameras.begin()->second.get();
-
         for (auto &particle : particle_pool)
         {
             if (!particle.active) continue;
@@ -94,54 +101,19 @@ namespace bls
             particle.life_remaining -= dt;
             particle.position += particle.velocity * dt;
             particle.rotation += 0.01f * dt;
-        }
-
-        particle_shader->bind();
-        particle_shader->set_uniform1("particleTexture", 0U);
-        particle_shader->set_uniform4("projection", camera->projection_matrix);
-        particle_shader->set_uniform4("view", camera->view_matrix);
-
-        for (const auto &particle : particle_pool)
-        {
-            if (!particle.active) continue;
 
             // Fade away particles
             f32 life = particle.life_remaining / particle.life_time;
             vec4 color = mix(particle.color_end, particle.color_begin, life);
             vec3 size = mix(particle.scale_end, particle.scale_begin, life);
 
-            // Render
             mat4 model_matrix = translate(mat4(1.0f), particle.position) *
                                 rotate(mat4(1.0f), particle.rotation.z, {0.0f, 0.0f, 1.0f}) *
                                 rotate(mat4(1.0f), particle.rotation.y, {0.0f, 1.0f, 0.0f}) *
                                 rotate(mat4(1.0f), particle.rotation.x, {1.0f, 0.0f, 0.0f}) * scale(mat4(1.0f), size);
 
-            particle_shader->set_uniform4("model", model_matrix);
-            particle_shader->set_uniform4("color", color);
-
-            // 2D particle (texture)
-            if (particle_2D)
-            {
-                particle_texture->bind(0);
-                quad->render();
-            }
-
-            // 3D particle (model)
-            else
-            {
-                for (auto &mesh : model->meshes)
-                {
-                    mesh->vao->bind();
-                    renderer.draw_indexed(RenderingMode::Triangles, mesh->indices.size());
-                    mesh->vao->unbind();
-
-                    AppStats::vertices += mesh->vertices.size();
-                }
-            }
+            instances.push_back({model_matrix, color});
         }
-
-        renderer.set_face_culling(true);
-        renderer.set_blending(false);
     }
 
     void Emitter::emit_particle(const Particle &particle_props)
@@ -187,6 +159,118 @@ namespace bls
         return particle_to_emit;
     }
 
+    // ParticleRenderer
+    // -----------------------------------------------------------------------------------------------------------------
+    ParticleRenderer::ParticleRenderer()
+    {
+        auto &renderer = Game::get().get_renderer();
+
+        particle_shader = Shader::create("particle",
+                                         "bloss1/assets/shaders/particles/particle.vs",
+                                         "bloss1/assets/shaders/particles/particle.fs");
+        particle_texture_shader = Shader::create("particle_texture",
+                                                 "bloss1/assets/shaders/particles/particle.vs",
+                                                 "bloss1/assets/shaders/particles/particle_texture.fs");
+        quad = std::make_unique<Quad>(renderer);
+        particle_texture =
+            Texture::create("particle", "bloss1/assets/textures/particles/particle_black.png", TextureType::Diffuse);
+        model = Model::create("particle", "bloss1/assets/models/particles/particle.obj", false);
+
+        // Instance buffers grow on demand
+        instance_buffer_2D.reset(VertexBuffer::create(PARTICLE_INSTANCE_CAPACITY * sizeof(ParticleInstance)));
+        instance_buffer_3D.reset(VertexBuffer::create(PARTICLE_INSTANCE_CAPACITY * sizeof(ParticleInstance)));
+
+        add_instance_attributes(quad->get_vertex_array(), instance_buffer_2D.get());
+        for (const auto &mesh : model->meshes)
+        {
+            auto vao = VertexArray::create();
+            vao->bind();
+
+            const u32 size = static_cast<u32>(mesh->vertices.size() * sizeof(Vertex));
+            model_vbos.emplace_back(VertexBuffer::create(mesh->vertices.data(), size));
+            model_ebos.emplace_back(IndexBuffer::create(mesh->indices, mesh->indices.size()));
+            Mesh::set_vertex_layout(vao);
+
+            model_vaos.emplace_back(vao);
+            add_instance_attributes(vao, instance_buffer_3D.get());
+        }
+    }
+
+    ParticleRenderer::~ParticleRenderer()
+    {
+    }
+
+    void ParticleRenderer::render(const std::vector<ParticleInstance> &instances_2D,
+                                  const std::vector<ParticleInstance> &instances_3D)
+    {
+        auto &renderer = Game::get().get_renderer();
+        renderer.set_blending(true);
+        renderer.set_face_culling(false);
+
+        // 2D particles (texture)
+        if (!instances_2D.empty())
+        {
+            const u32 count = static_cast<u32>(instances_2D.size());
+            instance_buffer_2D->set_data(instances_2D.data(), count * sizeof(ParticleInstance));
+
+            particle_texture_shader->bind();
+            particle_texture_shader->set_uniform1("particleTexture", 0U);
+
+            particle_texture->bind(0);
+            quad->render_instanced(count);
+
+            AppStats::render_stats.draw_calls++;
+        }
+
+        // 3D particles (model)
+        if (!instances_3D.empty())
+        {
+            const u32 count = static_cast<u32>(instances_3D.size());
+            instance_buffer_3D->set_data(instances_3D.data(), count * sizeof(ParticleInstance));
+
+            particle_shader->bind();
+
+            for (u32 i = 0; i < model->meshes.size(); i++)
+            {
+                const auto &mesh = model->meshes[i];
+
+                model_vaos[i]->bind();
+                renderer.draw_indexed_instanced(RenderingMode::Triangles, mesh->indices.size(), count);
+                model_vaos[i]->unbind();
+
+                AppStats::render_stats.draw_calls++;
+                AppStats::render_stats.vertices += mesh->vertices.size() * count;
+            }
+        }
+
+        renderer.set_face_culling(true);
+        renderer.set_blending(false);
+    }
+
+    void ParticleRenderer::add_instance_attributes(VertexArray *vao, VertexBuffer *instance_buffer)
+    {
+        vao->bind();
+        instance_buffer->bind();
+
+        // A mat4 takes 4 consecutive vec4 attributes
+        for (u32 i = 0; i < 4; i++)
+            vao->add_instance_buffer(PARTICLE_INSTANCE_LOCATION + i,
+                                     4,
+                                     ShaderDataType::Float,
+                                     false,
+                                     sizeof(ParticleInstance),
+                                     reinterpret_cast<void *>(offsetof(ParticleInstance, model) + i * sizeof(vec4)));
+
+        vao->add_instance_buffer(PARTICLE_INSTANCE_LOCATION + 4,
+                                 4,
+                                 ShaderDataType::Float,
+                                 false,
+                                 sizeof(ParticleInstance),
+                                 reinterpret_cast<void *>(offsetof(ParticleInstance, color)));
+
+        vao->unbind();
+    }
+
     // PointEmitter
     // -----------------------------------------------------------------------------------------------------------------
     PointEmitter::PointEmitter(const vec3 &center, bool particle_2D) : Emitter(center, EmitterType::Point, particle_2D)
@@ -14,7 +14,12 @@
 namespace bls
 {
     class ECS;
-    void particle_system(ECS &ecs, f32 dt);
+    struct FramePacket;
+
+    // Simulates the particles and gathers the live ones into the packet. They are drawn by render_particles
+    void particle_system(ECS &ecs, f32 dt, FramePacket &packet);
+    void render_particles(const FramePacket &packet);
+    void release_particle_renderer();  // With the rendering context current
 
     struct Particle
     {
@@ -31,6 +36,13 @@ namespace bls
             bool active = false;
     };
 
+    // Per instance data streamed to the GPU every frame
+    struct ParticleInstance
+    {
+            mat4 model;
+            vec4 color;
+    };
+
     class Emitter
     {
         public:
@@ -45,7 +57,7 @@ namespace bls
             virtual ~Emitter() = default;
 
             virtual void emit() = 0;
-            virtual void render_particle(ECS &ecs, f32 dt);
+            virtual void update(f32 dt, std::vector<ParticleInstance> &instances);
             virtual void set_center(const vec3 &new_center);
             virtual void set_particle(const Particle &particle);
             virtual Particle get_particle();
@@ -60,11 +72,35 @@ namespace bls
             std::vector<Particle> particle_pool;
             u32 pool_index;
 
-            std::shared_ptr<Shader> particle_shader;
+            Particle particle_to_emit;
+    };
+
+    // Draws the live particles of every emitter with one instanced call per particle type (2D/3D)
+    class ParticleRenderer
+    {
+        public:
+            ParticleRenderer();
+            ~ParticleRenderer();
+
+            // The camera comes from the FrameData block
+            void render(const std::vector<ParticleInstance> &instances_2D,
+                        const std::vector<ParticleInstance> &instances_3D);
+
+        private:
+            void add_instance_attributes(VertexArray *vao, VertexBuffer *instance_buffer);
+
+            std::shared_ptr<Shader> particle_shader, particle_texture_shader;
             std::unique_ptr<Quad> quad;
             std::shared_ptr<Texture> particle_texture;
             std::shared_ptr<Model> model;
-            Particle particle_to_emit;
+
+            // The particle model has its own vertex arrays: the instance attributes go where the shared geometry
+            // buffer has the draw index
+            std::vector<std::unique_ptr<VertexArray>> model_vaos;
+            std::vector<std::unique_ptr<VertexBuffer>> model_vbos;
+            std::vector<std::unique_ptr<IndexBuffer>> model_ebos;
+
+            std::unique_ptr<VertexBuffer> instance_buffer_2D, instance_buffer_3D;
     };
 
     class PointEmitter : public Emitter
@@ -1,4 +1,6 @@
+#include "core/game.hpp"
 #include "ecs/systems.hpp"
+#include "renderer/height_map.hpp"
 #include "tools/profiler.hpp"
 
 #define GRAVITY 50.0f
@@ -17,6 +19,10 @@ namespace bls
 
     void resolve_collisions(ECS &ecs);
     Collision test_collision(ECS &ecs, u32 id_a, u32 id_b);
+    Collision test_terrain_collision(const HeightField &field,
+                                     const Transform &terrain,
+                                     const Collider *collider,
+                                     const Transform &transform);
     void solve_collision(ECS &ecs, u32 id_a, u32 id_b, Collision collision);
     f32 apply_deceleration(f32 velocity, f32 deceleration, f32 mass, f32 dt);
     void update_physics(ECS &ecs, f32 dt);
@@ -142,6 +148,23 @@ namespace bls
 
         Collision collision = {};
 
+        // Terrain v. Sphere and Box. The pair is tested with the terrain first
+        const bool terrain_a = collider_a->type == Collider::ColliderType::Terrain;
+        const bool terrain_b = collider_b->type == Collider::ColliderType::Terrain;
+        if (terrain_a || terrain_b)
+        {
+            auto &height_map = Game::get().get_renderer().get_height_map();
+            if ((terrain_a && terrain_b) || !height_map) return collision;
+
+            const auto &field = height_map->get_height_field();
+            if (terrain_a) return test_terrain_collision(field, trans_a, collider_b, trans_b);
+
+            collision = test_terrain_collision(field, trans_b, collider_a, trans_a);
+            std::swap(collision.point_a, collision.point_b);
+
+            return collision;
+        }
+
         // Sphere v. Box
         if (collider_a->type == Collider::ColliderType::Sphere && collider_b->type == Collider::ColliderType::Box)
         {
@@ -307,6 +330,48 @@ namespace bls
         throw std::runtime_error("invalid collider types");
     }
 
+    Collision test_terrain_collision(const HeightField &field,
+                                     const Transform &terrain,
+                                     const Collider *collider,
+                                     const Transform &transform)
+    {
+        Collision collision = {};
+
+        // The ground under the collider center is taken as a plane: its height and normal at that point
+        const vec3 center = transform.position - terrain.position;
+        if (!field.contains(center.x, center.z)) return collision;
+
+        const vec3 normal = field.get_normal(center.x, center.z);
+        const vec3 ground = vec3(center.x, field.get_height(center.x, center.z), center.z);
+
+        // Deepest point of the collider along the normal
+        vec3 deepest;
+        if (collider->type == Collider::ColliderType::Sphere)
+            deepest = center - normal * static_cast<const SphereCollider *>(collider)->radius;
+
+        else if (collider->type == Collider::ColliderType::Box)
+        {
+            const auto &dimensions = static_cast<const BoxCollider *>(collider)->dimensions;
+            deepest = center - vec3(normal.x >= 0.0f ? dimensions.x : -dimensions.x,
+                                    normal.y >= 0.0f ? dimensions.y : -dimensions.y,
+                                    normal.z >= 0.0f ? dimensions.z : -dimensions.z);
+        }
+
+        else
+            throw std::runtime_error("invalid collider types");
+
+        // Below the ground: the collider is pushed out along the normal (the terrain is pushed the other way)
+        const f32 depth = dot(ground - deepest, normal);
+        if (depth > 0.0f)
+        {
+            collision.point_a = deepest;
+            collision.point_b = deepest + normal * depth;
+            collision.has_collision = true;
+        }
+
+        return collision;
+    }
+
     // Collision solver
     // -----------------------------------------------------------------------------------------------------------------
     void solve_collision(ECS &ecs, u32 id_a, u32 id_b, Collision collision)
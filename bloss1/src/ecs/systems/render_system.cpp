@@ -1,150 +1,457 @@
 #include "config.hpp"
 #include "core/game.hpp"
+#include "core/thread_pool.hpp"
 #include "ecs/ecs.hpp"
+#include "ecs/systems/render_system.hpp"
+#include "renderer/dynamic_resolution.hpp"
 #include "renderer/font.hpp"
+#include "renderer/frame_uniforms.hpp"
+#include "renderer/gpu_timer.hpp"
+#include "renderer/light_clusters.hpp"
 #include "renderer/model.hpp"
 #include "renderer/primitives/box.hpp"
 #include "renderer/primitives/line.hpp"
 #include "renderer/primitives/sphere.hpp"
+#include "renderer/render_queue.hpp"
+#include "renderer/shadow_map.hpp"
+#include "tools/profiler.hpp"
+
+#define RENDER_SCENE_BATCH_SIZE 128U
 
 namespace bls
 {
-    void render_scene(ECS &ecs, Shader &shader, Renderer &renderer)
+    // GPU resources kept across frames. Created where they are used (the render thread owns the context) and freed by
+    // release_render_resources
+    std::unique_ptr<RenderQueue> render_queue;
+    std::unique_ptr<LightClusters> light_clusters;
+    std::unique_ptr<FrameUniforms> frame_uniforms;
+    std::unique_ptr<RenderGraph> render_graph;
+    std::unique_ptr<GpuTimer> frame_timer;
+
+    DynamicResolution dynamic_resolution;
+
+    // Draw items recorded by one batch of entities
+    struct SceneBatch
     {
-        // Render all entities
-        for (const auto &[id, model] : ecs.models)
+            std::vector<DrawItem> items;
+            u32 meshes_visible, meshes_culled;
+    };
+
+    // Reused every pass to avoid reallocating
+    std::vector<u32> scene_entities;  // Indices into the packet entities
+    std::vector<u8> scene_visibility;
+    BoundingSphereBatch scene_bounds;
+    std::vector<SceneBatch> scene_batches;
+    std::unordered_map<const Animator *, u32> animator_bone_offsets;
+
+    u64 static_casters_signature = 0;
+
+    mat4 get_model_matrix(ECS &ecs, u32 id)
+    {
+        // Remember: scale -> rotate -> translate
+        auto transform = ecs.transforms[id].get();
+        auto model_matrix = mat4(1.0f);
+
+        // Translate
+        model_matrix = translate(model_matrix, transform->position);
+
+        // Player model matrix
+        if (ecs.names[id] == "player")
         {
-            // Reset bone matrices
-            for (u32 i = 0; i < MAX_BONE_MATRICES; i++)
-                shader.set_uniform4("finalBonesMatrices[" + to_str(i) + "]", mat4(1.0f));
+            // Rotate
+            model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
+            model_matrix = rotate(model_matrix, radians(-transform->rotation.y + 90.0f), vec3(0.0f, 1.0f, 0.0f));
+            model_matrix = rotate(model_matrix, radians(-transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
+        }
 
-            // Update animators
-            auto animator = model->model->animator.get();
-            if (animator)
-            {
-                // Update bone matrices
-                auto bone_matrices = animator->get_final_bone_matrices();
-                for (u32 i = 0; i < bone_matrices.size(); i++)
-                    shader.set_uniform4("finalBonesMatrices[" + to_str(i) + "]", bone_matrices[i]);
-            }
+        // Player bullet model matrix
+        else if (ecs.names[id] == "bullet" && ecs.projectiles[id]->sender_id == 0)
+        {
+            model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
+            model_matrix = rotate(model_matrix, radians(-transform->rotation.y + 90.0f), vec3(0.0f, 1.0f, 0.0f));
+            model_matrix = rotate(model_matrix, radians(-transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
+        }
 
-            // Remember: scale -> rotate -> translate
-            auto transform = ecs.transforms[id].get();
-            auto model_matrix = mat4(1.0f);
+        // Ophanim model matrix
+        else if (ecs.names[id] == "ophanim")
+        {
+            // Compensate for model rotation
+            model_matrix = rotate(model_matrix, radians(transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
+            model_matrix = rotate(model_matrix, radians(transform->rotation.y - 90.0f), vec3(0.0f, 1.0f, 0.0f));
+            model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
+        }
 
-            // Translate
-            model_matrix = translate(model_matrix, transform->position);
+        else
+        {
+            // Rotate
+            model_matrix = rotate(model_matrix, radians(transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
+            model_matrix = rotate(model_matrix, radians(transform->rotation.y), vec3(0.0f, 1.0f, 0.0f));
+            model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
+        }
 
-            // Player model matrix
-            if (ecs.names[id] == "player")
-            {
-                // Rotate
-                model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
-                model_matrix = rotate(model_matrix, radians(-transform->rotation.y + 90.0f), vec3(0.0f, 1.0f, 0.0f));
-                model_matrix = rotate(model_matrix, radians(-transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
-            }
+        // Scale
+        model_matrix = scale(model_matrix, transform->scale);
 
-            // Player bullet model matrix
-            else if (ecs.names[id] == "bullet" && ecs.projectiles[id]->sender_id == 0)
-            {
-                model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
-                model_matrix = rotate(model_matrix, radians(-transform->rotation.y + 90.0f), vec3(0.0f, 1.0f, 0.0f));
-                model_matrix = rotate(model_matrix, radians(-transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
-            }
+        return model_matrix;
+    }
 
-            // Ophanim model matrix
-            else if (ecs.names[id] == "ophanim")
-            {
-                // Compensate for model rotation
-                model_matrix = rotate(model_matrix, radians(transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
-                model_matrix = rotate(model_matrix, radians(transform->rotation.y - 90.0f), vec3(0.0f, 1.0f, 0.0f));
-                model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
-            }
+    bool is_static_entity(ECS &ecs, u32 id)
+    {
+        if (ecs.models[id]->model->animator || ecs.transform_animations.count(id) || ecs.state_machines.count(id))
+            return false;
 
-            else
-            {
-                // Rotate
-                model_matrix = rotate(model_matrix, radians(transform->rotation.x), vec3(1.0f, 0.0f, 0.0f));
-                model_matrix = rotate(model_matrix, radians(transform->rotation.y), vec3(0.0f, 1.0f, 0.0f));
-                model_matrix = rotate(model_matrix, radians(transform->rotation.z), vec3(0.0f, 0.0f, 1.0f));
-            }
+        // Physics objects with no terminal velocity never move (e.g. the floor)
+        if (ecs.physics_objects.count(id)) return ecs.physics_objects[id]->terminal_velocity == vec3(0.0f);
 
-            // Scale
-            model_matrix = scale(model_matrix, transform->scale);
+        return true;
+    }
+
+    void extract_frame(ECS &ecs, f32 dt, FramePacket &packet)
+    {
+        BLS_PROFILE_SCOPE("extract_frame");
+
+        auto &window = Game::get().get_window();
 
-            // Bind and update data to shader
-            shader.set_uniform4("model", model_matrix);
+        packet.width = window.get_width();
+        packet.height = window.get_height();
 
-            // Render the model
-            for (const auto &mesh : model->model->meshes)
+        // Internal resolution, from the time of the frames drawn so far. Without a GPU measurement the time spent
+        // drawing on the render thread is used
+        const f32 frame_ms = AppStats::gpu_ms > 0.0f ? AppStats::gpu_ms : AppStats::render_ms;
+        AppStats::resolution_scale = dynamic_resolution.update(frame_ms);
+
+        packet.render_width = max(static_cast<u32>(packet.width * AppStats::resolution_scale), 1U);
+        packet.render_height = max(static_cast<u32>(packet.height * AppStats::resolution_scale), 1U);
+        packet.dt = dt;
+        packet.camera = *ecs.cameras.begin()->second;
+
+        // Point lights
+        auto &transforms = ecs.transforms;
+        for (auto &[id, light] : ecs.point_lights)
+        {
+            packet.point_light_positions.push_back(transforms[id]->position);
+            packet.point_light_colors.push_back(light->diffuse);
+        }
+
+        // Directional lights
+        for (auto &[id, light] : ecs.dir_lights)
+        {
+            if (packet.dir_light_directions.size() == MAX_LIGHTS) break;
+
+            packet.dir_light_directions.push_back(transforms[id]->rotation);
+            packet.dir_light_colors.push_back(light->diffuse);
+            packet.dir_light_ambients.push_back(light->ambient);
+            packet.dir_light_speculars.push_back(light->specular);
+        }
+
+        // Entities. The animation system keeps changing the bone matrices, so they are copied (once per animator)
+        animator_bone_offsets.clear();
+        for (const auto &[id, model] : ecs.models)
+        {
+            u32 bone_offset = FRAME_PACKET_NO_BONES;
+            if (auto animator = model->model->animator.get())
             {
-                // Bind textures
-                for (u32 i = 0; i < mesh->textures.size(); i++)
+                const auto [it, inserted] =
+                    animator_bone_offsets.try_emplace(animator, static_cast<u32>(packet.bone_matrices.size()));
+
+                if (inserted)
                 {
-                    auto texture = mesh->textures[i];
+                    const auto &bone_matrices = animator->get_final_bone_matrices();
+                    packet.bone_matrices.insert(packet.bone_matrices.end(), bone_matrices.begin(), bone_matrices.end());
+                }
+
+                bone_offset = it->second;
+            }
+
+            packet.entities.push_back(
+                {id, model->model, get_model_matrix(ecs, id), bone_offset, is_static_entity(ecs, id)});
+        }
+
+        // Particles are game state: simulated here, drawn from the packet
+        particle_system(ecs, dt, packet);
+
+        // Texts
+        for (const auto &[id, text] : ecs.texts)
+            packet.texts.push_back(
+                {text->font, text->text, vec2(text->position.x, text->position.y), text->scale, text->color});
+
+        // Colliders (debug only)
+#if !defined(_RELEASE)
+        packet.render_colliders = AppConfig::render_colliders;
+#else
+        packet.render_colliders = false;
+#endif
+        if (!packet.render_colliders) return;
+
+        for (const auto &[id, collider] : ecs.colliders)
+        {
+            // The terrain is drawn by the height map
+            if (collider->type == Collider::ColliderType::Terrain) continue;
+
+            auto &transform = ecs.transforms[id];
+
+            FramePacket::ColliderItem item;
+            item.sphere = collider->type == Collider::ColliderType::Sphere;
+            item.center = transform->position + collider->offset;
+            item.size = item.sphere ? vec3(static_cast<SphereCollider *>(collider.get())->radius)
+                                    : static_cast<BoxCollider *>(collider.get())->dimensions;
+            item.color = collider->color;
+
+            // Orientation vector
+            auto pitch = transform->rotation.x;
+            auto yaw = transform->rotation.y;
+            item.origin = transform->position;
+            item.front = vec3(
+                cos(radians(yaw)) * cos(radians(pitch)), sin(radians(pitch)), sin(radians(yaw)) * cos(radians(pitch)));
+
+            packet.colliders.push_back(item);
+        }
+    }
+
+    void render_scene(
+        const FramePacket &packet, Shader &shader, Renderer &renderer, const Frustum *frustum, SceneFilter filter)
+    {
+        static const std::vector<mat4> identity_bone_matrices(MAX_BONE_MATRICES, mat4(1.0f));
+
+        const auto &camera = packet.camera;
+        auto &thread_pool = ThreadPool::get();
+
+        // Pick the entities of the pass
+        scene_entities.clear();
+        for (u32 i = 0; i < packet.entities.size(); i++)
+        {
+            const auto &entity = packet.entities[i];
+            if (filter != SceneFilter::All && entity.is_static != (filter == SceneFilter::Static)) continue;
+
+            scene_entities.push_back(i);
+        }
 
-                    str type_name;
-                    auto type = texture->get_type();
+        const u32 count = static_cast<u32>(scene_entities.size());
+
+        // Gather the world bounds of every entity
+        scene_bounds.resize(count);
+        thread_pool.parallel_for(count,
+                                 RENDER_SCENE_BATCH_SIZE,
+                                 [&packet](u32 begin, u32 end)
+                                 {
+                                     for (u32 i = begin; i < end; i++)
+                                     {
+                                         const auto &entity = packet.entities[scene_entities[i]];
+                                         scene_bounds.set(i, entity.model->bounds.transformed(entity.model_matrix));
+                                     }
+                                 });
+
+        // Test all entities at once before anything is recorded
+        if (frustum)
+        {
+            BLS_PROFILE_SCOPE("frustum_culling");
+            frustum->cull(scene_bounds, scene_visibility);
+        }
+
+        else
+            scene_visibility.assign(count, 1);
+
+        // Record the visible entities. Each batch writes to its own list, so the workers share nothing
+        if (!render_queue) render_queue = std::make_unique<RenderQueue>();
+
+        const u32 shader_id = render_queue->get_shader_id(&shader);
+        const u32 batch_count = (count + RENDER_SCENE_BATCH_SIZE - 1) / RENDER_SCENE_BATCH_SIZE;
+        if (scene_batches.size() < batch_count) scene_batches.resize(batch_count);
 
-                    switch (type)
+        {
+            BLS_PROFILE_SCOPE("record_draw_items");
+
+            thread_pool.parallel_for(
+                count,
+                RENDER_SCENE_BATCH_SIZE,
+                [&packet, &shader, &camera, frustum, shader_id](u32 begin, u32 end)
+                {
+                    auto &batch = scene_batches[begin / RENDER_SCENE_BATCH_SIZE];
+                    batch.items.clear();
+                    batch.meshes_visible = 0;
+                    batch.meshes_culled = 0;
+
+                    for (u32 i = begin; i < end; i++)
                     {
-                        case TextureType::Diffuse:
-                            type_name = "diffuse";
-                            break;
-                        case TextureType::Specular:
-                            type_name = "specular";
-                            break;
-                        case TextureType::Normal:
-                            type_name = "normal";
-                            break;
-                        case TextureType::Metalness:
-                            type_name = "metalness";
-                            break;
-                        case TextureType::Roughness:
-                            type_name = "roughness";
-                            break;
-                        case TextureType::AmbientOcclusion:
-                            type_name = "ao";
-                            break;
-                        case TextureType::Emissive:
-                            type_name = "emissive";
-                            break;
-
-                        default:
-                            LOG_ERROR("invalid texture type");
-                            break;
+                        const auto &entity = packet.entities[scene_entities[i]];
+                        auto model = entity.model;
+                        const auto &model_matrix = entity.model_matrix;
+
+                        if (!scene_visibility[i])
+                        {
+                            batch.meshes_culled += model->meshes.size();
+                            continue;
+                        }
+
+                        // Use the bone matrices (or reset them for static models)
+                        const auto *bone_matrices = entity.bone_offset != FRAME_PACKET_NO_BONES
+                                                        ? &packet.bone_matrices[entity.bone_offset]
+                                                        : identity_bone_matrices.data();
+
+                        const f32 depth = dot(vec3(model_matrix[3]) - camera.position, camera.front);
+
+                        for (const auto &mesh : model->meshes)
+                        {
+                            // Models made of several meshes are also tested per mesh
+                            if (frustum && model->meshes.size() > 1 &&
+                                !frustum->intersects(mesh->bounds.transformed(model_matrix)))
+                            {
+                                batch.meshes_culled++;
+                                continue;
+                            }
+
+                            if (frustum) batch.meshes_visible++;
+
+                            const u64 key = render_queue->make_key(0, shader_id, mesh, depth, camera.far);
+                            batch.items.push_back({key, &shader, mesh, bone_matrices, model_matrix});
+                        }
                     }
+                });
+        }
 
-                    shader.set_uniform1("material." + type_name, i);
-                    texture->bind(i);  // Offset the active samplers in the frag shader
-                }
+        // Merge in entity order, so the result does not depend on the thread count
+        for (u32 b = 0; b < batch_count; b++)
+        {
+            const auto &batch = scene_batches[b];
+            render_queue->submit(batch.items);
 
-                mesh->vao->bind();
-                renderer.draw_indexed(RenderingMode::Triangles, mesh->indices.size());
-                mesh->vao->unbind();
+            AppStats::render_stats.meshes_visible += batch.meshes_visible;
+            AppStats::render_stats.meshes_culled += batch.meshes_culled;
+        }
+
+        // Sort and draw
+        render_queue->flush(renderer);
+    }
 
-                // Update stats
-                AppStats::vertices += mesh->vertices.size();
+    void render_shadows(const FramePacket &packet, ShadowMap &shadow_map, Renderer &renderer)
+    {
+        BLS_PROFILE_SCOPE("render_shadows");
+
+        auto &shader = shadow_map.get_shadow_depth_shader();
+
+        // Adding, removing or moving a static caster (e.g. from the editor) invalidates the cached layers
+        u64 signature = 14695981039346656037ULL;
+        for (const auto &entity : packet.entities)
+        {
+            if (!entity.is_static) continue;
+
+            const auto *bytes = reinterpret_cast<const u8 *>(&entity.model_matrix);
+
+            signature = (signature ^ entity.id) * 1099511628211ULL;
+            for (u32 i = 0; i < sizeof(mat4); i++) signature = (signature ^ bytes[i]) * 1099511628211ULL;
+        }
+
+        if (signature != static_casters_signature)
+        {
+            static_casters_signature = signature;
+            shadow_map.invalidate();
+        }
+
+        const auto filter = AppConfig::shadow_config.cache_static_casters ? SceneFilter::Dynamic : SceneFilter::All;
+
+        shadow_map.bind(packet.camera);
+        for (u32 cascade = 0; cascade < shadow_map.get_cascade_count(); cascade++)
+        {
+            if (!shadow_map.should_update(cascade)) continue;
+
+            // Only the casters inside the cascade light frustum
+            const auto cascade_frustum = Frustum(shadow_map.get_light_space_matrix(cascade));
+
+            if (shadow_map.should_update_static(cascade))
+            {
+                shadow_map.bind_static_cascade(cascade);
+                render_scene(packet, shader, renderer, &cascade_frustum, SceneFilter::Static);
             }
+
+            // The dynamic casters go on top of the cached static ones
+            shadow_map.bind_cascade(cascade);
+            render_scene(packet, shader, renderer, &cascade_frustum, filter);
         }
+
+        shadow_map.unbind();
     }
 
-    void render_ui()
+    RenderGraph &get_render_graph()
+    {
+        if (!render_graph) render_graph = std::make_unique<RenderGraph>();
+        return *render_graph;
+    }
+
+    RenderResource add_shadow_pass(RenderGraph &graph, const FramePacket &packet)
+    {
+        auto *renderer = &Game::get().get_renderer();
+        auto *shadow_map = renderer->get_shadow_map().get();
+        if (!shadow_map) return RENDER_RESOURCE_NONE;
+
+        // The atlas is persistent: the cascades that are not updated this frame keep their depth
+        const auto shadow_atlas = graph.import_resource("shadow_atlas", shadow_map->get_memory_usage());
+        graph.add_pass("shadows",
+                       {},
+                       {shadow_atlas},
+                       [&packet, shadow_map, renderer](RenderGraph &)
+                       { render_shadows(packet, *shadow_map, *renderer); });
+
+        return shadow_atlas;
+    }
+
+    void execute_render_graph(RenderGraph &graph)
+    {
+        if (!frame_timer) frame_timer.reset(GpuTimer::create());
+
+        graph.compile();
+
+        frame_timer->begin();
+        graph.execute();
+        frame_timer->end();
+
+        auto &stats = AppStats::render_stats;
+        stats.gpu_ms = frame_timer->get_elapsed_ms();
+        stats.render_target_bytes = graph.get_pool_memory() + graph.get_imported_memory();
+        stats.render_target_unaliased_bytes = graph.get_unaliased_memory() + graph.get_imported_memory();
+    }
+
+    void set_frame_uniforms(const FramePacket &packet)
+    {
+        // Every shader reads the camera from the FrameData block, so this is written once for the whole frame
+        auto &shadow_map = Game::get().get_renderer().get_shadow_map();
+        if (!frame_uniforms) frame_uniforms = std::make_unique<FrameUniforms>();
+        frame_uniforms->update(packet, shadow_map ? shadow_map->get_light_dir() : vec3(0.0f));
+    }
+
+    void set_light_uniforms(const FramePacket &packet, Shader &shader)
+    {
+        // The lights go to storage buffers with the per cluster light lists
+        if (!light_clusters) light_clusters = std::make_unique<LightClusters>();
+
+        light_clusters->update(packet);
+        light_clusters->bind(shader);
+    }
+
+    void release_render_resources()
+    {
+        render_queue.reset();
+        light_clusters.reset();
+        frame_uniforms.reset();
+        render_graph.reset();
+        frame_timer.reset();
+
+        release_particle_renderer();
+    }
+
+    void render_ui(const FramePacket &packet, u32 width, u32 height)
     {
         auto &renderer = Game::get().get_renderer();
         auto &textures = renderer.get_textures();
         auto &shader = renderer.get_shaders()["ui"];
         auto &quad = renderer.get_rendering_quad();
-        auto &window = Game::get().get_window();
-
-        auto width = window.get_width();
-        auto height = window.get_height();
 
         auto p = std::find_if(textures.begin(), textures.end(), [](auto p) { return p.first == "ui"; });
         std::shared_ptr<bls::Texture> ui_texture = p->second;
 
-        auto tex_width = ui_texture->get_width();
-        auto tex_height = ui_texture->get_height();
+        // The target is smaller than the window at a lower render size, the crosshair keeps its size on screen
+        const f32 scale = static_cast<f32>(width) / packet.width;
+        auto tex_width = static_cast<u32>(ui_texture->get_width() * scale);
+        auto tex_height = static_cast<u32>(ui_texture->get_height() * scale);
 
         renderer.set_viewport(
             (width / 2) - (tex_width / 4), (height / 2) - (tex_height / 4), tex_width / 2, tex_height / 2);
@@ -155,27 +462,20 @@ namespace bls
         quad->render();
     }
 
-    void render_texts(ECS &ecs)
+    void render_texts(const FramePacket &packet, u32 width, u32 height)
     {
         auto &renderer = Game::get().get_renderer();
-        auto &window = Game::get().get_window();
-
-        auto width = window.get_width();
-        auto height = window.get_height();
-
         renderer.set_viewport(0, 0, width, height);
 
-        const auto &texts = ecs.texts;
-        for (const auto &[id, text] : texts)
-            text->font->render(text->text, text->position.x, text->position.y, text->scale, text->color);
+        for (const auto &text : packet.texts)
+            text.font->render(text.text, text.position.x, text.position.y, text.scale, text.color);
     }
 
-    void render_colliders(ECS &ecs, const mat4 &projection, const mat4 &view)
+    void render_colliders(const FramePacket &packet, u32 width, u32 height)
     {
         // Restore viewport
         auto &renderer = Game::get().get_renderer();
-        auto &window = Game::get().get_window();
-        renderer.set_viewport(0, 0, window.get_width(), window.get_height());
+        renderer.set_viewport(0, 0, width, height);
 
         // Set debug mode
         renderer.set_debug_mode(true);
@@ -183,8 +483,6 @@ namespace bls
         auto color_shader = Shader::create("color", "", "");
         color_shader->bind();
 
-        color_shader->set_uniform4("projection", projection);
-        color_shader->set_uniform4("view", view);
         color_shader->set_uniform4("model", mat4(1.0f));
         color_shader->set_uniform3("color", {1.0f, 0.0f, 0.0f});
 
@@ -208,37 +506,24 @@ namespace bls
         }
 
         // Render colliders
-        for (const auto &[id, collider] : ecs.colliders)
+        for (const auto &collider : packet.colliders)
         {
-            auto &transform = ecs.transforms[id];
-
-            color_shader->set_uniform3("color", collider->color);
-            if (collider->type == Collider::ColliderType::Sphere)
+            color_shader->set_uniform3("color", collider.color);
+            if (collider.sphere)
             {
-                auto collider_sphere = std::make_unique<Sphere>(renderer,
-                                                                transform->position + collider->offset,
-                                                                static_cast<SphereCollider *>(collider.get())->radius);
-
+                auto collider_sphere = std::make_unique<Sphere>(renderer, collider.center, collider.size.x);
                 collider_sphere->render();
             }
 
-            else if (collider->type == Collider::ColliderType::Box)
+            else
             {
-                auto collider_box = std::make_unique<Box>(renderer,
-                                                          transform->position + collider->offset,
-                                                          static_cast<BoxCollider *>(collider.get())->dimensions);
-
+                auto collider_box = std::make_unique<Box>(renderer, collider.center, collider.size);
                 collider_box->render();
             }
 
             // Render orientation vector
-            auto pitch = transform->rotation.x;
-            auto yaw = transform->rotation.y;
-            auto front = vec3(
-                cos(radians(yaw)) * cos(radians(pitch)), sin(radians(pitch)), sin(radians(yaw)) * cos(radians(pitch)));
-
             auto orientation_line =
-                std::make_unique<Line>(renderer, transform->position, transform->position + (front * 30.0f));
+                std::make_unique<Line>(renderer, collider.origin, collider.origin + (collider.front * 30.0f));
 
             color_shader->set_uniform3("color", {1.0f, 0.0f, 1.0f});
             orientation_line->render();
@@ -5,12 +5,48 @@
  */
 
 #include "ecs/ecs.hpp"
+#include "math/bounds.hpp"
+#include "renderer/frame_packet.hpp"
+#include "renderer/render_graph.hpp"
 #include "renderer/shader.hpp"
 
 namespace bls
 {
-    void render_scene(ECS &ecs, Shader &shader, Renderer &renderer);
-    void render_colliders(ECS &ecs, const mat4 &projection, const mat4 &view);
-    void render_texts(ECS &ecs);
-    void render_ui();
+    class ShadowMap;
+
+    // Static entities are the ones that can not move: no animations, state machine or velocity
+    enum class SceneFilter
+    {
+        All,
+        Static,
+        Dynamic
+    };
+
+    // Copy what the frame needs out of the ECS (main thread). Everything below only reads the packet
+    void extract_frame(ECS &ecs, f32 dt, FramePacket &packet);
+
+    // Entities outside the frustum are skipped. Without a frustum every entity is drawn
+    void render_scene(const FramePacket &packet,
+                      Shader &shader,
+                      Renderer &renderer,
+                      const Frustum *frustum = nullptr,
+                      SceneFilter filter = SceneFilter::All);
+    void render_shadows(const FramePacket &packet, ShadowMap &shadow_map, Renderer &renderer);
+
+    // The frames declare their passes in the graph every frame, its render targets are pooled across frames
+    RenderGraph &get_render_graph();
+    RenderResource add_shadow_pass(RenderGraph &graph, const FramePacket &packet);  // None without a shadow map
+    void execute_render_graph(RenderGraph &graph);  // Also reports the render target memory
+
+    void set_frame_uniforms(const FramePacket &packet);  // Before any draw of the frame
+    void set_light_uniforms(const FramePacket &packet, Shader &shader);
+
+    // Free the GPU resources the render systems keep across frames. Must be called with the rendering context current
+    // (they would otherwise be destroyed with the statics, after the context)
+    void release_render_resources();
+
+    // Overlays, drawn over a target of the given size (the window or the render size)
+    void render_colliders(const FramePacket &packet, u32 width, u32 height);
+    void render_texts(const FramePacket &packet, u32 width, u32 height);
+    void render_ui(const FramePacket &packet, u32 width, u32 height);
 };  // namespace bls
@@ -1,5 +1,6 @@
 #include "config.hpp"
 #include "core/game.hpp"
+#include "core/render_thread.hpp"
 #include "ecs/ecs.hpp"
 #include "ecs/systems/render_system.hpp"
 #include "renderer/height_map.hpp"
@@ -11,22 +12,20 @@
 
 namespace bls
 {
-    void render_system_deferred(ECS &ecs, f32 dt)
+    void render_frame_deferred(const FramePacket &packet)
     {
-        BLS_PROFILE_SCOPE("render_system_deferred");
+        BLS_PROFILE_SCOPE("render_frame_deferred");
 
-        auto &window = Game::get().get_window();
         auto &renderer = Game::get().get_renderer();
 
-        auto width = window.get_width();
-        auto height = window.get_height();
+        auto width = packet.width;
+        auto height = packet.height;
+        auto render_width = packet.render_width;
+        auto render_height = packet.render_height;
 
-        auto camera = ecs.cameras.begin()->second.get();
-        auto position = camera->position;
-        auto projection = camera->projection_matrix;
-        auto view = camera->view_matrix;
-        auto near = camera->near;
-        auto far = camera->far;
+        const auto &camera = packet.camera;
+        auto projection = camera.projection_matrix;
+        auto view = camera.view_matrix;
 
         auto &shaders = renderer.get_shaders();
         auto &textures = renderer.get_textures();
@@ -41,130 +40,134 @@ namespace bls
         auto g_buffer_shader = shaders["g_buffer"].get();
         auto pbr_shader = shaders["pbr"].get();
 
-        // Reset the viewport
-        renderer.clear_color({0.0f, 0.0f, 0.0f, 1.0f});
-        renderer.clear();
-        renderer.set_viewport(0, 0, width, height);
-
-        // Render shadow map
-        shadow_map->bind(*camera);
-        render_scene(ecs, shadow_map->get_shadow_depth_shader(), renderer);
-        shadow_map->unbind();
+        // Camera and frame constants, read by every shader
+        set_frame_uniforms(packet);
 
         // Reset the viewport
         renderer.clear_color({0.0f, 0.0f, 0.0f, 1.0f});
         renderer.clear();
         renderer.set_viewport(0, 0, width, height);
 
-        // Geometry pass: render scene data into gbuffer
-        // -------------------------------------------------------------------------------------------------------------
-        g_buffer->bind();
-        renderer.clear();
-
-        g_buffer_shader->bind();
-        g_buffer_shader->set_uniform4("projection", projection);
-        g_buffer_shader->set_uniform4("view", view);
-
-        // Render the scene
-        render_scene(ecs, *g_buffer_shader, renderer);
+        auto &graph = get_render_graph();
+        graph.reset(width, height);
 
-        // Render height map
-        if (AppConfig::tess_wireframe)
-        {
-            renderer.set_debug_mode(AppConfig::tess_wireframe);
-            height_map->render(view, projection, dt);
-            renderer.set_debug_mode(!AppConfig::tess_wireframe);
-        }
-
-        else
-            height_map->render(view, projection, dt);
-
-        // Render particles
-        particle_system(ecs, dt);
+        // Render shadow map
+        const auto shadow_atlas = add_shadow_pass(graph, packet);
 
-        g_buffer->unbind();
-        g_buffer_shader->unbind();
+        // Geometry pass: render scene data into gbuffer. Below the window size only its lower left corner is used
+        // -------------------------------------------------------------------------------------------------------------
+        const auto g_buffer_data =
+            graph.import_resource("g_buffer", static_cast<u64>(width) * height * G_BUFFER_BYTES_PER_PIXEL);
+
+        graph.add_pass("geometry",
+                       {},
+                       {g_buffer_data},
+                       [&](RenderGraph &)
+                       {
+                           g_buffer->bind();
+                           renderer.set_viewport(0, 0, render_width, render_height);
+                           renderer.clear();
+
+                           g_buffer_shader->bind();
+
+                           // Render the scene (only what the camera sees)
+                           const auto frustum = Frustum(projection * view);
+                           render_scene(packet, *g_buffer_shader, renderer, &frustum);
+
+                           // Render height map
+                           if (AppConfig::tess_wireframe)
+                           {
+                               renderer.set_debug_mode(AppConfig::tess_wireframe);
+                               height_map->render(packet);
+                               renderer.set_debug_mode(!AppConfig::tess_wireframe);
+                           }
+
+                           else
+                               height_map->render(packet);
+
+                           // Render particles
+                           render_particles(packet);
+
+                           g_buffer->unbind();
+                           g_buffer_shader->unbind();
+                       });
 
         // Lighting pass: calculate lighting using the gbuffer content
         // -------------------------------------------------------------------------------------------------------------
-        renderer.clear();
-
-        pbr_shader->bind();
-
-        // Set camera position
-        pbr_shader->set_uniform3("viewPos", position);
-
-        // Set light uniforms
-        pbr_shader->set_uniform3("lightDir", shadow_map->get_light_dir());
-        pbr_shader->set_uniform1("near", near);
-        pbr_shader->set_uniform1("far", far);
-
-        // Set lights uniforms
-        u32 light_counter = 0;
-
-        // Point lights
-        auto &point_lights = ecs.point_lights;
-        auto &transforms = ecs.transforms;
-        for (auto &[id, light] : point_lights)
-        {
-            auto transform = transforms[id].get();
-
-            pbr_shader->set_uniform3("lights.pointLightPositions[" + to_str(light_counter) + "]", transform->position);
-            pbr_shader->set_uniform3("lights.pointLightColors[" + to_str(light_counter) + "]", light->diffuse);
+        const auto scene_color =
+            graph.create_texture("scene_color", {render_width, render_height, ImageFormat::RGB8, false});
 
-            light_counter++;
-        }
+        std::vector<RenderResource> lighting_reads = {g_buffer_data};
+        if (shadow_atlas != RENDER_RESOURCE_NONE) lighting_reads.push_back(shadow_atlas);
 
-        // Directional lights
-        light_counter = 0;
-        auto &dir_lights = ecs.dir_lights;
-        for (auto &[id, light] : dir_lights)
-        {
-            auto transform = transforms[id].get();
+        graph.add_pass("lighting",
+                       lighting_reads,
+                       {scene_color},
+                       [&](RenderGraph &)
+                       {
+                           pbr_shader->bind();
 
-            pbr_shader->set_uniform3("lights.dirLightDirections[" + to_str(light_counter) + "]", transform->rotation);
-            pbr_shader->set_uniform3("lights.dirLightColors[" + to_str(light_counter) + "]", light->diffuse);
+                           // Set lights uniforms
+                           set_light_uniforms(packet, *pbr_shader);
 
-            light_counter++;
-        }
+                           // Set texture attachments ---
+                           u32 tex_position = 0;
+                           for (const auto &[name, texture] : textures)
+                           {
+                               if (name == "ui") continue;
 
-        // Set texture attachments ---
-        u32 tex_position = 0;
-        for (const auto &[name, texture] : textures)
-        {
-            if (name == "ui") continue;
+                               pbr_shader->set_uniform1("textures." + name, tex_position);
+                               texture->bind(tex_position);
+                               tex_position++;
+                           }
 
-            pbr_shader->set_uniform1("textures." + name, tex_position);
-            texture->bind(tex_position);
-            tex_position++;
-        }
+                           // Bind maps
+                           skybox->bind(*pbr_shader, 12);                           // IBL maps
+                           if (shadow_map) shadow_map->bind_maps(*pbr_shader, 15);  // Shadow map
 
-        // Bind maps
-        skybox->bind(*pbr_shader, 12);           // IBL maps
-        shadow_map->bind_maps(*pbr_shader, 15);  // Shadow map
+                           quad->render();  // Render light quad
+                       });
 
-        // Begin post processing process
-        post_processing->begin();
-        quad->render();  // Render light quad
-        post_processing->end();
+        // Post processing
+        const auto backbuffer = graph.get_backbuffer();
+        post_processing->add_to_graph(graph, scene_color, backbuffer, g_buffer_data);
 
-        // Copy content of geometry's depth buffer to default framebuffer's depth buffer
+        // Overlays: drawn on the screen after the post chain, tested against the geometry depth
         // -------------------------------------------------------------------------------------------------------------
-        g_buffer->bind_and_blit(width, height);
-        g_buffer->unbind();
+        graph.add_pass("overlays",
+                       {g_buffer_data},
+                       {backbuffer},
+                       [&](RenderGraph &)
+                       {
+                           // Copy content of geometry's depth buffer to default framebuffer's depth buffer
+                           g_buffer->bind_and_blit(render_width, render_height, width, height);
+                           g_buffer->unbind();
 
-        // Draw the skybox last
-        skybox->draw(view, projection);
+                           // Draw the skybox last
+                           skybox->draw();
 
-        // Draw UI
-        render_ui();
+                           // Draw UI
+                           render_ui(packet, width, height);
 
 // Render debug lines
 #if !defined(_RELEASE)
-        if (AppConfig::render_colliders) render_colliders(ecs, projection, view);
+                           if (packet.render_colliders) render_colliders(packet, width, height);
 #endif
 
-        // Render texts
-        render_texts(ecs);
+                           // Render texts
+                           render_texts(packet, width, height);
+                       });
+
+        execute_render_graph(graph);
+    }
+
+    void render_system_deferred(ECS &ecs, f32 dt)
+    {
+        BLS_PROFILE_SCOPE("render_system_deferred");
+
+        // Snapshot the frame, it is drawn on the render thread (when running) while the next one is simulated
+        auto &render_thread = RenderThread::get();
+        extract_frame(ecs, dt, render_thread.get_packet());
+        render_thread.submit(render_frame_deferred);
     }
 };  // namespace bls
@@ -1,5 +1,6 @@
 #include "config.hpp"
 #include "core/game.hpp"
+#include "core/render_thread.hpp"
 #include "ecs/systems/render_system.hpp"
 #include "renderer/height_map.hpp"
 #include "renderer/post/post_processing.hpp"
@@ -9,22 +10,20 @@
 
 namespace bls
 {
-    void render_system_forward(ECS &ecs, f32 dt)
+    void render_frame_forward(const FramePacket &packet)
     {
-        BLS_PROFILE_SCOPE("render_system_forward");
+        BLS_PROFILE_SCOPE("render_frame_forward");
 
-        auto &window = Game::get().get_window();
         auto &renderer = Game::get().get_renderer();
 
-        auto width = window.get_width();
-        auto height = window.get_height();
+        auto width = packet.width;
+        auto height = packet.height;
+        auto render_width = packet.render_width;
+        auto render_height = packet.render_height;
 
-        auto camera = ecs.cameras.begin()->second.get();
-        auto position = camera->position;
-        auto projection = camera->projection_matrix;
-        auto view = camera->view_matrix;
-        auto near = camera->near;
-        auto far = camera->far;
+        const auto &camera = packet.camera;
+        auto projection = camera.projection_matrix;
+        auto view = camera.view_matrix;
 
         auto &shaders = renderer.get_shaders();
         auto &skybox = renderer.get_skybox();
@@ -35,105 +34,95 @@ namespace bls
         // Shaders - by now they should have been initialized
         auto pbr_shader = shaders["f_pbr"].get();
 
+        // Camera and frame constants, read by every shader
+        set_frame_uniforms(packet);
+
         // Reset the viewport
         renderer.clear_color({0.0f, 0.0f, 0.0f, 1.0f});
         renderer.clear();
         renderer.set_viewport(0, 0, width, height);
 
+        auto &graph = get_render_graph();
+        graph.reset(width, height);
+
         // Render shadow map
-        if (shadow_map)
-        {
-            shadow_map->bind(*camera);
-            render_scene(ecs, shadow_map->get_shadow_depth_shader(), renderer);
-            shadow_map->unbind();
-
-            // Reset the viewport
-            renderer.clear_color({0.0f, 0.0f, 0.0f, 1.0f});
-            renderer.clear();
-            renderer.set_viewport(0, 0, width, height);
-        }
-
-        pbr_shader->bind();
-        pbr_shader->set_uniform4("projection", projection);
-        pbr_shader->set_uniform4("view", view);
-
-        pbr_shader->set_uniform3("viewPos", position);
-        pbr_shader->set_uniform3("lightDir", shadow_map->get_light_dir());
-
-        pbr_shader->set_uniform1("near", near);
-        pbr_shader->set_uniform1("far", far);
-
-        // Set lights uniforms
-        u32 light_counter = 0;
-
-        // Point lights
-        auto &point_lights = ecs.point_lights;
-        auto &transforms = ecs.transforms;
-        for (auto &[id, light] : point_lights)
-        {
-            auto transform = transforms[id].get();
-
-            pbr_shader->set_uniform3("lights.pointLightPositions[" + to_str(light_counter) + "]", transform->position);
-            pbr_shader->set_uniform3("lights.pointLightColors[" + to_str(light_counter) + "]", light->diffuse);
-
-            light_counter++;
-        }
-
-        // Directional lights
-        light_counter = 0;
-        auto &dir_lights = ecs.dir_lights;
-        for (auto &[id, light] : dir_lights)
-        {
-            auto transform = transforms[id].get();
-
-            pbr_shader->set_uniform3("lights.dirLightDirections[" + to_str(light_counter) + "]", transform->rotation);
-            pbr_shader->set_uniform3("lights.dirLightColors[" + to_str(light_counter) + "]", light->diffuse);
-
-            light_counter++;
-        }
-
-        // Bind maps
-        if (skybox) skybox->bind(*pbr_shader, 12);               // IBL maps
-        if (shadow_map) shadow_map->bind_maps(*pbr_shader, 15);  // Shadow map
-
-        // Begin post processing
-        post_processing->begin();
-
-        // Render the scene
-        render_scene(ecs, *pbr_shader, renderer);
-
-        // Render height map
-        if (height_map)
-        {
-            if (AppConfig::tess_wireframe)
+        const auto shadow_atlas = add_shadow_pass(graph, packet);
+        const auto g_buffer =
+            graph.import_resource("g_buffer", static_cast<u64>(width) * height * G_BUFFER_BYTES_PER_PIXEL);
+
+        // Scene pass: everything is drawn lit in a transient target at the render size, the post chain writes it to
+        // the screen
+        // -------------------------------------------------------------------------------------------------------------
+        const auto scene_color =
+            graph.create_texture("scene_color", {render_width, render_height, ImageFormat::RGB8, true});
+
+        std::vector<RenderResource> scene_reads;
+        if (shadow_atlas != RENDER_RESOURCE_NONE) scene_reads.push_back(shadow_atlas);
+
+        graph.add_pass(
+            "scene",
+            scene_reads,
+            {scene_color},
+            [&](RenderGraph &)
             {
-                renderer.set_debug_mode(AppConfig::tess_wireframe);
-                height_map->render(view, projection, dt);
-                renderer.set_debug_mode(!AppConfig::tess_wireframe);
-            }
+                pbr_shader->bind();
+
+                // Set lights uniforms
+                set_light_uniforms(packet, *pbr_shader);
+
+                // Bind maps
+                if (skybox) skybox->bind(*pbr_shader, 12);               // IBL maps
+                if (shadow_map) shadow_map->bind_maps(*pbr_shader, 15);  // Shadow map
+
+                // Render the scene (only what the camera sees)
+                const auto frustum = Frustum(projection * view);
+                render_scene(packet, *pbr_shader, renderer, &frustum);
+
+                // Render height map
+                if (height_map)
+                {
+                    if (AppConfig::tess_wireframe)
+                    {
+                        renderer.set_debug_mode(AppConfig::tess_wireframe);
+                        height_map->render(packet);
+                        renderer.set_debug_mode(!AppConfig::tess_wireframe);
+                    }
 
-            else
-                height_map->render(view, projection, dt);
-        }
+                    else
+                        height_map->render(packet);
+                }
 
-        // Render particles
-        particle_system(ecs, dt);
+                // Render particles
+                render_particles(packet);
 
-        // Draw the skybox last
-        if (skybox) skybox->draw(view, projection);
+                // Draw the skybox last
+                if (skybox) skybox->draw();
 
-        // Draw UI
-        render_ui();
+                // Draw UI
+                render_ui(packet, render_width, render_height);
 
-        // Render texts
-        render_texts(ecs);
+                // Render texts
+                render_texts(packet, render_width, render_height);
 
-        // Render debug lines
+                // Render debug lines
 #if !defined(_RELEASE)
-        if (AppConfig::render_colliders) render_colliders(ecs, projection, view);
+                if (packet.render_colliders) render_colliders(packet, render_width, render_height);
 #endif
+            });
+
+        // Post processing
+        post_processing->add_to_graph(graph, scene_color, graph.get_backbuffer(), g_buffer);
+
+        execute_render_graph(graph);
+    }
+
+    void render_system_forward(ECS &ecs, f32 dt)
+    {
+        BLS_PROFILE_SCOPE("render_system_forward");
 
-        // End post processing
-        post_processing->end();
+        // Snapshot the frame, it is drawn on the render thread (when running) while the next one is simulated
+        auto &render_thread = RenderThread::get();
+        extract_frame(ecs, dt, render_thread.get_packet());
+        render_thread.submit(render_frame_forward);
     }
 };  // namespace bls
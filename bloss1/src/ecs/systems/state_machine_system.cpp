@@ -1,13 +1,164 @@
+#include "config.hpp"
 #include "ecs/ecs.hpp"
 #include "ecs/state_machine.hpp"
+#include "math/bounds.hpp"
+#include "renderer/model.hpp"
 #include "tools/profiler.hpp"
 
 namespace bls
 {
+    // The instances of a model share its animator, so the animator is driven once per frame, at the tier of its most
+    // important instance
+    struct AnimatorGroup
+    {
+            u32 driver;  // Entity whose state drives the animator
+            AnimationLod lod;
+            u32 interval;
+            std::vector<u32> instances;
+    };
+
+    // Reused every frame to avoid reallocating
+    std::unordered_map<const Animator *, AnimatorGroup> animator_groups;
+
+    AnimationLod select_animation_lod(ECS &ecs, u32 id, const Camera &camera, const Frustum &frustum, u32 &interval);
+    void update_animator(ECS &ecs, u32 id, StateMachine &state_machine, AnimationLod lod, u32 interval, f32 dt);
+
+    // Full before Reduced (the shorter interval first) before Frozen
+    bool is_more_important(AnimationLod lod, u32 interval, const AnimatorGroup &group)
+    {
+        if (lod != group.lod) return static_cast<u32>(lod) < static_cast<u32>(group.lod);
+        return lod == AnimationLod::Reduced && interval < group.interval;
+    }
+
     void state_machine_system(ECS &ecs, f32 dt)
     {
         BLS_PROFILE_SCOPE("state_machine_system");
 
-        for (auto &[id, state_machine] : ecs.state_machines) state_machine->state->update(ecs, id, dt);
+        const auto &lod_config = AppConfig::animation_lod_config;
+
+        // Without a camera there is nothing to measure against: update everything at full rate
+        const bool use_lod = lod_config.enabled && !ecs.cameras.empty();
+        const auto camera = use_lod ? ecs.cameras.begin()->second.get() : nullptr;
+        const auto frustum = Frustum(use_lod ? camera->projection_matrix * camera->view_matrix : mat4(1.0f));
+
+        // Group the instances by animator
+        for (auto &[animator, group] : animator_groups) group.instances.clear();
+
+        for (auto &[id, state_machine] : ecs.state_machines)
+        {
+            if (!ecs.models.count(id) || !ecs.models[id]->model->animator) continue;
+
+            u32 interval = 1;
+            const auto lod = use_lod ? select_animation_lod(ecs, id, *camera, frustum, interval) : AnimationLod::Full;
+
+            auto &group = animator_groups[ecs.models[id]->model->animator.get()];
+            if (group.instances.empty() || is_more_important(lod, interval, group))
+            {
+                group.driver = id;
+                group.lod = lod;
+                group.interval = interval;
+            }
+
+            group.instances.push_back(id);
+        }
+
+        for (auto it = animator_groups.begin(); it != animator_groups.end();)
+        {
+            auto &group = it->second;
+
+            // The model is gone
+            if (group.instances.empty())
+            {
+                it = animator_groups.erase(it);
+                continue;
+            }
+
+            auto &driver = *ecs.state_machines[group.driver];
+            update_animator(ecs, group.driver, driver, group.lod, group.interval, dt);
+
+            // The other instances show the same pose. Their bookkeeping follows, so any of them can drive next frame
+            for (u32 id : group.instances)
+            {
+                auto &state_machine = *ecs.state_machines[id];
+                state_machine.lod = driver.lod;
+                state_machine.frames_since_update = driver.frames_since_update;
+                state_machine.accumulated_dt = driver.accumulated_dt;
+            }
+
+            ++it;
+        }
+    }
+
+    void update_animator(ECS &ecs, u32 id, StateMachine &state_machine, AnimationLod lod, u32 interval, f32 dt)
+    {
+        auto &state = state_machine.state;
+        bool lod_changed = lod != state_machine.lod;
+
+        state_machine.lod = lod;
+        state_machine.accumulated_dt += dt;
+
+        switch (lod)
+        {
+            // Keep the time running so the pose is correct once the entity is back on screen
+            case AnimationLod::Frozen:
+                AppStats::animations_skipped++;
+                break;
+
+            case AnimationLod::Full:
+                state->update(ecs, id, state_machine.accumulated_dt);
+                state_machine.accumulated_dt = 0.0f;
+                state_machine.frames_since_update = 0;
+                AppStats::animations_updated++;
+                break;
+
+            // Sample a new key pose every 'interval' frames and blend towards it in between
+            case AnimationLod::Reduced:
+                if (lod_changed || state_machine.frames_since_update >= interval)
+                {
+                    state->update_keyed(ecs, id, state_machine.accumulated_dt);
+                    state_machine.accumulated_dt = 0.0f;
+                    state_machine.frames_since_update = 0;
+                    AppStats::animations_updated++;
+                }
+
+                else
+                    AppStats::animations_skipped++;
+
+                state_machine.frames_since_update++;
+                state->interpolate(ecs, id, static_cast<f32>(state_machine.frames_since_update) / interval);
+                break;
+        }
+    }
+
+    AnimationLod select_animation_lod(ECS &ecs, u32 id, const Camera &camera, const Frustum &frustum, u32 &interval)
+    {
+        const auto &lod_config = AppConfig::animation_lod_config;
+
+        interval = 1;
+        if (!ecs.models.count(id) || !ecs.transforms.count(id)) return AnimationLod::Full;
+
+        // Rotation independent world bounds: offset the center by the scaled local center
+        const auto &bounds = ecs.models[id]->model->bounds;
+        const auto transform = ecs.transforms[id].get();
+        const f32 max_scale = max(transform->scale.x, max(transform->scale.y, transform->scale.z));
+
+        BoundingSphere world_bounds;
+        world_bounds.center = transform->position;
+        world_bounds.radius = (glm::length(bounds.center) + bounds.radius) * max_scale;
+
+        if (!frustum.intersects(world_bounds))
+        {
+            interval = 0;
+            return AnimationLod::Frozen;
+        }
+
+        const f32 dist = max(distance(camera.position, world_bounds.center) - world_bounds.radius, 0.0f);
+        if (dist <= lod_config.full_rate_distance) return AnimationLod::Full;
+
+        interval = dist <= lod_config.reduced_rate_distance ? lod_config.reduced_rate_interval
+                                                            : lod_config.far_rate_interval;
+        interval = std::max(interval, 1U);
+
+        return AnimationLod::Reduced;
     }
 };  // namespace bls
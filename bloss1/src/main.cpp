@@ -2,11 +2,34 @@
 
 using namespace bls;
 
-int main()
+int main(int argc, char **argv)
 {
     try
     {
+        // --headless: no window and no GPU work (null renderer), e.g. to profile the cpu side on a CI machine
+        // --frames <count>: quit after 'count' frames
+        // --render-thread: draw on a dedicated thread (not available with the editor)
+        u32 max_frames = 0;
+        bool render_thread = false;
+        for (i32 i = 1; i < argc; i++)
+        {
+            const str arg = argv[i];
+            if (arg == "--headless")
+                Renderer::set_backend(RendererBackend::Null);
+
+            else if (arg == "--frames" && i + 1 < argc)
+                max_frames = std::stoul(argv[++i]);
+
+            else if (arg == "--render-thread")
+                render_thread = true;
+
+            else
+                std::cerr << "unknown argument: " << arg << "\n";
+        }
+
         Game game = Game("Bloss1", 1920, 1080);
+        game.set_max_frames(max_frames);
+        game.set_render_thread(render_thread);
         game.run();
     }
 
@@ -4,13 +4,17 @@ namespace bls
 {
     void FontManager::load(const str &name, std::shared_ptr<Font> font)
     {
+        std::lock_guard lock(mutex);
         fonts[name] = font;
     }
 
     std::shared_ptr<Font> FontManager::get_font(const str &name)
     {
-        if (exists(name))
-            return fonts[name];
+        std::lock_guard lock(mutex);
+
+        auto it = fonts.find(name);
+        if (it != fonts.end())
+            return it->second;
 
         else
             throw std::runtime_error("font '" + name + "' doesn't exist");
@@ -18,6 +22,7 @@ namespace bls
 
     bool FontManager::exists(const str &name)
     {
+        std::lock_guard lock(mutex);
         return fonts.count(name) > 0;
     }
 
@@ -22,5 +22,6 @@ namespace bls
             ~FontManager(){};
 
             std::map<str, std::shared_ptr<Font>> fonts;
+            std::mutex mutex;  // Resources are also created on the render thread
     };
 };  // namespace bls
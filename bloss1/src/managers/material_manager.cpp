@@ -0,0 +1,34 @@
+#include "managers/material_manager.hpp"
+
+namespace bls
+{
+    void MaterialManager::load(const str &name, std::shared_ptr<Material> material)
+    {
+        std::lock_guard lock(mutex);
+        materials[name] = material;
+    }
+
+    std::shared_ptr<Material> MaterialManager::get_material(const str &name)
+    {
+        std::lock_guard lock(mutex);
+
+        auto it = materials.find(name);
+        if (it != materials.end())
+            return it->second;
+
+        else
+            throw std::runtime_error("material '" + name + "' doesn't exist");
+    }
+
+    bool MaterialManager::exists(const str &name)
+    {
+        std::lock_guard lock(mutex);
+        return materials.count(name) > 0;
+    }
+
+    MaterialManager &MaterialManager::get()
+    {
+        static MaterialManager instance;
+        return instance;
+    }
+};  // namespace bls
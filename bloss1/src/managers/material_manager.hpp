@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * @brief Creates, loads and deletes materials.
+ */
+
+#include "renderer/material.hpp"
+
+namespace bls
+{
+    class MaterialManager
+    {
+        public:
+            void load(const str &name, std::shared_ptr<Material> material);
+            std::shared_ptr<Material> get_material(const str &name);
+            bool exists(const str &name);
+
+            static MaterialManager &get();
+
+        private:
+            MaterialManager()
+            {
+            }
+            ~MaterialManager()
+            {
+            }
+
+            std::map<str, std::shared_ptr<Material>> materials;
+            std::mutex mutex;  // Resources are also created on the render thread
+    };
+};  // namespace bls
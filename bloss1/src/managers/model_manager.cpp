@@ -4,13 +4,17 @@ namespace bls
 {
     void ModelManager::load(const str &name, std::shared_ptr<Model> model)
     {
+        std::lock_guard lock(mutex);
         models[name] = model;
     }
 
     std::shared_ptr<Model> ModelManager::get_model(const str &name)
     {
-        if (exists(name))
-            return models[name];
+        std::lock_guard lock(mutex);
+
+        auto it = models.find(name);
+        if (it != models.end())
+            return it->second;
 
         else
             throw std::runtime_error("model '" + name + "' doesn't exist");
@@ -18,6 +22,7 @@ namespace bls
 
     bool ModelManager::exists(const str &name)
     {
+        std::lock_guard lock(mutex);
         return models.count(name) > 0;
     }
 
@@ -26,5 +26,6 @@ namespace bls
             }
 
             std::map<str, std::shared_ptr<Model>> models;
+            std::mutex mutex;  // Resources are also created on the render thread
     };
 };  // namespace bls
@@ -6,13 +6,17 @@ namespace bls
 {
     void ShaderManager::load(const str &name, std::shared_ptr<Shader> shader)
     {
+        std::lock_guard lock(mutex);
         shaders[name] = shader;
     }
 
     std::shared_ptr<Shader> ShaderManager::get_shader(const str &name)
     {
-        if (exists(name))
-            return shaders[name];
+        std::lock_guard lock(mutex);
+
+        auto it = shaders.find(name);
+        if (it != shaders.end())
+            return it->second;
 
         else
             throw std::runtime_error("shader '" + name + "' doesn't exist");
@@ -20,6 +24,7 @@ namespace bls
 
     bool ShaderManager::exists(const str &name)
     {
+        std::lock_guard lock(mutex);
         return shaders.count(name) > 0;
     }
 
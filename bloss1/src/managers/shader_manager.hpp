@@ -26,5 +26,6 @@ namespace bls
             }
 
             std::map<str, std::shared_ptr<Shader>> shaders;
+            std::mutex mutex;  // Resources are also created on the render thread
     };
 };  // namespace bls
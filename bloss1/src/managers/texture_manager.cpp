@@ -6,13 +6,17 @@ namespace bls
 {
     void TextureManager::load(const str &name, std::shared_ptr<Texture> texture)
     {
+        std::lock_guard lock(mutex);
         textures[name] = texture;
     }
 
     std::shared_ptr<Texture> TextureManager::get_texture(const str &name)
     {
-        if (exists(name))
-            return textures[name];
+        std::lock_guard lock(mutex);
+
+        auto it = textures.find(name);
+        if (it != textures.end())
+            return it->second;
 
         else
             throw std::runtime_error("texture '" + name + "' doesn't exist");
@@ -20,6 +24,7 @@ namespace bls
 
     bool TextureManager::exists(const str &name)
     {
+        std::lock_guard lock(mutex);
         return textures.count(name) > 0;
     }
 
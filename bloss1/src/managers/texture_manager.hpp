@@ -22,5 +22,6 @@ namespace bls
             ~TextureManager(){};
 
             std::map<str, std::shared_ptr<Texture>> textures;
+            std::mutex mutex;  // Resources are also created on the render thread
     };
 };  // namespace bls
@@ -0,0 +1,58 @@
+#include "math/bounds.hpp"
+
+#include <emmintrin.h>  // SSE2, part of every x86_64 target
+
+namespace bls
+{
+    void Frustum::cull(const BoundingSphereBatch &batch, std::vector<u8> &visible) const
+    {
+        const u32 count = batch.size();
+        const f32 *x = batch.x.data();
+        const f32 *y = batch.y.data();
+        const f32 *z = batch.z.data();
+        const f32 *radius = batch.radius.data();
+
+        visible.resize(count);
+        u8 *result = visible.data();
+
+        // Plane coefficients in every lane
+        __m128 plane_x[6], plane_y[6], plane_z[6], plane_w[6];
+        for (u32 p = 0; p < 6; p++)
+        {
+            plane_x[p] = _mm_set1_ps(planes[p].x);
+            plane_y[p] = _mm_set1_ps(planes[p].y);
+            plane_z[p] = _mm_set1_ps(planes[p].z);
+            plane_w[p] = _mm_set1_ps(planes[p].w);
+        }
+
+        // A sphere is visible unless it is entirely behind one of the planes
+        u32 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 center_x = _mm_loadu_ps(x + i);
+            const __m128 center_y = _mm_loadu_ps(y + i);
+            const __m128 center_z = _mm_loadu_ps(z + i);
+            const __m128 min_distance = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (u32 p = 0; p < 6; p++)
+            {
+                __m128 distance = _mm_mul_ps(plane_x[p], center_x);
+                distance = _mm_add_ps(distance, _mm_mul_ps(plane_y[p], center_y));
+                distance = _mm_add_ps(distance, _mm_mul_ps(plane_z[p], center_z));
+                distance = _mm_add_ps(distance, plane_w[p]);
+
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, min_distance));
+            }
+
+            const i32 mask = _mm_movemask_ps(inside);
+            result[i + 0] = static_cast<u8>(mask & 1);
+            result[i + 1] = static_cast<u8>((mask >> 1) & 1);
+            result[i + 2] = static_cast<u8>((mask >> 2) & 1);
+            result[i + 3] = static_cast<u8>((mask >> 3) & 1);
+        }
+
+        // The last spheres
+        for (; i < count; i++) result[i] = intersects(BoundingSphere{vec3(x[i], y[i], z[i]), radius[i]});
+    }
+};  // namespace bls
@@ -0,0 +1,169 @@
+#pragma once
+
+/**
+ * @brief Bounding volumes and a view frustum to test them against.
+ */
+
+#include "math/math.hpp"
+
+namespace bls
+{
+    struct BoundingSphere
+    {
+            vec3 center = vec3(0.0f);
+            f32 radius = 0.0f;
+
+            // The radius is scaled by the largest axis so non uniform scales stay conservative
+            BoundingSphere transformed(const mat4 &transform) const
+            {
+                const f32 scale = glm::sqrt(glm::max(glm::max(glm::dot(vec3(transform[0]), vec3(transform[0])),
+                                                              glm::dot(vec3(transform[1]), vec3(transform[1]))),
+                                                     glm::dot(vec3(transform[2]), vec3(transform[2]))));
+
+                return {vec3(transform * vec4(center, 1.0f)), radius * scale};
+            }
+    };
+
+    struct BoundingBox
+    {
+            vec3 min = vec3(std::numeric_limits<f32>::max());
+            vec3 max = vec3(std::numeric_limits<f32>::lowest());
+
+            bool is_valid() const
+            {
+                return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+            }
+
+            void expand(const vec3 &point)
+            {
+                min = glm::min(min, point);
+                max = glm::max(max, point);
+            }
+
+            void expand(const BoundingBox &box)
+            {
+                if (!box.is_valid()) return;
+
+                expand(box.min);
+                expand(box.max);
+            }
+
+            // Box that contains the 8 transformed corners
+            BoundingBox transformed(const mat4 &transform) const
+            {
+                BoundingBox box;
+                if (!is_valid()) return box;
+
+                for (u32 i = 0; i < 8; i++)
+                {
+                    const vec3 corner = vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+                    box.expand(vec3(transform * vec4(corner, 1.0f)));
+                }
+
+                return box;
+            }
+
+            BoundingSphere get_sphere() const
+            {
+                if (!is_valid()) return {};
+
+                return {(min + max) * 0.5f, glm::length(max - min) * 0.5f};
+            }
+    };
+
+    // Spheres stored as separate arrays, so the frustum test runs over contiguous floats
+    struct BoundingSphereBatch
+    {
+            std::vector<f32> x, y, z, radius;
+
+            u32 size() const
+            {
+                return static_cast<u32>(radius.size());
+            }
+
+            void clear()
+            {
+                x.clear();
+                y.clear();
+                z.clear();
+                radius.clear();
+            }
+
+            void push_back(const BoundingSphere &sphere)
+            {
+                x.push_back(sphere.center.x);
+                y.push_back(sphere.center.y);
+                z.push_back(sphere.center.z);
+                radius.push_back(sphere.radius);
+            }
+
+            // Resize first, then each slot can be written from a different thread
+            void resize(u32 count)
+            {
+                x.resize(count);
+                y.resize(count);
+                z.resize(count);
+                radius.resize(count);
+            }
+
+            void set(u32 index, const BoundingSphere &sphere)
+            {
+                x[index] = sphere.center.x;
+                y[index] = sphere.center.y;
+                z[index] = sphere.center.z;
+                radius[index] = sphere.radius;
+            }
+    };
+
+    class Frustum
+    {
+        public:
+            // Extract the planes from a view projection matrix (Gribb/Hartmann)
+            Frustum(const mat4 &view_projection)
+            {
+                for (u32 i = 0; i < 3; i++)
+                {
+                    planes[i * 2 + 0] = row(view_projection, 3) + row(view_projection, i);
+                    planes[i * 2 + 1] = row(view_projection, 3) - row(view_projection, i);
+                }
+
+                // Normalize so the plane distances are in world units
+                for (auto &plane : planes) plane /= glm::length(vec3(plane));
+            }
+
+            bool intersects(const BoundingSphere &sphere) const
+            {
+                for (const auto &plane : planes)
+                    if (dot(vec3(plane), sphere.center) + plane.w < -sphere.radius) return false;
+
+                return true;
+            }
+
+            // The corner furthest along each plane normal has to be inside
+            bool intersects(const BoundingBox &box) const
+            {
+                for (const auto &plane : planes)
+                {
+                    const vec3 corner = vec3(plane.x >= 0.0f ? box.max.x : box.min.x,
+                                             plane.y >= 0.0f ? box.max.y : box.min.y,
+                                             plane.z >= 0.0f ? box.max.z : box.min.z);
+
+                    if (dot(vec3(plane), corner) + plane.w < 0.0f) return false;
+                }
+
+                return true;
+            }
+
+            // Test every sphere of the batch, 4 at a time with SSE. 'visible' is set to 1 for the spheres that touch
+            // the frustum and 0 otherwise
+            void cull(const BoundingSphereBatch &batch, std::vector<u8> &visible) const;
+
+        private:
+            static vec4 row(const mat4 &mat, u32 index)
+            {
+                return vec4(mat[0][index], mat[1][index], mat[2][index], mat[3][index]);
+            }
+
+            vec4 planes[6];
+    };
+};  // namespace bls
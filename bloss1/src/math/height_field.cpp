@@ -0,0 +1,417 @@
+#include "math/height_field.hpp"
+
+#include <emmintrin.h>  // SSE2, part of every x86_64 target
+
+#include "core/thread_pool.hpp"
+#include "tools/profiler.hpp"
+
+#define HEIGHT_FIELD_BATCH_ROWS 16U
+
+namespace bls
+{
+    // Shader helpers, written like the GLSL so both round the same way ('mix' is glm's, x * (1 - a) + y * a)
+    // -----------------------------------------------------------------------------------------------------------------
+    static f32 fract(f32 x)
+    {
+        return x - std::floor(x);
+    }
+
+    static vec4 mod289(const vec4 &x)
+    {
+        return x - glm::floor(x * (1.0f / 289.0f)) * 289.0f;
+    }
+
+    static vec4 permute(const vec4 &x)
+    {
+        return mod289(((x * 34.0f) + 10.0f) * x);
+    }
+
+    static vec4 taylor_inv_sqrt(const vec4 &r)
+    {
+        return 1.79284291400159f - 0.85373472095314f * r;
+    }
+
+    static vec2 fade(const vec2 &t)
+    {
+        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+
+    static f32 hash(f32 x, f32 y)
+    {
+        return fract(std::sin(x * 12.9898f + y * 78.233f) * 43758.5453123f);
+    }
+
+    // Value noise of the FBM
+    static f32 value_noise(f32 x, f32 y)
+    {
+        const f32 cell_x = std::floor(x);
+        const f32 cell_y = std::floor(y);
+        const f32 fraction_x = x - cell_x;
+        const f32 fraction_y = y - cell_y;
+
+        // Four corners in 2D of a tile
+        const f32 a = hash(cell_x, cell_y);
+        const f32 b = hash(cell_x + 1.0f, cell_y);
+        const f32 c = hash(cell_x, cell_y + 1.0f);
+        const f32 d = hash(cell_x + 1.0f, cell_y + 1.0f);
+
+        const f32 u_x = fraction_x * fraction_x * (3.0f - 2.0f * fraction_x);
+        const f32 u_y = fraction_y * fraction_y * (3.0f - 2.0f * fraction_y);
+
+        return mix(a, b, u_x) + (c - a) * u_y * (1.0f - u_x) + (d - b) * u_x * u_y;
+    }
+
+    // The same helpers 4 samples at a time (SSE2, one sample per lane). The operations keep the order of the scalar
+    // ones, so Perlin noise matches them exactly
+    // -----------------------------------------------------------------------------------------------------------------
+    static __m128 floor4(__m128 x)
+    {
+        // Truncate, then step down where that rounded up (negative values). Exact while |x| < 2^31
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+    }
+
+    static __m128 fract4(__m128 x)
+    {
+        return _mm_sub_ps(x, floor4(x));
+    }
+
+    static __m128 mix4(__m128 x, __m128 y, __m128 a)
+    {
+        return _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.0f), a)), _mm_mul_ps(y, a));
+    }
+
+    static __m128 abs4(__m128 x)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+    }
+
+    static __m128 mod289_4(__m128 x)
+    {
+        const __m128 cells = floor4(_mm_mul_ps(x, _mm_set1_ps(1.0f / 289.0f)));
+        return _mm_sub_ps(x, _mm_mul_ps(cells, _mm_set1_ps(289.0f)));
+    }
+
+    static __m128 permute4(__m128 x)
+    {
+        const __m128 scaled = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(34.0f)), _mm_set1_ps(10.0f));
+        return mod289_4(_mm_mul_ps(scaled, x));
+    }
+
+    // Sine of the argument reduced to [-pi / 4, pi / 4] around the nearest multiple of pi / 2 (the pi / 2 split in
+    // three parts keeps the reduction exact for the moderate arguments of the hash) and minimax polynomials
+    static __m128 sin4(__m128 x)
+    {
+        const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977236f)));  // Nearest, 2 / pi
+        const __m128 k = _mm_cvtepi32_ps(quadrant);
+
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(1.5703125f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(4.837512969970703125e-4f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(7.54978995489188216e-8f)));
+
+        const __m128 r2 = _mm_mul_ps(r, r);
+
+        __m128 sine = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(-1.9515295891e-4f)), _mm_set1_ps(8.3321608736e-3f));
+        sine = _mm_add_ps(_mm_mul_ps(sine, r2), _mm_set1_ps(-1.6666654611e-1f));
+        sine = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sine, r2), r), r);
+
+        __m128 cosine = _mm_mul_ps(r2, _mm_set1_ps(2.443315711809948e-5f));
+        cosine = _mm_add_ps(cosine, _mm_set1_ps(-1.388731625493765e-3f));
+        cosine = _mm_add_ps(_mm_mul_ps(cosine, r2), _mm_set1_ps(4.166664568298827e-2f));
+        cosine = _mm_mul_ps(_mm_mul_ps(cosine, r2), r2);
+        cosine = _mm_add_ps(_mm_sub_ps(cosine, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+        // Odd quadrants take the cosine, the last two are negated
+        const __m128 use_cosine =
+            _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        const __m128 sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+
+        const __m128 result = _mm_or_ps(_mm_and_ps(use_cosine, cosine), _mm_andnot_ps(use_cosine, sine));
+        return _mm_xor_ps(result, sign);
+    }
+
+    static __m128 hash4(__m128 x, __m128 y)
+    {
+        const __m128 angle = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(12.9898f)), _mm_mul_ps(y, _mm_set1_ps(78.233f)));
+        return fract4(_mm_mul_ps(sin4(angle), _mm_set1_ps(43758.5453123f)));
+    }
+
+    static __m128 value_noise4(__m128 x, __m128 y)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        const __m128 cell_x = floor4(x);
+        const __m128 cell_y = floor4(y);
+        const __m128 fraction_x = _mm_sub_ps(x, cell_x);
+        const __m128 fraction_y = _mm_sub_ps(y, cell_y);
+
+        // Four corners in 2D of a tile
+        const __m128 a = hash4(cell_x, cell_y);
+        const __m128 b = hash4(_mm_add_ps(cell_x, one), cell_y);
+        const __m128 c = hash4(cell_x, _mm_add_ps(cell_y, one));
+        const __m128 d = hash4(_mm_add_ps(cell_x, one), _mm_add_ps(cell_y, one));
+
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 u_x = _mm_mul_ps(_mm_mul_ps(fraction_x, fraction_x),
+                                      _mm_sub_ps(three, _mm_mul_ps(_mm_set1_ps(2.0f), fraction_x)));
+        const __m128 u_y = _mm_mul_ps(_mm_mul_ps(fraction_y, fraction_y),
+                                      _mm_sub_ps(three, _mm_mul_ps(_mm_set1_ps(2.0f), fraction_y)));
+
+        const __m128 bottom = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(c, a), u_y), _mm_sub_ps(one, u_x));
+        const __m128 top = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(d, b), u_x), u_y);
+
+        return _mm_add_ps(_mm_add_ps(mix4(a, b, u_x), bottom), top);
+    }
+
+    // Perlin noise of one corner: gradient from the permuted corner id, normalized, dotted with the offset
+    static __m128 perlin_corner4(__m128 ix, __m128 iy, __m128 fx, __m128 fy)
+    {
+        const __m128 id = permute4(_mm_add_ps(permute4(ix), iy));
+
+        __m128 gx = _mm_sub_ps(_mm_mul_ps(fract4(_mm_mul_ps(id, _mm_set1_ps(1.0f / 41.0f))), _mm_set1_ps(2.0f)),
+                               _mm_set1_ps(1.0f));
+        const __m128 gy = _mm_sub_ps(abs4(gx), _mm_set1_ps(0.5f));
+        gx = _mm_sub_ps(gx, floor4(_mm_add_ps(gx, _mm_set1_ps(0.5f))));
+
+        const __m128 length2 = _mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy));
+        const __m128 norm =
+            _mm_sub_ps(_mm_set1_ps(1.79284291400159f), _mm_mul_ps(_mm_set1_ps(0.85373472095314f), length2));
+
+        return _mm_add_ps(_mm_mul_ps(_mm_mul_ps(gx, norm), fx), _mm_mul_ps(_mm_mul_ps(gy, norm), fy));
+    }
+
+    static __m128 perlin_noise4(__m128 x, __m128 y)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        const __m128 x0 = mod289_4(floor4(x));
+        const __m128 y0 = mod289_4(floor4(y));
+        const __m128 x1 = mod289_4(_mm_add_ps(floor4(x), one));
+        const __m128 y1 = mod289_4(_mm_add_ps(floor4(y), one));
+
+        const __m128 fx0 = fract4(x);
+        const __m128 fy0 = fract4(y);
+        const __m128 fx1 = _mm_sub_ps(fx0, one);
+        const __m128 fy1 = _mm_sub_ps(fy0, one);
+
+        const __m128 n00 = perlin_corner4(x0, y0, fx0, fy0);
+        const __m128 n10 = perlin_corner4(x1, y0, fx1, fy0);
+        const __m128 n01 = perlin_corner4(x0, y1, fx0, fy1);
+        const __m128 n11 = perlin_corner4(x1, y1, fx1, fy1);
+
+        // fade(t) = t^3 (t (6t - 15) + 10)
+        const auto fade4 = [](__m128 t)
+        {
+            const __m128 inner = _mm_add_ps(
+                _mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+            return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+        };
+
+        const __m128 fade_x = fade4(fx0);
+        const __m128 fade_y = fade4(fy0);
+        const __m128 n_xy = mix4(mix4(n00, n10, fade_x), mix4(n01, n11, fade_x), fade_y);
+
+        return _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.3f), n_xy), _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f));
+    }
+
+    HeightField::HeightField()
+    {
+        width = height = 0.0f;
+        resolution = 0;
+        noise = {};
+    }
+
+    HeightField::~HeightField()
+    {
+    }
+
+    void HeightField::bake(f32 width, f32 height, u32 resolution, const TerrainNoise &noise)
+    {
+        BLS_PROFILE_SCOPE("height_field_bake");
+
+        this->width = width;
+        this->height = height;
+        this->resolution = glm::max(resolution, 2U);
+        this->noise = noise;
+
+        const u32 samples = this->resolution;
+        std::vector<f32> u(samples);
+        for (u32 i = 0; i < samples; i++) u[i] = static_cast<f32>(i) / static_cast<f32>(samples - 1);
+
+        // The rows are independent, the bake is spread over the thread pool a batch of rows at a time
+        heights.resize(samples * samples);
+        ThreadPool::get().parallel_for(samples,
+                                       HEIGHT_FIELD_BATCH_ROWS,
+                                       [&](u32 begin, u32 end)
+                                       {
+                                           for (u32 row = begin; row < end; row++)
+                                               sample_row(noise, u.data(), u[row], &heights[row * samples], samples);
+                                       });
+    }
+
+    bool HeightField::is_baked() const
+    {
+        return !heights.empty();
+    }
+
+    const TerrainNoise &HeightField::get_noise() const
+    {
+        return noise;
+    }
+
+    f32 HeightField::get_height(f32 x, f32 z) const
+    {
+        if (!is_baked()) return 0.0f;
+
+        u32 cell_x, cell_z;
+        f32 fraction_x, fraction_z;
+        locate(x, z, cell_x, cell_z, fraction_x, fraction_z);
+
+        const f32 *row_0 = &heights[cell_z * resolution + cell_x];
+        const f32 *row_1 = row_0 + resolution;
+
+        return mix(mix(row_0[0], row_0[1], fraction_x), mix(row_1[0], row_1[1], fraction_x), fraction_z);
+    }
+
+    vec3 HeightField::get_normal(f32 x, f32 z) const
+    {
+        if (!is_baked()) return vec3(0.0f, 1.0f, 0.0f);
+
+        u32 cell_x, cell_z;
+        f32 fraction_x, fraction_z;
+        locate(x, z, cell_x, cell_z, fraction_x, fraction_z);
+
+        const f32 *row_0 = &heights[cell_z * resolution + cell_x];
+        const f32 *row_1 = row_0 + resolution;
+
+        // Slopes of the bilinear surface in the cell
+        const f32 cell_width = width / static_cast<f32>(resolution - 1);
+        const f32 cell_height = height / static_cast<f32>(resolution - 1);
+        const f32 slope_x = mix(row_0[1] - row_0[0], row_1[1] - row_1[0], fraction_z) / cell_width;
+        const f32 slope_z = mix(row_1[0] - row_0[0], row_1[1] - row_0[1], fraction_x) / cell_height;
+
+        return glm::normalize(vec3(-slope_x, 1.0f, -slope_z));
+    }
+
+    bool HeightField::contains(f32 x, f32 z) const
+    {
+        return is_baked() && glm::abs(x) <= width / 2.0f && glm::abs(z) <= height / 2.0f;
+    }
+
+    f32 HeightField::sample(const TerrainNoise &noise, const vec2 &uv)
+    {
+        if (noise.algorithm == 0)
+            return fbm(uv * noise.fbm_scale, noise.octaves) * noise.fbm_height - noise.fbm_height / 2.0f;
+
+        return perlin_noise(uv * noise.perlin_scale) * noise.perlin_height - noise.perlin_height / 2.0f;
+    }
+
+    // Classic Perlin noise (https://github.com/stegu/webgl-noise)
+    f32 HeightField::perlin_noise(const vec2 &point)
+    {
+        vec4 pi = glm::floor(vec4(point, point)) + vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        const vec4 pf = glm::fract(vec4(point, point)) - vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        pi = mod289(pi);  // To avoid truncation effects in permutation
+
+        const vec4 ix = vec4(pi.x, pi.z, pi.x, pi.z);
+        const vec4 iy = vec4(pi.y, pi.y, pi.w, pi.w);
+        const vec4 fx = vec4(pf.x, pf.z, pf.x, pf.z);
+        const vec4 fy = vec4(pf.y, pf.y, pf.w, pf.w);
+
+        const vec4 i = permute(permute(ix) + iy);
+
+        vec4 gx = glm::fract(i * (1.0f / 41.0f)) * 2.0f - 1.0f;
+        const vec4 gy = glm::abs(gx) - 0.5f;
+        const vec4 tx = glm::floor(gx + 0.5f);
+        gx = gx - tx;
+
+        vec2 g00 = vec2(gx.x, gy.x);
+        vec2 g10 = vec2(gx.y, gy.y);
+        vec2 g01 = vec2(gx.z, gy.z);
+        vec2 g11 = vec2(gx.w, gy.w);
+
+        const vec4 norm =
+            taylor_inv_sqrt(vec4(glm::dot(g00, g00), glm::dot(g01, g01), glm::dot(g10, g10), glm::dot(g11, g11)));
+        g00 *= norm.x;
+        g01 *= norm.y;
+        g10 *= norm.z;
+        g11 *= norm.w;
+
+        const f32 n00 = glm::dot(g00, vec2(fx.x, fy.x));
+        const f32 n10 = glm::dot(g10, vec2(fx.y, fy.y));
+        const f32 n01 = glm::dot(g01, vec2(fx.z, fy.z));
+        const f32 n11 = glm::dot(g11, vec2(fx.w, fy.w));
+
+        const vec2 fade_xy = fade(vec2(pf.x, pf.y));
+        const vec2 n_x = vec2(mix(n00, n10, fade_xy.x), mix(n01, n11, fade_xy.x));
+        const f32 n_xy = mix(n_x.x, n_x.y, fade_xy.y);
+
+        return (2.3f * n_xy) * 0.5f + 0.5f;
+    }
+
+    f32 HeightField::fbm(vec2 point, i32 octaves)
+    {
+        f32 value = 0.0f;
+        f32 amplitude = 0.5f;
+
+        for (i32 i = 0; i < octaves; i++)
+        {
+            value += amplitude * value_noise(point.x, point.y);
+            point *= 2.0f;
+            amplitude *= 0.5f;
+        }
+
+        return value;
+    }
+
+    void HeightField::sample_row(const TerrainNoise &noise, const f32 *u, f32 v, f32 *heights, u32 count)
+    {
+        const bool fbm_noise = noise.algorithm == 0;
+        const f32 scale = fbm_noise ? noise.fbm_scale : noise.perlin_scale;
+        const f32 amplitude = fbm_noise ? noise.fbm_height : noise.perlin_height;
+
+        const __m128 row_y = _mm_set1_ps(v * scale);
+        const __m128 height_scale = _mm_set1_ps(amplitude);
+        const __m128 height_offset = _mm_set1_ps(amplitude / 2.0f);
+
+        u32 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_mul_ps(_mm_loadu_ps(u + i), _mm_set1_ps(scale));
+            __m128 y = row_y;
+
+            __m128 value = _mm_setzero_ps();
+            if (fbm_noise)
+            {
+                __m128 octave_amplitude = _mm_set1_ps(0.5f);
+                for (i32 octave = 0; octave < noise.octaves; octave++)
+                {
+                    value = _mm_add_ps(value, _mm_mul_ps(octave_amplitude, value_noise4(x, y)));
+                    x = _mm_mul_ps(x, _mm_set1_ps(2.0f));
+                    y = _mm_mul_ps(y, _mm_set1_ps(2.0f));
+                    octave_amplitude = _mm_mul_ps(octave_amplitude, _mm_set1_ps(0.5f));
+                }
+            }
+
+            else
+                value = perlin_noise4(x, y);
+
+            _mm_storeu_ps(heights + i, _mm_sub_ps(_mm_mul_ps(value, height_scale), height_offset));
+        }
+
+        // The last samples
+        for (; i < count; i++) heights[i] = sample(noise, vec2(u[i], v));
+    }
+
+    void HeightField::locate(f32 x, f32 z, u32 &cell_x, u32 &cell_z, f32 &fraction_x, f32 &fraction_z) const
+    {
+        const f32 last = static_cast<f32>(resolution - 1);
+        const f32 grid_x = glm::clamp((x / width + 0.5f) * last, 0.0f, last);
+        const f32 grid_z = glm::clamp((z / height + 0.5f) * last, 0.0f, last);
+
+        cell_x = glm::min(static_cast<u32>(grid_x), resolution - 2);
+        cell_z = glm::min(static_cast<u32>(grid_z), resolution - 2);
+        fraction_x = grid_x - static_cast<f32>(cell_x);
+        fraction_z = grid_z - static_cast<f32>(cell_z);
+    }
+};  // namespace bls
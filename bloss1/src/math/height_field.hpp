@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @brief CPU copy of the terrain displaced by the height map shaders, for physics and gameplay. The noise functions
+ * are ports of the ones in height_map.tes.glsl and a grid of heights is baked from them when the noise changes, so
+ * a height or normal query is a bilinear lookup. The GPU (and the baked grid) evaluate 'sin' with less precision
+ * than the CPU 'std::sin', so the value noise hash can differ slightly between them. The scroll of the height map
+ * (displacement multiplier) is a render effect and is not followed.
+ */
+
+#include "math/math.hpp"
+
+#define HEIGHT_FIELD_RESOLUTION 513U  // Samples per side
+
+namespace bls
+{
+    // Noise parameters of the terrain (see HeightMap)
+    struct TerrainNoise
+    {
+            u32 algorithm;  // 0: FBM, else Perlin
+            i32 octaves;
+            f32 fbm_scale, fbm_height;
+            f32 perlin_scale, perlin_height;
+
+            bool operator==(const TerrainNoise &other) const
+            {
+                return algorithm == other.algorithm && octaves == other.octaves && fbm_scale == other.fbm_scale &&
+                       fbm_height == other.fbm_height && perlin_scale == other.perlin_scale &&
+                       perlin_height == other.perlin_height;
+            }
+    };
+
+    class HeightField
+    {
+        public:
+            HeightField();
+            ~HeightField();
+
+            // Sample the terrain of a width x height map centered on the origin in a resolution x resolution grid
+            void bake(f32 width, f32 height, u32 resolution, const TerrainNoise &noise);
+            bool is_baked() const;
+            const TerrainNoise &get_noise() const;
+
+            // Bilinear height and the normal of the bilinear surface at a position in the map plane (x, z). Positions
+            // outside the map are clamped to its border
+            f32 get_height(f32 x, f32 z) const;
+            vec3 get_normal(f32 x, f32 z) const;
+            bool contains(f32 x, f32 z) const;
+
+            // Exact terrain height at a map coordinate uv in [0, 1] (no grid)
+            static f32 sample(const TerrainNoise &noise, const vec2 &uv);
+
+            // The shader noise functions
+            static f32 perlin_noise(const vec2 &point);
+            static f32 fbm(vec2 point, i32 octaves);
+
+        private:
+            // Heights of a row of 'count' samples at the map coordinates (u[i], v), 4 at a time with SSE (one sample
+            // per lane). The value noise hash uses a polynomial 'sin', as precise as the GPU one but not the CPU one
+            static void sample_row(const TerrainNoise &noise, const f32 *u, f32 v, f32 *heights, u32 count);
+
+            // Grid cell and position in the cell of a point of the map plane
+            void locate(f32 x, f32 z, u32 &cell_x, u32 &cell_z, f32 &fraction_x, f32 &fraction_z) const;
+
+            f32 width, height;
+            u32 resolution;
+            TerrainNoise noise;
+            std::vector<f32> heights;  // Row major, z rows of x samples
+    };
+};  // namespace bls
@@ -5,17 +5,22 @@
  * @brief The famous pre-compiled headers.
  */
 
+#include <atomic>   // Atomics
 #include <cassert>  // Asserts
 #include <chrono>   // Sleeep
+#include <condition_variable>  // Worker wake ups
 #include <cstdint>  // Primitive types
+#include <cstring>  // Memcmp
 #include <ctime>
 #include <filesystem>  // File handling
 #include <fstream>     // Fstream
 #include <functional>  // Function type
 #include <iomanip>
 #include <iostream>  // Good ol' cout
+#include <limits>    // Numeric limits
 #include <map>       // Maps
 #include <memory>    // Unique ptr
+#include <mutex>     // Locks
 #include <queue>     // Deletion queue
 #include <random>    // RNG
 #include <set>       // Yes
@@ -23,6 +28,7 @@
 #include <stack>     // Stack data structure
 #include <string>    // Strings!
 #include <thread>    // Threads + sleep
+#include <unordered_map>  // Hash tables
 #include <vector>    // Vec vec vec
 
 #endif  // PCH_HPP
@@ -137,13 +137,25 @@ namespace bls
 
     void GlfwWindow::update()
     {
-        // Poll events
+        poll_events();
+        swap_buffers();
+    }
+
+    void GlfwWindow::poll_events()
+    {
         glfwPollEvents();
+    }
 
-        // Swap buffers
+    void GlfwWindow::swap_buffers()
+    {
         glfwSwapBuffers(native_window);
     }
 
+    void GlfwWindow::set_context_current(bool current)
+    {
+        glfwMakeContextCurrent(current ? native_window : nullptr);
+    }
+
     void GlfwWindow::sleep(f64 seconds)
     {
         std::this_thread::sleep_for(std::chrono::microseconds(static_cast<i64>(seconds * 1'000'000)));
@@ -18,6 +18,9 @@ namespace bls
             ~GlfwWindow();
 
             void update() override;
+            void poll_events() override;
+            void swap_buffers() override;
+            void set_context_current(bool current) override;
             void sleep(f64 seconds) override;
 
             void set_event_callback(const EventCallback &callback) override;
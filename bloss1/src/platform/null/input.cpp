@@ -0,0 +1,42 @@
+#include "platform/null/input.hpp"
+
+namespace bls
+{
+    bool NullInput::is_key_pressed_native(i32)
+    {
+        return false;
+    }
+
+    bool NullInput::is_mouse_button_pressed_native(i32)
+    {
+        return false;
+    }
+
+    bool NullInput::is_joystick_button_pressed_native(i32, i32)
+    {
+        return false;
+    }
+
+    f32 NullInput::get_joystick_axis_value_native(i32, i32 axis)
+    {
+        // Same resting values as a connected gamepad
+        if (axis == GAMEPAD_AXIS_LEFT_TRIGGER || axis == GAMEPAD_AXIS_RIGHT_TRIGGER) return -1.0f;
+
+        return 0.0f;
+    }
+
+    std::pair<f32, f32> NullInput::get_mouse_position_native()
+    {
+        return {0.0f, 0.0f};
+    }
+
+    f32 NullInput::get_mouse_x_native()
+    {
+        return 0.0f;
+    }
+
+    f32 NullInput::get_mouse_y_native()
+    {
+        return 0.0f;
+    }
+};  // namespace bls
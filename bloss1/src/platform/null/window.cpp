@@ -0,0 +1,68 @@
+#include "platform/null/window.hpp"
+
+#include "renderer/null/renderer.hpp"
+
+namespace bls
+{
+    NullWindow::NullWindow(const str &title, const u32 &width, const u32 &height)
+    {
+        this->title = title;
+        this->width = width;
+        this->height = height;
+        this->start_time = std::chrono::steady_clock::now();
+    }
+
+    NullWindow::~NullWindow()
+    {
+    }
+
+    void NullWindow::update()
+    {
+        poll_events();
+        swap_buffers();
+    }
+
+    void NullWindow::poll_events()
+    {
+    }
+
+    void NullWindow::swap_buffers()
+    {
+        // Nothing to present, the frame is done
+        NullRenderer::stats.frames++;
+    }
+
+    void NullWindow::set_context_current(bool)
+    {
+    }
+
+    void NullWindow::sleep(f64 seconds)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<i64>(seconds * 1'000'000)));
+    }
+
+    void NullWindow::set_event_callback(const EventCallback &callback)
+    {
+        event_callback = callback;
+    }
+
+    u32 NullWindow::get_width() const
+    {
+        return width;
+    }
+
+    u32 NullWindow::get_height() const
+    {
+        return height;
+    }
+
+    f64 NullWindow::get_time() const
+    {
+        return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    void *NullWindow::get_native_window() const
+    {
+        return nullptr;
+    }
+};  // namespace bls
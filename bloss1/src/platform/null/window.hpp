@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * @brief A window that is never shown. Used with the null renderer to run the game loop without a display.
+ */
+
+#include "core/window.hpp"
+
+namespace bls
+{
+    class NullWindow : public Window
+    {
+        public:
+            NullWindow(const str &title, const u32 &width, const u32 &height);
+            ~NullWindow();
+
+            void update() override;
+            void poll_events() override;
+            void swap_buffers() override;
+            void set_context_current(bool current) override;
+            void sleep(f64 seconds) override;
+
+            void set_event_callback(const EventCallback &callback) override;
+
+            u32 get_width() const override;
+            u32 get_height() const override;
+
+            f64 get_time() const override;
+            void *get_native_window() const override;
+
+        private:
+            str title;
+            u32 width, height;
+            EventCallback event_callback;
+            std::chrono::steady_clock::time_point start_time;
+    };
+};  // namespace bls
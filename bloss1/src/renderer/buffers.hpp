@@ -21,6 +21,16 @@ namespace bls
         Depth
     };
 
+    // Layout expected by the indirect draws
+    struct DrawIndirectCommand
+    {
+            u32 count;
+            u32 instance_count;
+            u32 first_index;
+            i32 base_vertex;
+            u32 base_instance;
+    };
+
     class VertexBuffer
     {
         public:
@@ -29,7 +39,14 @@ namespace bls
             virtual void bind() = 0;
             virtual void unbind() = 0;
 
+            // Replace the contents (the storage grows if needed)
+            virtual void set_data(const void *data, u32 size) = 0;
+
+            // Write 'size' bytes at 'offset', inside the current storage
+            virtual void set_sub_data(const void *data, u32 offset, u32 size) = 0;
+
             static VertexBuffer *create(void *vertices, u32 size);
+            static VertexBuffer *create(u32 size);  // Streamed every frame
     };
 
     class IndexBuffer
@@ -41,9 +58,62 @@ namespace bls
             virtual void unbind() = 0;
             virtual u32 get_count() = 0;
 
+            // Replace the contents (the storage grows if needed)
+            virtual void set_data(const u32 *indices, u32 count) = 0;
+
+            // Write 'count' indices from index 'offset', inside the current storage
+            virtual void set_sub_data(const u32 *indices, u32 offset, u32 count) = 0;
+
             static IndexBuffer *create(const std::vector<u32> &indices, u32 count);
     };
 
+    // Shader storage buffer, read in the shaders through a binding point
+    class StorageBuffer
+    {
+        public:
+            virtual ~StorageBuffer(){};
+
+            virtual void bind() = 0;
+            virtual void unbind() = 0;
+            virtual void bind_base(u32 binding) = 0;
+
+            // Replace the contents (the storage grows if needed)
+            virtual void set_data(const void *data, u32 size) = 0;
+
+            static StorageBuffer *create(u32 size);  // Streamed every frame
+    };
+
+    // Uniform buffer (std140 block), read in the shaders through a binding point
+    class UniformBuffer
+    {
+        public:
+            virtual ~UniformBuffer(){};
+
+            virtual void bind() = 0;
+            virtual void unbind() = 0;
+            virtual void bind_base(u32 binding) = 0;
+
+            // Replace the contents (the storage grows if needed)
+            virtual void set_data(const void *data, u32 size) = 0;
+
+            static UniformBuffer *create(u32 size);  // Streamed every frame
+    };
+
+    // Holds the DrawIndirectCommands of the indirect draws
+    class IndirectBuffer
+    {
+        public:
+            virtual ~IndirectBuffer(){};
+
+            virtual void bind() = 0;
+            virtual void unbind() = 0;
+
+            // Replace the contents (the storage grows if needed)
+            virtual void set_data(const void *data, u32 size) = 0;
+
+            static IndirectBuffer *create(u32 size);  // Streamed every frame
+    };
+
     class FrameBuffer
     {
         public:
@@ -53,9 +123,10 @@ namespace bls
             virtual void bind_read() = 0;
             virtual void bind_draw() = 0;
             virtual void unbind() = 0;
-            virtual void blit(u32 width, u32 height) = 0;
-            virtual void bind_and_blit(u32 width, u32 height) = 0;
+            virtual void blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height) = 0;  // Depth only
+            virtual void bind_and_blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height) = 0;
             virtual void attach_texture(Texture *texture) = 0;
+            virtual void attach_depth_texture(Texture *texture) = 0;  // Not one of the color attachments
             virtual void draw() = 0;
             virtual bool check() = 0;
             virtual std::vector<Texture *> &get_attachments() = 0;
@@ -88,6 +159,10 @@ namespace bls
             virtual void add_vertex_buffer(
                 u32 index, i32 size, ShaderDataType type, bool normalized, i32 stride, void *pointer) = 0;
 
+            // Same as above, but the attribute advances once per instance
+            virtual void add_instance_buffer(
+                u32 index, i32 size, ShaderDataType type, bool normalized, i32 stride, void *pointer) = 0;
+
             static VertexArray *create();
     };
 };  // namespace bls
@@ -0,0 +1,63 @@
+#include "renderer/dynamic_resolution.hpp"
+
+#include "config.hpp"
+#include "math/math.hpp"
+
+namespace bls
+{
+    DynamicResolution::DynamicResolution()
+    {
+        scale = 1.0f;
+        average_ms = 0.0f;
+        frames_since_change = 0;
+    }
+
+    DynamicResolution::~DynamicResolution()
+    {
+    }
+
+    f32 DynamicResolution::update(f32 frame_ms)
+    {
+        const auto &config = AppConfig::dynamic_resolution_config;
+        if (!config.enabled)
+        {
+            scale = 1.0f;
+            return scale;
+        }
+
+        const auto quantize = [&config](f32 value)
+        {
+            const f32 snapped = std::round(value / config.scale_step) * config.scale_step;
+            return glm::clamp(snapped, config.min_scale, config.max_scale);
+        };
+
+        if (frame_ms <= 0.0f) return scale = quantize(scale);
+
+        average_ms = average_ms > 0.0f ? average_ms + (frame_ms - average_ms) * DYNAMIC_RESOLUTION_SMOOTHING : frame_ms;
+        if (++frames_since_change < config.cooldown_frames) return scale = quantize(scale);
+
+        // The frame cost follows the pixel count, so the scale that fits the budget goes with the square root
+        f32 next = scale;
+        if (average_ms > config.target_ms)
+            next = min(scale - config.scale_step, scale * std::sqrt(config.target_ms / average_ms));
+
+        else if (average_ms < config.target_ms * DYNAMIC_RESOLUTION_HEADROOM)
+            next = scale + config.scale_step;
+
+        next = quantize(next);
+        if (next != scale)
+        {
+            // Expected time at the new scale, until the new frames come in
+            average_ms *= (next * next) / (scale * scale);
+            scale = next;
+            frames_since_change = 0;
+        }
+
+        return scale;
+    }
+
+    f32 DynamicResolution::get_scale() const
+    {
+        return scale;
+    }
+};  // namespace bls
@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * @brief Picks the internal render resolution from the frame time. The scene and the post chain are drawn at
+ * 'scale' times the window size and the last pass upscales to the window: when the frames go over the budget the
+ * scale drops to what should fit, when there is room it climbs back one step at a time.
+ */
+
+#include "core/core.hpp"
+
+#define DYNAMIC_RESOLUTION_SMOOTHING 0.1f  // Weight of the newest frame time in the average
+#define DYNAMIC_RESOLUTION_HEADROOM 0.75f  // Scale up only under this fraction of the budget
+
+namespace bls
+{
+    class DynamicResolution
+    {
+        public:
+            DynamicResolution();
+            ~DynamicResolution();
+
+            // Feed the time of the last frame (ms, 0 when unknown) and get the scale of the next one
+            f32 update(f32 frame_ms);
+            f32 get_scale() const;
+
+        private:
+            f32 scale;
+            f32 average_ms;
+            u32 frames_since_change;
+    };
+};  // namespace bls
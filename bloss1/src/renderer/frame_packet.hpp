@@ -0,0 +1,94 @@
+#pragma once
+
+/**
+ * @brief Everything needed to draw one frame, copied out of the ECS by the main thread. Once submitted the packet
+ * is not changed anymore, so the render thread can draw it while the main thread simulates the next frame.
+ */
+
+#include "ecs/components.hpp"
+
+#define FRAME_PACKET_NO_BONES 0xFFFFFFFFU
+#define MAX_LIGHTS 16U  // Directional lights
+
+namespace bls
+{
+    class Font;
+    class Model;
+    struct FramePacket;
+
+    using RenderFunction = void (*)(const FramePacket &packet);
+
+    struct FramePacket
+    {
+            struct Entity
+            {
+                    u32 id;
+                    Model *model;  // Owned by the model manager
+                    mat4 model_matrix;
+                    u32 bone_offset;  // First of the MAX_BONE_MATRICES bone matrices, or FRAME_PACKET_NO_BONES
+                    bool is_static;
+            };
+
+            struct TextItem
+            {
+                    Font *font;  // Owned by the font manager
+                    str text;
+                    vec2 position;
+                    f32 scale;
+                    vec3 color;
+            };
+
+            struct ColliderItem
+            {
+                    bool sphere;
+                    vec3 center, size;  // The size of a sphere is its radius (x)
+                    vec3 color;
+                    vec3 origin, front;
+            };
+
+            void clear()
+            {
+                entities.clear();
+                bone_matrices.clear();
+                point_light_positions.clear();
+                point_light_colors.clear();
+                dir_light_directions.clear();
+                dir_light_colors.clear();
+                dir_light_ambients.clear();
+                dir_light_speculars.clear();
+                particles_2D.clear();
+                particles_3D.clear();
+                texts.clear();
+                colliders.clear();
+                render = nullptr;
+            }
+
+            // Viewport and camera. The scene is drawn at the render size and upscaled to the viewport
+            u32 width, height;
+            u32 render_width, render_height;
+            f32 dt;
+            Camera camera;
+
+            // Lights (at most MAX_LIGHTS directional lights). The colors are the diffuse ones, the terrain also uses
+            // the ambient and specular colors of the directional lights
+            std::vector<vec3> point_light_positions, point_light_colors;
+            std::vector<vec3> dir_light_directions, dir_light_colors;
+            std::vector<vec3> dir_light_ambients, dir_light_speculars;
+
+            // Scene. The bone matrices are copied once per animator and shared by its entities
+            std::vector<Entity> entities;
+            std::vector<mat4> bone_matrices;
+
+            // Live particles, already simulated
+            std::vector<ParticleInstance> particles_2D, particles_3D;
+
+            // UI and debug
+            std::vector<TextItem> texts;
+            std::vector<ColliderItem> colliders;
+            bool render_colliders;
+
+            // Draws the packet (forward or deferred)
+            RenderFunction render;
+            std::chrono::steady_clock::time_point frame_start;
+    };
+};  // namespace bls
@@ -0,0 +1,39 @@
+#include "renderer/frame_uniforms.hpp"
+
+#include "tools/profiler.hpp"
+
+namespace bls
+{
+    FrameUniforms::FrameUniforms()
+    {
+        data = {};
+    }
+
+    FrameUniforms::~FrameUniforms()
+    {
+    }
+
+    void FrameUniforms::update(const FramePacket &packet, const vec3 &light_dir)
+    {
+        BLS_PROFILE_SCOPE("frame_uniforms_update");
+
+        const auto &camera = packet.camera;
+
+        data.projection = camera.projection_matrix;
+        data.view = camera.view_matrix;
+        data.inverse_view_projection = glm::inverse(camera.projection_matrix * camera.view_matrix);
+        data.view_position = camera.position;
+        data.near = camera.near;
+        data.light_direction = light_dir;
+        data.far = camera.far;
+        data.viewport = vec2(packet.render_width, packet.render_height);
+        data.time += packet.dt;
+        data.dt = packet.dt;
+
+        // Created where it is written, the render thread owns the context
+        if (!buffer) buffer.reset(UniformBuffer::create(sizeof(FrameData)));
+
+        buffer->set_data(&data, sizeof(FrameData));
+        buffer->bind_base(FRAME_DATA_BINDING);
+    }
+};  // namespace bls
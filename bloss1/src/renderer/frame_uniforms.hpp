@@ -0,0 +1,46 @@
+#pragma once
+
+/**
+ * @brief Camera and frame constants shared by every shader. They are written once per frame in a std140 uniform
+ * block bound at a fixed binding point, instead of being set on each shader by name.
+ */
+
+#include "renderer/buffers.hpp"
+#include "renderer/frame_packet.hpp"
+
+// Must match the FrameData block of the shaders
+#define FRAME_DATA_BINDING 1
+
+namespace bls
+{
+    class FrameUniforms
+    {
+        public:
+            FrameUniforms();
+            ~FrameUniforms();
+
+            // Write the constants of the packet (camera and viewport) and bind the block
+            void update(const FramePacket &packet, const vec3 &light_dir);
+
+        private:
+            // Layout of the FrameData block (std140): each vec3 shares its slot with the float after it
+            struct FrameData
+            {
+                    mat4 projection;
+                    mat4 view;
+                    mat4 inverse_view_projection;  // Rebuilds world positions from the depth
+                    vec3 view_position;
+                    f32 near;
+                    vec3 light_direction;
+                    f32 far;
+                    vec2 viewport;  // Render size
+                    f32 time;
+                    f32 dt;
+            };
+
+            static_assert(sizeof(FrameData) == 240, "FrameData must follow the std140 layout");
+
+            FrameData data;
+            std::unique_ptr<UniformBuffer> buffer;
+    };
+};  // namespace bls
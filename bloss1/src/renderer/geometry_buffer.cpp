@@ -0,0 +1,187 @@
+#include "renderer/geometry_buffer.hpp"
+
+#include "renderer/model.hpp"
+#include "tools/profiler.hpp"
+
+namespace bls
+{
+    GeometryBuffer::GeometryBuffer()
+    {
+        used_vertices = used_indices = 0;
+        free_vertices = free_indices = 0;
+        vertex_capacity = index_capacity = 0;
+        draw_index_count = 0;
+    }
+
+    GeometryBuffer::~GeometryBuffer()
+    {
+    }
+
+    void GeometryBuffer::add(Mesh *mesh)
+    {
+        pending.push_back(mesh);
+    }
+
+    void GeometryBuffer::remove(Mesh *mesh)
+    {
+        auto it = std::find(pending.begin(), pending.end(), mesh);
+        if (it != pending.end())
+        {
+            pending.erase(it);
+            return;
+        }
+
+        it = std::find(meshes.begin(), meshes.end(), mesh);
+        if (it == meshes.end()) return;
+
+        // The space stays used until the buffers are rebuilt
+        meshes.erase(it);
+        free_vertices += static_cast<u32>(mesh->vertices.size());
+        free_indices += static_cast<u32>(mesh->indices.size());
+    }
+
+    void GeometryBuffer::bind()
+    {
+        if (!pending.empty())
+        {
+            BLS_PROFILE_SCOPE("geometry_buffer_upload");
+
+            u32 new_vertices = 0, new_indices = 0;
+            for (auto mesh : pending)
+            {
+                new_vertices += static_cast<u32>(mesh->vertices.size());
+                new_indices += static_cast<u32>(mesh->indices.size());
+            }
+
+            // Rebuild when the new meshes don't fit or when most of the buffers are holes, otherwise only the new
+            // meshes are written
+            const bool full = used_vertices + new_vertices > vertex_capacity ||
+                              used_indices + new_indices > index_capacity;
+            const bool fragmented = free_vertices > used_vertices / 2 || free_indices > used_indices / 2;
+
+            if (!vao || full || fragmented)
+            {
+                const u32 live_vertices = used_vertices - free_vertices + new_vertices;
+                const u32 live_indices = used_indices - free_indices + new_indices;
+
+                meshes.insert(meshes.end(), pending.begin(), pending.end());
+                rebuild(max(live_vertices * 2, GEOMETRY_MIN_VERTICES), max(live_indices * 2, GEOMETRY_MIN_INDICES));
+            }
+
+            else
+            {
+                // The element buffer binding belongs to the vertex array, so it must be bound first
+                vao->bind();
+                for (auto mesh : pending) append(mesh);
+            }
+
+            pending.clear();
+        }
+
+        if (vao) vao->bind();
+    }
+
+    void GeometryBuffer::unbind()
+    {
+        if (vao) vao->unbind();
+    }
+
+    void GeometryBuffer::reserve_draw_indices(u32 count)
+    {
+        if (count <= draw_index_count) return;
+
+        // Grow geometrically so a slowly growing scene doesn't reupload every frame
+        draw_index_count = max(count, draw_index_count * 2);
+
+        std::vector<i32> draw_indices(draw_index_count);
+        for (u32 i = 0; i < draw_index_count; i++) draw_indices[i] = static_cast<i32>(i);
+
+        // The buffer keeps its name when the storage is replaced, so it is attached only once
+        if (!draw_index_buffer)
+        {
+            draw_index_buffer.reset(VertexBuffer::create(draw_index_count * sizeof(i32)));
+            draw_index_buffer->set_data(draw_indices.data(), draw_index_count * sizeof(i32));
+
+            if (vao)
+            {
+                vao->bind();
+                attach_draw_indices();
+                vao->unbind();
+            }
+        }
+
+        else
+            draw_index_buffer->set_data(draw_indices.data(), draw_index_count * sizeof(i32));
+    }
+
+    void GeometryBuffer::append(Mesh *mesh)
+    {
+        const u32 vertex_count = static_cast<u32>(mesh->vertices.size());
+        const u32 index_count = static_cast<u32>(mesh->indices.size());
+
+        mesh->base_vertex = used_vertices;
+        mesh->first_index = used_indices;
+
+        vbo->set_sub_data(mesh->vertices.data(), used_vertices * sizeof(Vertex), vertex_count * sizeof(Vertex));
+        ebo->set_sub_data(mesh->indices.data(), used_indices, index_count);
+
+        used_vertices += vertex_count;
+        used_indices += index_count;
+        meshes.push_back(mesh);
+    }
+
+    void GeometryBuffer::rebuild(u32 vertex_count, u32 index_count)
+    {
+        vertex_capacity = vertex_count;
+        index_capacity = index_count;
+
+        // Place the meshes one after the other, the indices stay relative to each mesh (base vertex)
+        std::vector<Vertex> vertices;
+        std::vector<u32> indices;
+        vertices.reserve(vertex_capacity);
+        indices.reserve(index_capacity);
+
+        for (auto mesh : meshes)
+        {
+            mesh->base_vertex = static_cast<u32>(vertices.size());
+            mesh->first_index = static_cast<u32>(indices.size());
+
+            vertices.insert(vertices.end(), mesh->vertices.begin(), mesh->vertices.end());
+            indices.insert(indices.end(), mesh->indices.begin(), mesh->indices.end());
+        }
+
+        used_vertices = static_cast<u32>(vertices.size());
+        used_indices = static_cast<u32>(indices.size());
+        free_vertices = free_indices = 0;
+
+        // The storage is allocated at the full capacity, the next meshes are written after the last one
+        vertices.resize(vertex_capacity);
+        indices.resize(index_capacity);
+
+        if (!vao) vao.reset(VertexArray::create());
+
+        // The element buffer binding belongs to the vertex array, so it must be bound first
+        vao->bind();
+
+        vbo.reset(VertexBuffer::create(vertices.data(), vertex_capacity * sizeof(Vertex)));
+        ebo.reset(IndexBuffer::create(indices, index_capacity));
+        Mesh::set_vertex_layout(vao.get());
+
+        if (draw_index_buffer) attach_draw_indices();
+
+        vao->unbind();
+    }
+
+    void GeometryBuffer::attach_draw_indices()
+    {
+        draw_index_buffer->bind();
+        vao->add_instance_buffer(GEOMETRY_DRAW_INDEX_LOCATION, 1, ShaderDataType::Int, false, sizeof(i32), 0);
+    }
+
+    GeometryBuffer &GeometryBuffer::get()
+    {
+        // Never destroyed: meshes owned by other static objects unregister during the program exit
+        static GeometryBuffer *instance = new GeometryBuffer();
+        return *instance;
+    }
+};  // namespace bls
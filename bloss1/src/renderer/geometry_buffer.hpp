@@ -0,0 +1,58 @@
+#pragma once
+
+/**
+ * @brief Shared vertex and index buffers for every model mesh. The meshes are appended one after the other
+ * (they all use the same vertex layout), so the scene passes bind a single vertex array and submit all the
+ * draws of a state change with one indirect call. A new mesh is written after the last one, a removed mesh leaves
+ * a hole. The buffers are only rebuilt (compacted) when they are full or mostly holes, and grow geometrically.
+ */
+
+#include "renderer/buffers.hpp"
+
+#define GEOMETRY_DRAW_INDEX_LOCATION 7  // Right after the model vertex attributes
+#define GEOMETRY_MIN_VERTICES 32768U  // Smallest buffers, so the first models do not rebuild them
+#define GEOMETRY_MIN_INDICES 98304U
+
+namespace bls
+{
+    class Mesh;
+
+    class GeometryBuffer
+    {
+        public:
+            void add(Mesh *mesh);
+            void remove(Mesh *mesh);
+
+            // Upload the meshes added since the last bind and bind the shared vertex array
+            void bind();
+            void unbind();
+
+            // Instance i of a draw reads the draw index 'base_instance + i', make sure 'count' indices exist
+            void reserve_draw_indices(u32 count);
+
+            static GeometryBuffer &get();
+
+        private:
+            GeometryBuffer();
+            ~GeometryBuffer();
+
+            void append(Mesh *mesh);
+            void rebuild(u32 vertex_count, u32 index_count);  // Compact every mesh into new buffers of this size
+            void attach_draw_indices();  // Expects the vertex array to be bound
+
+            std::vector<Mesh *> meshes;   // In the buffers
+            std::vector<Mesh *> pending;  // Added since the last bind
+
+            // Used space (holes included), free space left by removed meshes and size of the buffers
+            u32 used_vertices, used_indices;
+            u32 free_vertices, free_indices;
+            u32 vertex_capacity, index_capacity;
+
+            std::unique_ptr<VertexArray> vao;
+            std::unique_ptr<VertexBuffer> vbo;
+            std::unique_ptr<IndexBuffer> ebo;
+
+            std::unique_ptr<VertexBuffer> draw_index_buffer;
+            u32 draw_index_count;
+    };
+};  // namespace bls
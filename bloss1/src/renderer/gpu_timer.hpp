@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * @brief The interface for a GPU timer: measures how long the GPU takes to run the commands issued between begin and
+ * end. The results are read a few frames later, so reading them never stalls the pipeline. Each renderer must
+ * implement the methods.
+ */
+
+#include "core/core.hpp"
+
+namespace bls
+{
+    class GpuTimer
+    {
+        public:
+            virtual ~GpuTimer(){};
+
+            virtual void begin() = 0;
+            virtual void end() = 0;
+
+            // Latest measurement that is ready, 0 before the first one or when the backend can not measure
+            virtual f32 get_elapsed_ms() = 0;
+
+            static GpuTimer *create();
+    };
+};  // namespace bls
@@ -3,15 +3,16 @@
 #include "config.hpp"
 #include "core/game.hpp"
 
+#define HEIGHT_MAP_VERTEX_SIZE (9 * sizeof(f32))  // Position, uv and the edge levels of the patch
+#define HEIGHT_MAP_INITIAL_PATCHES 256U
+
 namespace bls
 {
-    HeightMap::HeightMap(
-        u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 min_distance, f32 max_distance)
+    HeightMap::HeightMap(u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 pixels_per_edge)
     {
         this->min_tess_level = min_tess_level;
         this->max_tess_level = max_tess_level;
-        this->min_distance = min_distance;
-        this->max_distance = max_distance;
+        this->pixels_per_edge = pixels_per_edge;
 
         this->displacement = vec2(0.0f);
         this->displacement_multiplier = vec2(0.0f);
@@ -48,54 +49,29 @@ namespace bls
         texture_layers[2] = Texture::create("h_t2", "bloss1/assets/textures/rock_05_diff_2k.png", TextureType::Diffuse);
         texture_layers[3] = Texture::create("h_t3", "bloss1/assets/textures/snow_02_diff_2k.png", TextureType::Diffuse);
 
-        const f32 w = static_cast<f32>(width);
-        const f32 h = static_cast<f32>(height);
+        this->width = static_cast<f32>(width);
+        this->height = static_cast<f32>(height);
 
         num_vert_per_patch = 4;
-        num_patches = 20;
+        visible_patches = culled_nodes = 0;
 
-        // Setup vertices
-        std::vector<f32> vertices;
-        for (u32 i = 0; i < num_patches; i++)
-        {
-            for (u32 j = 0; j < num_patches; j++)
-            {
-                vertices.push_back(-w / 2.0f + w * i / static_cast<f32>(num_patches));  // v.x
-                vertices.push_back(0.0f);                                               // v.y
-                vertices.push_back(-h / 2.0f + h * j / static_cast<f32>(num_patches));  // v.z
-                vertices.push_back(i / static_cast<f32>(num_patches));                  // u
-                vertices.push_back(j / static_cast<f32>(num_patches));                  // v
-
-                vertices.push_back(-w / 2.0f + w * (i + 1) / static_cast<f32>(num_patches));  // v.x
-                vertices.push_back(0.0f);                                                     // v.y
-                vertices.push_back(-h / 2.0f + h * j / static_cast<f32>(num_patches));        // v.z
-                vertices.push_back((i + 1) / static_cast<f32>(num_patches));                  // u
-                vertices.push_back(j / static_cast<f32>(num_patches));                        // v
-
-                vertices.push_back(-w / 2.0f + w * i / static_cast<f32>(num_patches));        // v.x
-                vertices.push_back(0.0f);                                                     // v.y
-                vertices.push_back(-h / 2.0f + h * (j + 1) / static_cast<f32>(num_patches));  // v.z
-                vertices.push_back(i / static_cast<f32>(num_patches));                        // u
-                vertices.push_back((j + 1) / static_cast<f32>(num_patches));                  // v
-
-                vertices.push_back(-w / 2.0f + w * (i + 1) / static_cast<f32>(num_patches));  // v.x
-                vertices.push_back(0.0f);                                                     // v.y
-                vertices.push_back(-h / 2.0f + h * (j + 1) / static_cast<f32>(num_patches));  // v.z
-                vertices.push_back((i + 1) / static_cast<f32>(num_patches));                  // u
-                vertices.push_back((j + 1) / static_cast<f32>(num_patches));                  // v
-            }
-        }
+        camera_position = vec3(0.0f);
+        camera_near = projection_scale = split_ratio = segment_pixels = 1.0f;
+        min_height = max_height = min_level = max_level = 0.0f;
 
-        // Setup buffers
+        // Setup buffers, sized for a typical view. The buffer grows with the selection
         vao = std::unique_ptr<VertexArray>(VertexArray::create());
         vao->bind();
 
         vbo = std::unique_ptr<VertexBuffer>(
-            VertexBuffer::create(static_cast<void*>(vertices.data()), vertices.size() * sizeof(f32)));
+            VertexBuffer::create(HEIGHT_MAP_INITIAL_PATCHES * num_vert_per_patch * HEIGHT_MAP_VERTEX_SIZE));
 
-        vao->add_vertex_buffer(0, 3, ShaderDataType::Float, false, 5 * sizeof(f32), reinterpret_cast<void*>(0));
         vao->add_vertex_buffer(
-            1, 2, ShaderDataType::Float, false, 5 * sizeof(f32), reinterpret_cast<void*>((sizeof(f32) * 3)));
+            0, 3, ShaderDataType::Float, false, HEIGHT_MAP_VERTEX_SIZE, reinterpret_cast<void*>(0));
+        vao->add_vertex_buffer(
+            1, 2, ShaderDataType::Float, false, HEIGHT_MAP_VERTEX_SIZE, reinterpret_cast<void*>((sizeof(f32) * 3)));
+        vao->add_vertex_buffer(
+            2, 4, ShaderDataType::Float, false, HEIGHT_MAP_VERTEX_SIZE, reinterpret_cast<void*>((sizeof(f32) * 5)));
 
         auto& renderer = Game::get().get_renderer();
         renderer.set_tesselation_patches(num_vert_per_patch);
@@ -105,24 +81,47 @@ namespace bls
     {
     }
 
-    void HeightMap::render(const mat4& view, const mat4& projection, f32 dt)
+    void HeightMap::render(const FramePacket& packet)
     {
         auto& renderer = Game::get().get_renderer();
+        const auto& camera = packet.camera;
+
+        // Patch selection
+        // -------------------------------------------------------------------------------------------------------------
+        camera_position = camera.position;
+        camera_near = camera.near;
+        projection_scale = camera.projection_matrix[1][1] * static_cast<f32>(packet.render_height) * 0.5f;
+        segment_pixels = glm::max(pixels_per_edge, 1.0f);
+
+        // Levels are even so the finer side of a seam can take half
+        max_level = glm::max(static_cast<f32>(max_tess_level & ~1U), 2.0f);
+        min_level = glm::clamp(static_cast<f32>(min_tess_level + (min_tess_level & 1U)), 2.0f, max_level);
 
+        // A node is split while its patch would need more than the max level to keep the target segment length
+        split_ratio = glm::max(projection_scale / (max_level * segment_pixels), HEIGHT_MAP_MIN_SPLIT_RATIO);
+
+        // Height range of the displacement: the FBM is in [0, 1), the scaled Perlin noise reaches 0.5 +- 0.82
+        if (noise_algorithm == 0)
+            max_height = glm::abs(fbm_height) * 0.5f;
+
+        else
+            max_height = glm::abs(perlin_height) * 2.3f * glm::sqrt(0.5f) * 0.5f;
+
+        min_height = -max_height;
+
+        vertices.clear();
+        visible_patches = culled_nodes = 0;
+        select(0, 0, 0, Frustum(camera.projection_matrix * camera.view_matrix));
+
+        // Uniforms
+        // -------------------------------------------------------------------------------------------------------------
         shader->bind();
 
         shader->set_uniform4("model", mat4(1.0f));
-        shader->set_uniform4("view", view);
-        shader->set_uniform4("projection", projection);
 
-        displacement += vec2(dt);
+        displacement += vec2(packet.dt);
         shader->set_uniform2("displacement", displacement * displacement_multiplier);
 
-        shader->set_uniform1("min_tess_level", min_tess_level);
-        shader->set_uniform1("max_tess_level", max_tess_level);
-        shader->set_uniform1("min_distance", min_distance);
-        shader->set_uniform1("max_distance", max_distance);
-
         shader->set_uniform1("noise_algorithm", noise_algorithm);
 
         shader->set_uniform1("fbm_scale", fbm_scale);
@@ -141,23 +140,156 @@ namespace bls
             texture_layers[i]->bind(i + 4U);
         }
 
-        const auto& ecs = Game::get().get_curr_stage().ecs;
-        for (auto& [id, dir_light] : ecs->dir_lights)
+        // First directional light, from the packet (the ECS belongs to the main thread)
+        if (!packet.dir_light_directions.empty())
         {
-            auto& direction = ecs->transforms[id]->rotation;
-            shader->set_uniform3("dirLight.direction", direction);
-            shader->set_uniform3("dirLight.ambient", dir_light->ambient);
-            shader->set_uniform3("dirLight.diffuse", dir_light->diffuse);
-            shader->set_uniform3("dirLight.specular", dir_light->specular);
-
-            break;
+            shader->set_uniform3("dirLight.direction", packet.dir_light_directions[0]);
+            shader->set_uniform3("dirLight.ambient", packet.dir_light_ambients[0]);
+            shader->set_uniform3("dirLight.diffuse", packet.dir_light_colors[0]);
+            shader->set_uniform3("dirLight.specular", packet.dir_light_speculars[0]);
         }
 
-        vao->bind();
-        renderer.draw_arrays(RenderingMode::Patches, num_vert_per_patch * num_patches * num_patches);
-        vao->unbind();
+        if (visible_patches > 0)
+        {
+            vbo->set_data(vertices.data(), static_cast<u32>(vertices.size() * sizeof(f32)));
+
+            vao->bind();
+            renderer.draw_arrays(RenderingMode::Patches, num_vert_per_patch * visible_patches);
+            vao->unbind();
+        }
 
         // Not exactly right but gives a good estimate
-        AppStats::vertices += num_vert_per_patch * num_patches * num_patches;
+        AppStats::render_stats.vertices += num_vert_per_patch * visible_patches;
+    }
+
+    u32 HeightMap::get_visible_patches() const
+    {
+        return visible_patches;
+    }
+
+    u32 HeightMap::get_culled_nodes() const
+    {
+        return culled_nodes;
+    }
+
+    const HeightField& HeightMap::get_height_field()
+    {
+        const TerrainNoise noise = {noise_algorithm, fbm_octaves, fbm_scale, fbm_height, perlin_scale, perlin_height};
+
+        if (!height_field.is_baked() || !(height_field.get_noise() == noise))
+            height_field.bake(width, height, HEIGHT_FIELD_RESOLUTION, noise);
+
+        return height_field;
+    }
+
+    void HeightMap::select(u32 depth, u32 x, u32 z, const Frustum& frustum)
+    {
+        if (!frustum.intersects(get_bounds(depth, x, z)))
+        {
+            culled_nodes++;
+            return;
+        }
+
+        if (!should_split(depth, x, z))
+        {
+            add_patch(depth, x, z);
+            return;
+        }
+
+        for (u32 child = 0; child < 4; child++) select(depth + 1, x * 2 + (child & 1), z * 2 + (child >> 1), frustum);
+    }
+
+    bool HeightMap::should_split(u32 depth, u32 x, u32 z) const
+    {
+        if (depth >= HEIGHT_MAP_MAX_DEPTH) return false;
+
+        // The split distance grows with the node size, so a node always splits when a neighbour of its parent does
+        const auto box = get_bounds(depth, x, z);
+        const f32 size = glm::max(box.max.x - box.min.x, box.max.z - box.min.z);
+        const vec3 closest = glm::clamp(camera_position, box.min, box.max);
+
+        return glm::distance(camera_position, closest) < size * split_ratio;
+    }
+
+    BoundingBox HeightMap::get_bounds(u32 depth, u32 x, u32 z) const
+    {
+        // Scaling by powers of two is exact: a node and its neighbours (or parent) agree on the shared corners
+        const f32 nodes = static_cast<f32>(1U << depth);
+
+        BoundingBox box;
+        box.min = vec3(-width / 2.0f + width * x / nodes, min_height, -height / 2.0f + height * z / nodes);
+        box.max =
+            vec3(-width / 2.0f + width * (x + 1) / nodes, max_height, -height / 2.0f + height * (z + 1) / nodes);
+
+        return box;
+    }
+
+    f32 HeightMap::get_edge_level(const vec2& a, const vec2& b) const
+    {
+        // Distance to the closest height the edge can be displaced to
+        const vec2 middle = (a + b) * 0.5f;
+        const vec3 point = vec3(middle.x, glm::clamp(camera_position.y, min_height, max_height), middle.y);
+        const f32 distance = glm::max(glm::distance(camera_position, point), camera_near);
+
+        const f32 segments = glm::length(b - a) * projection_scale / (distance * segment_pixels);
+        const f32 level = glm::clamp(glm::ceil(segments), min_level, max_level);
+
+        return glm::ceil(level * 0.5f) * 2.0f;
+    }
+
+    void HeightMap::add_patch(u32 depth, u32 x, u32 z)
+    {
+        const auto box = get_bounds(depth, x, z);
+        const auto parent = depth > 0 ? get_bounds(depth - 1, x / 2, z / 2) : box;
+        const i32 nodes = 1 << depth;
+
+        // Corners in the order the control shader expects: (-x, -z), (+x, -z), (-x, +z), (+x, +z). The edges are in
+        // the order of the outer levels (u = 0, v = 0, u = 1, v = 1): -x, -z, +x, +z
+        const u32 edge_corners[4][2] = {{0, 2}, {0, 1}, {1, 3}, {2, 3}};
+        const i32 offsets[4][2] = {{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+        f32 levels[4];
+        for (u32 edge = 0; edge < 4; edge++)
+        {
+            const i32 neighbour_x = static_cast<i32>(x) + offsets[edge][0];
+            const i32 neighbour_z = static_cast<i32>(z) + offsets[edge][1];
+
+            // A neighbour in another parent that does not split is one level coarser: this edge is half of the
+            // parent edge and takes half of its level. Finer and same level neighbours compute this edge themselves
+            const bool inside = neighbour_x >= 0 && neighbour_z >= 0 && neighbour_x < nodes && neighbour_z < nodes;
+            const bool coarser =
+                inside && (neighbour_x / 2 != static_cast<i32>(x / 2) || neighbour_z / 2 != static_cast<i32>(z / 2)) &&
+                !should_split(depth - 1, static_cast<u32>(neighbour_x / 2), static_cast<u32>(neighbour_z / 2));
+
+            const auto& edge_box = coarser ? parent : box;
+            vec2 ends[2];
+            for (u32 i = 0; i < 2; i++)
+            {
+                const u32 corner = edge_corners[edge][i];
+                ends[i] = vec2(corner & 1 ? edge_box.max.x : edge_box.min.x,
+                               corner >> 1 ? edge_box.max.z : edge_box.min.z);
+            }
+
+            levels[edge] = get_edge_level(ends[0], ends[1]) * (coarser ? 0.5f : 1.0f);
+        }
+
+        for (u32 corner = 0; corner < 4; corner++)
+        {
+            const u32 corner_x = x + (corner & 1);
+            const u32 corner_z = z + (corner >> 1);
+
+            vertices.insert(vertices.end(),
+                            {corner & 1 ? box.max.x : box.min.x,
+                             0.0f,
+                             corner >> 1 ? box.max.z : box.min.z,
+                             corner_x / static_cast<f32>(nodes),
+                             corner_z / static_cast<f32>(nodes),
+                             levels[0],
+                             levels[1],
+                             levels[2],
+                             levels[3]});
+        }
+
+        visible_patches++;
     }
 };  // namespace bls
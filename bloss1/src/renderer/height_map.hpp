@@ -1,30 +1,43 @@
 #pragma once
 
 /**
- * @brief @TODO
+ * @brief Tessellated terrain displaced by noise. Each frame a quadtree over the map is walked from the camera: nodes
+ * outside the frustum are dropped and a node is split while its patch would need more than the max tessellation
+ * level to keep 'pixels_per_edge' pixels per segment. Only the visible leaves are streamed as patches, with their
+ * edge tessellation levels computed here from the projected edge length. The split distance doubles with the node
+ * size, so neighbour leaves are at most one level apart and the finer side of a seam uses half the level of the
+ * coarser edge (equal spacing), which keeps the vertices of both sides on top of each other.
  */
 
+#include "math/bounds.hpp"
+#include "math/height_field.hpp"
 #include "renderer/buffers.hpp"
+#include "renderer/frame_packet.hpp"
 #include "renderer/shader.hpp"
 #include "renderer/texture.hpp"
 
+#define HEIGHT_MAP_MAX_DEPTH 8U          // The leaves are at least 1/256 of the map
+#define HEIGHT_MAP_MIN_SPLIT_RATIO 1.5f  // Split distance / node size, over sqrt(2) so neighbours are 2:1 at most
+
 namespace bls
 {
     class HeightMap
     {
         public:
-            HeightMap(u32 width,
-                      u32 height,
-                      u32 min_tess_level = 4,
-                      u32 max_tess_level = 64,
-                      f32 min_distance = 20,
-                      f32 max_distance = 1000);
+            HeightMap(u32 width, u32 height, u32 min_tess_level = 4, u32 max_tess_level = 64, f32 pixels_per_edge = 16);
             ~HeightMap();
 
-            void render(const mat4& view, const mat4& projection, f32 dt);
+            // Select the visible patches for the packet camera and draw them
+            void render(const FramePacket &packet);
+
+            u32 get_visible_patches() const;
+            u32 get_culled_nodes() const;
+
+            // CPU copy of the terrain, baked again when the noise parameters changed. Main thread only
+            const HeightField &get_height_field();
 
             u32 min_tess_level, max_tess_level, noise_algorithm;
-            f32 min_distance, max_distance;
+            f32 pixels_per_edge;  // Target length of a tessellated segment on screen
             vec2 displacement_multiplier;
             f32 fbm_scale, fbm_height, perlin_scale, perlin_height;
             i32 fbm_octaves;
@@ -33,9 +46,25 @@ namespace bls
             bool toggle_gradient;
 
         private:
-            u32 num_vert_per_patch, num_patches;
+            // Nodes are addressed by depth and grid position (x, z) among the 2^depth x 2^depth nodes of that depth
+            void select(u32 depth, u32 x, u32 z, const Frustum &frustum);
+            bool should_split(u32 depth, u32 x, u32 z) const;
+            BoundingBox get_bounds(u32 depth, u32 x, u32 z) const;
+            f32 get_edge_level(const vec2 &a, const vec2 &b) const;
+            void add_patch(u32 depth, u32 x, u32 z);
+
+            f32 width, height;
+            u32 num_vert_per_patch, visible_patches, culled_nodes;
             vec2 displacement;
 
+            // Selection state of the current frame
+            vec3 camera_position;
+            f32 camera_near, projection_scale, split_ratio, segment_pixels;
+            f32 min_height, max_height, min_level, max_level;
+
+            std::vector<f32> vertices;  // Position, uv and the 4 edge levels, streamed every frame
+            HeightField height_field;
+
             std::shared_ptr<Shader> shader;
             std::vector<std::shared_ptr<Texture>> texture_layers;
             std::unique_ptr<VertexArray> vao;
@@ -0,0 +1,176 @@
+#include "renderer/light_clusters.hpp"
+
+#include "tools/profiler.hpp"
+
+#define LIGHT_CLUSTER_COUNT (LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z)
+
+namespace bls
+{
+    LightClusters::LightClusters()
+    {
+        bounds_projection = mat4(0.0f);
+        slice_scale = slice_bias = 0.0f;
+        tile_size = vec2(1.0f);
+    }
+
+    LightClusters::~LightClusters()
+    {
+    }
+
+    void LightClusters::update(const FramePacket &packet)
+    {
+        BLS_PROFILE_SCOPE("light_clusters_update");
+
+        const auto &camera = packet.camera;
+        if (cluster_bounds.empty() || camera.projection_matrix != bounds_projection)
+            build_cluster_bounds(camera.projection_matrix, camera.near, camera.far);
+
+        tile_size = vec2(static_cast<f32>(packet.render_width) / LIGHT_CLUSTERS_X,
+                         static_cast<f32>(packet.render_height) / LIGHT_CLUSTERS_Y);
+
+        // Pack the lights: the header (counts and directional lights) followed by the point lights
+        const u32 point_light_count = static_cast<u32>(packet.point_light_positions.size());
+        const u32 dir_light_count = static_cast<u32>(packet.dir_light_directions.size());
+
+        light_data.assign(sizeof(LightHeader) + point_light_count * sizeof(PointLight), 0);
+        auto header = reinterpret_cast<LightHeader *>(light_data.data());
+        auto point_lights = reinterpret_cast<PointLight *>(light_data.data() + sizeof(LightHeader));
+
+        header->point_light_count = point_light_count;
+        header->dir_light_count = dir_light_count;
+        for (u32 i = 0; i < dir_light_count; i++)
+        {
+            header->dir_light_directions[i] = vec4(packet.dir_light_directions[i], 0.0f);
+            header->dir_light_colors[i] = vec4(packet.dir_light_colors[i], 1.0f);
+        }
+
+        // Assign every point light to the clusters its range touches
+        assignments.clear();
+        for (u32 i = 0; i < point_light_count; i++)
+        {
+            const auto &position = packet.point_light_positions[i];
+            const auto &color = packet.point_light_colors[i];
+
+            // Inverse square falloff: the light is under the cutoff past this distance
+            const f32 intensity = glm::max(color.r, glm::max(color.g, color.b));
+            const f32 range = glm::sqrt(glm::max(intensity, 0.0f) / LIGHT_CUTOFF);
+
+            point_lights[i] = {vec4(position, range), vec4(color, 1.0f)};
+            if (range <= 0.0f) continue;
+
+            const vec3 view_position = vec3(camera.view_matrix * vec4(position, 1.0f));
+            const f32 depth = -view_position.z;
+            if (depth + range < camera.near || depth - range > camera.far) continue;
+
+            const u32 first_slice = get_slice(glm::max(depth - range, camera.near));
+            const u32 last_slice = get_slice(glm::min(depth + range, camera.far));
+
+            for (u32 z = first_slice; z <= last_slice; z++)
+            {
+                for (u32 cluster = z * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+                     cluster < (z + 1) * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+                     cluster++)
+                {
+                    // Sphere against the cluster box
+                    const auto &box = cluster_bounds[cluster];
+                    const vec3 offset = glm::clamp(view_position, box.min, box.max) - view_position;
+                    if (glm::dot(offset, offset) <= range * range) assignments.push_back({cluster, i});
+                }
+            }
+        }
+
+        // Count, then place each cluster list after the previous one
+        cluster_ranges.assign(LIGHT_CLUSTER_COUNT * 2, 0);
+        for (const auto &[cluster, light] : assignments) cluster_ranges[cluster * 2 + 1]++;
+
+        u32 offset = 0;
+        for (u32 cluster = 0; cluster < LIGHT_CLUSTER_COUNT; cluster++)
+        {
+            cluster_ranges[cluster * 2] = offset;
+            offset += cluster_ranges[cluster * 2 + 1];
+            cluster_ranges[cluster * 2 + 1] = 0;
+        }
+
+        light_indices.resize(assignments.size());
+        for (const auto &[cluster, light] : assignments)
+            light_indices[cluster_ranges[cluster * 2] + cluster_ranges[cluster * 2 + 1]++] = light;
+
+        // Upload
+        if (!light_buffer)
+        {
+            light_buffer.reset(StorageBuffer::create(sizeof(LightHeader)));
+            cluster_buffer.reset(StorageBuffer::create(LIGHT_CLUSTER_COUNT * 2 * sizeof(u32)));
+            index_buffer.reset(StorageBuffer::create(LIGHT_CLUSTER_COUNT * sizeof(u32)));
+        }
+
+        light_buffer->set_data(light_data.data(), light_data.size());
+        cluster_buffer->set_data(cluster_ranges.data(), cluster_ranges.size() * sizeof(u32));
+        index_buffer->set_data(light_indices.data(), light_indices.size() * sizeof(u32));
+    }
+
+    void LightClusters::bind(Shader &shader)
+    {
+        light_buffer->bind_base(LIGHT_DATA_BINDING);
+        cluster_buffer->bind_base(LIGHT_CLUSTER_BINDING);
+        index_buffer->bind_base(LIGHT_INDEX_BINDING);
+
+        shader.set_uniform2("clusterTileSize", tile_size);
+        shader.set_uniform1("clusterScale", slice_scale);
+        shader.set_uniform1("clusterBias", slice_bias);
+    }
+
+    void LightClusters::build_cluster_bounds(const mat4 &projection, f32 near, f32 far)
+    {
+        bounds_projection = projection;
+
+        // slice = log(depth) * scale + bias, so the slices grow with the distance like the perspective does
+        const f32 log_depth_ratio = std::log(far / near);
+        slice_scale = LIGHT_CLUSTERS_Z / log_depth_ratio;
+        slice_bias = -(LIGHT_CLUSTERS_Z * std::log(near)) / log_depth_ratio;
+
+        // Direction (z = -1) through every tile corner
+        const mat4 inverse_projection = glm::inverse(projection);
+        std::vector<vec3> corners((LIGHT_CLUSTERS_X + 1) * (LIGHT_CLUSTERS_Y + 1));
+        for (u32 y = 0; y <= LIGHT_CLUSTERS_Y; y++)
+        {
+            for (u32 x = 0; x <= LIGHT_CLUSTERS_X; x++)
+            {
+                const vec2 ndc = vec2(x, y) / vec2(LIGHT_CLUSTERS_X, LIGHT_CLUSTERS_Y) * 2.0f - 1.0f;
+                const vec4 point = inverse_projection * vec4(ndc, -1.0f, 1.0f);
+                const vec3 direction = vec3(point) / point.w;
+
+                corners[y * (LIGHT_CLUSTERS_X + 1) + x] = direction / -direction.z;
+            }
+        }
+
+        cluster_bounds.assign(LIGHT_CLUSTER_COUNT, BoundingBox());
+        for (u32 z = 0; z < LIGHT_CLUSTERS_Z; z++)
+        {
+            const f32 slice_near = near * std::pow(far / near, static_cast<f32>(z) / LIGHT_CLUSTERS_Z);
+            const f32 slice_far = near * std::pow(far / near, static_cast<f32>(z + 1) / LIGHT_CLUSTERS_Z);
+
+            for (u32 y = 0; y < LIGHT_CLUSTERS_Y; y++)
+            {
+                for (u32 x = 0; x < LIGHT_CLUSTERS_X; x++)
+                {
+                    auto &box = cluster_bounds[(z * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X + x];
+                    for (u32 corner = 0; corner < 4; corner++)
+                    {
+                        const u32 corner_x = x + (corner & 1);
+                        const u32 corner_y = y + (corner >> 1);
+                        const vec3 &direction = corners[corner_y * (LIGHT_CLUSTERS_X + 1) + corner_x];
+
+                        box.expand(direction * slice_near);
+                        box.expand(direction * slice_far);
+                    }
+                }
+            }
+        }
+    }
+
+    u32 LightClusters::get_slice(f32 depth) const
+    {
+        const f32 slice = glm::max(std::log(depth) * slice_scale + slice_bias, 0.0f);
+        return glm::min(static_cast<u32>(slice), LIGHT_CLUSTERS_Z - 1);
+    }
+};  // namespace bls
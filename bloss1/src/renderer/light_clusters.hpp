@@ -0,0 +1,68 @@
+#pragma once
+
+/**
+ * @brief Packs the frame lights in a storage buffer and assigns the point lights to clusters (froxels): the view
+ * frustum split in screen tiles and exponential depth slices. The lighting shaders find the cluster of a pixel and
+ * only shade it with the lights of that cluster, so the cost follows the lights that reach a pixel, not the total.
+ */
+
+#include "renderer/buffers.hpp"
+#include "renderer/frame_packet.hpp"
+#include "renderer/shader.hpp"
+
+// Must match the lighting shaders
+#define LIGHT_CLUSTERS_X 16U
+#define LIGHT_CLUSTERS_Y 9U
+#define LIGHT_CLUSTERS_Z 24U
+#define LIGHT_DATA_BINDING 3
+#define LIGHT_CLUSTER_BINDING 4
+#define LIGHT_INDEX_BINDING 5
+
+#define LIGHT_CUTOFF (1.0f / 256.0f)  // Radiance under which a point light is ignored, it bounds the light range
+
+namespace bls
+{
+    class LightClusters
+    {
+        public:
+            LightClusters();
+            ~LightClusters();
+
+            // Build the cluster light lists for the packet camera and upload them with the lights
+            void update(const FramePacket &packet);
+
+            // Bind the buffers and set the cluster uniforms of the (bound) shader
+            void bind(Shader &shader);
+
+        private:
+            // Layout of the LightData block (std430)
+            struct PointLight
+            {
+                    vec4 position_range;
+                    vec4 color;
+            };
+
+            struct LightHeader
+            {
+                    u32 point_light_count, dir_light_count, padding[2];
+                    vec4 dir_light_directions[MAX_LIGHTS];
+                    vec4 dir_light_colors[MAX_LIGHTS];
+            };
+
+            // View space bounds of every cluster, rebuilt only when the projection changes
+            void build_cluster_bounds(const mat4 &projection, f32 near, f32 far);
+            u32 get_slice(f32 depth) const;
+
+            std::vector<BoundingBox> cluster_bounds;
+            mat4 bounds_projection;
+            f32 slice_scale, slice_bias;
+            vec2 tile_size;
+
+            std::vector<u8> light_data;
+            std::vector<u32> cluster_ranges;  // Offset and count in the light indices, per cluster
+            std::vector<u32> light_indices;
+            std::vector<std::pair<u32, u32>> assignments;  // (cluster, light), scratch
+
+            std::unique_ptr<StorageBuffer> light_buffer, cluster_buffer, index_buffer;
+    };
+};  // namespace bls
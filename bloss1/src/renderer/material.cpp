@@ -0,0 +1,70 @@
+#include "renderer/material.hpp"
+
+#include "core/logger.hpp"
+
+namespace bls
+{
+    static str get_sampler_name(TextureType type)
+    {
+        switch (type)
+        {
+            case TextureType::Diffuse:
+                return "material.diffuse";
+            case TextureType::Specular:
+                return "material.specular";
+            case TextureType::Normal:
+                return "material.normal";
+            case TextureType::Metalness:
+                return "material.metalness";
+            case TextureType::Roughness:
+                return "material.roughness";
+            case TextureType::AmbientOcclusion:
+                return "material.ao";
+            case TextureType::Emissive:
+                return "material.emissive";
+
+            default:
+                return "";
+        }
+    }
+
+    Material::Material(const std::vector<std::shared_ptr<Texture>> &textures)
+    {
+        static u32 material_count = 0;
+        id = material_count++;
+
+        // The slot is the texture type (if a type shows up more than once, the last texture is used)
+        this->textures.resize(MATERIAL_SLOTS);
+        for (const auto &texture : textures)
+        {
+            const u32 slot = static_cast<u32>(texture->get_type());
+            if (texture->get_type() == TextureType::None || slot >= MATERIAL_SLOTS)
+            {
+                LOG_ERROR("invalid texture type");
+                continue;
+            }
+
+            this->textures[slot] = texture;
+        }
+    }
+
+    Material::~Material()
+    {
+    }
+
+    void Material::set_sampler_slots(Shader &shader)
+    {
+        for (u32 slot = static_cast<u32>(TextureType::Diffuse); slot < MATERIAL_SLOTS; slot++)
+            shader.set_uniform1(get_sampler_name(static_cast<TextureType>(slot)), slot);
+    }
+
+    Texture *Material::get_texture(u32 slot) const
+    {
+        return textures[slot].get();
+    }
+
+    u32 Material::get_id() const
+    {
+        return id;
+    }
+};  // namespace bls
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @brief Bind group of a mesh: its textures, resolved at load. Every texture type has a fixed sampler slot, so the
+ * sampler uniforms are set once per shader and drawing a material only binds the textures that changed.
+ */
+
+#include "renderer/shader.hpp"
+#include "renderer/texture.hpp"
+
+#define MATERIAL_SLOTS 8U  // One per texture type (the 'None' slot is never used)
+
+namespace bls
+{
+    class Material
+    {
+        public:
+            Material(const std::vector<std::shared_ptr<Texture>> &textures);
+            ~Material();
+
+            // Meshes that use the same textures share the material
+            static std::shared_ptr<Material> create(const std::vector<std::shared_ptr<Texture>> &textures);
+
+            // Point every material sampler of the (bound) shader to its slot
+            static void set_sampler_slots(Shader &shader);
+
+            Texture *get_texture(u32 slot) const;  // nullptr if the slot is unused
+            u32 get_id() const;
+
+        private:
+            std::vector<std::shared_ptr<Texture>> textures;  // Indexed by slot
+            u32 id;
+    };
+};  // namespace bls
@@ -47,6 +47,8 @@ namespace bls
             LOG_INFO("animations found:");
             for (const auto &[name, anim] : animations) LOG_INFO("> %s", name.c_str());
         }
+
+        calculate_bounds();
     }
 
     Model::~Model()
@@ -68,6 +70,57 @@ namespace bls
         for (u32 i = 0; i < node->mNumChildren; i++) process_node(node->mChildren[i], scene);
     }
 
+    void Model::calculate_bounds()
+    {
+        // The bind pose does not cover every animated pose
+        if (!animations.empty()) expand_skinned_bounds();
+
+        aabb = {};
+        for (const auto &mesh : meshes)
+        {
+            mesh->bounds = mesh->aabb.get_sphere();
+            aabb.expand(mesh->aabb);
+        }
+
+        bounds = aabb.get_sphere();
+    }
+
+    void Model::expand_skinned_bounds()
+    {
+        // Bind pose box of the vertices each bone influences, per mesh. A skinned vertex is a weighted average of its
+        // bone transforms, so it stays inside the box of the transformed bone boxes
+        std::vector<std::vector<BoundingBox>> bone_boxes(meshes.size(), std::vector<BoundingBox>(MAX_BONE_MATRICES));
+        for (u32 m = 0; m < meshes.size(); m++)
+        {
+            for (const auto &vertex : meshes[m]->vertices)
+            {
+                for (u32 i = 0; i < MAX_BONE_PER_VERTEX; i++)
+                {
+                    const i32 bone_id = vertex.bone_ids[i];
+                    if (bone_id >= 0 && bone_id < MAX_BONE_MATRICES && vertex.weights[i] > 0.0f)
+                        bone_boxes[m][bone_id].expand(vertex.position);
+                }
+            }
+        }
+
+        // Sample each animation once and grow every mesh box with its posed bone boxes
+        for (const auto &[name, animation] : animations)
+        {
+            Animator sampler(animation.get());
+            const f32 step = animation->get_duration_seconds() / SKINNED_BOUNDS_SAMPLES;
+
+            for (u32 sample = 0; sample < SKINNED_BOUNDS_SAMPLES; sample++)
+            {
+                sampler.update(sample == 0 ? 0.0f : step);
+
+                const auto &bone_matrices = sampler.get_final_bone_matrices();
+                for (u32 m = 0; m < meshes.size(); m++)
+                    for (u32 bone_id = 0; bone_id < MAX_BONE_MATRICES; bone_id++)
+                        meshes[m]->aabb.expand(bone_boxes[m][bone_id].transformed(bone_matrices[bone_id]));
+            }
+        }
+    }
+
     Mesh *Model::process_mesh(aiMesh *mesh, const aiScene *scene)
     {
         std::vector<Vertex> vertices;
@@ -159,69 +212,10 @@ namespace bls
         // Bone weight
         extract_bone_weight_for_vertices(vertices, mesh);
 
-        auto vao = VertexArray::create();
-        vao->bind();
-
-        auto vbo = VertexBuffer::create(static_cast<void *>(vertices.data()), vertices.size() * sizeof(Vertex));
-        auto ebo = IndexBuffer::create(indices, indices.size());
-
-        // Position
-        vao->add_vertex_buffer(0,
-                               3,
-                               ShaderDataType::Float,
-                               false,
-                               sizeof(Vertex),
-                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::position)));
+        auto result = new Mesh(vertices, indices, textures);
+        for (const auto &vertex : vertices) result->aabb.expand(vertex.position);
 
-        // Normals
-        vao->add_vertex_buffer(1,
-                               3,
-                               ShaderDataType::Float,
-                               false,
-                               sizeof(Vertex),
-                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::normal)));
-
-        // Texture coords
-        vao->add_vertex_buffer(2,
-                               2,
-                               ShaderDataType::Float,
-                               false,
-                               sizeof(Vertex),
-                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::tex_coords)));
-
-        // Tangent
-        vao->add_vertex_buffer(3,
-                               3,
-                               ShaderDataType::Float,
-                               false,
-                               sizeof(Vertex),
-                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::tangent)));
-
-        // Bitangent
-        vao->add_vertex_buffer(4,
-                               3,
-                               ShaderDataType::Float,
-                               false,
-                               sizeof(Vertex),
-                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::bitangent)));
-
-        // Bone ids
-        vao->add_vertex_buffer(5,
-                               4,
-                               ShaderDataType::Int,
-                               false,
-                               sizeof(Vertex),
-                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::bone_ids)));
-
-        // Weights
-        vao->add_vertex_buffer(6,
-                               4,
-                               ShaderDataType::Float,
-                               false,
-                               sizeof(Vertex),
-                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::weights)));
-
-        return new Mesh(vao, vbo, ebo, vertices, indices, textures);
+        return result;
     }
 
     std::vector<std::shared_ptr<Texture>> Model::load_material_textures(aiMaterial *mat, aiTextureType type)
@@ -332,6 +326,67 @@ namespace bls
         }
     }
 
+    // Mesh
+    // -----------------------------------------------------------------------------------------------------------------
+    void Mesh::set_vertex_layout(VertexArray *vao)
+    {
+        // Position
+        vao->add_vertex_buffer(0,
+                               3,
+                               ShaderDataType::Float,
+                               false,
+                               sizeof(Vertex),
+                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::position)));
+
+        // Normals
+        vao->add_vertex_buffer(1,
+                               3,
+                               ShaderDataType::Float,
+                               false,
+                               sizeof(Vertex),
+                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::normal)));
+
+        // Texture coords
+        vao->add_vertex_buffer(2,
+                               2,
+                               ShaderDataType::Float,
+                               false,
+                               sizeof(Vertex),
+                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::tex_coords)));
+
+        // Tangent
+        vao->add_vertex_buffer(3,
+                               3,
+                               ShaderDataType::Float,
+                               false,
+                               sizeof(Vertex),
+                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::tangent)));
+
+        // Bitangent
+        vao->add_vertex_buffer(4,
+                               3,
+                               ShaderDataType::Float,
+                               false,
+                               sizeof(Vertex),
+                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::bitangent)));
+
+        // Bone ids
+        vao->add_vertex_buffer(5,
+                               4,
+                               ShaderDataType::Int,
+                               false,
+                               sizeof(Vertex),
+                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::bone_ids)));
+
+        // Weights
+        vao->add_vertex_buffer(6,
+                               4,
+                               ShaderDataType::Float,
+                               false,
+                               sizeof(Vertex),
+                               reinterpret_cast<void *>(offsetof(Vertex, Vertex::weights)));
+    }
+
     // Bone
     // -----------------------------------------------------------------------------------------------------------------
     Bone::Bone(const str &name, i32 id, const aiNodeAnim *channel)
@@ -593,6 +648,9 @@ namespace bls
         final_bone_matrices.reserve(MAX_BONE_MATRICES);
 
         for (u32 i = 0; i < MAX_BONE_MATRICES; i++) final_bone_matrices.push_back(mat4(1.0f));
+
+        previous_key_matrices = final_bone_matrices;
+        next_key_matrices = final_bone_matrices;
     }
 
     Animator::~Animator()
@@ -653,6 +711,21 @@ namespace bls
                                          blend_factor);
     }
 
+    void Animator::update_blended_keyed(f32 dt)
+    {
+        // Start from whatever palette is currently displayed so tier changes never pop
+        previous_key_matrices = final_bone_matrices;
+        update_blended(dt);
+        next_key_matrices = final_bone_matrices;
+    }
+
+    void Animator::interpolate_palette(f32 alpha)
+    {
+        alpha = clamp(alpha, 0.0f, 1.0f);
+        for (u32 i = 0; i < final_bone_matrices.size(); i++)
+            final_bone_matrices[i] = previous_key_matrices[i] * (1.0f - alpha) + next_key_matrices[i] * alpha;
+    }
+
     void Animator::calculate_blended_bone_transform(SkeletalAnimation *base_animation,
                                                     const AssNodeData *base_node,
                                                     SkeletalAnimation *layered_animation,
@@ -736,7 +809,7 @@ namespace bls
             calculate_bone_transform(&node->children[i], global_transformation);
     }
 
-    std::vector<mat4> Animator::get_final_bone_matrices()
+    const std::vector<mat4> &Animator::get_final_bone_matrices()
     {
         return final_bone_matrices;
     }
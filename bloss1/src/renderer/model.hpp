@@ -7,13 +7,17 @@
 
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"
+#include "math/bounds.hpp"
 #include "math/math.hpp"
 #include "renderer/assimp_utils.hpp"
 #include "renderer/buffers.hpp"
+#include "renderer/geometry_buffer.hpp"
+#include "renderer/material.hpp"
 #include "renderer/texture.hpp"
 
 #define MAX_BONE_PER_VERTEX 4
 #define MAX_BONE_MATRICES 100
+#define SKINNED_BOUNDS_SAMPLES 16U  // Poses sampled per animation to find the skinned extents
 
 namespace bls
 {
@@ -66,30 +70,42 @@ namespace bls
     class Mesh
     {
         public:
-            Mesh(VertexArray *vao,
-                 VertexBuffer *vbo,
-                 IndexBuffer *ebo,
-                 const std::vector<Vertex> &vertices,
+            // The vertices and indices are drawn from the shared geometry buffer, the mesh has no buffers of its own
+            Mesh(const std::vector<Vertex> &vertices,
                  const std::vector<u32> &indices,
                  const std::vector<std::shared_ptr<Texture>> &textures)
-                : vao(vao), vbo(vbo), ebo(ebo), vertices(vertices), indices(indices), textures(textures)
+                : vertices(vertices),
+                  indices(indices),
+                  textures(textures),
+                  material(Material::create(textures))
             {
+                static u32 mesh_count = 0;
+                id = mesh_count++;
+
+                GeometryBuffer::get().add(this);
             }
 
             ~Mesh()
             {
-                delete vao;
-                delete vbo;
-                delete ebo;
+                GeometryBuffer::get().remove(this);
             }
 
-            VertexArray *vao;
-            VertexBuffer *vbo;
-            IndexBuffer *ebo;
-
             std::vector<Vertex> vertices;
             std::vector<u32> indices;
             std::vector<std::shared_ptr<Texture>> textures;
+            std::shared_ptr<Material> material;
+            u32 id;
+
+            // Object space bounds (for skinned meshes, covering every animated pose)
+            BoundingBox aabb;
+            BoundingSphere bounds;
+
+            // Location of the mesh in the shared geometry buffer
+            u32 base_vertex = 0;
+            u32 first_index = 0;
+
+            // Describe the Vertex attributes (locations 0 to 6) on the bound vertex array
+            static void set_vertex_layout(VertexArray *vao);
     };
 
     // Bone
@@ -185,12 +201,18 @@ namespace bls
                                                   const mat4 &parent_transform,
                                                   const f32 blend_factor);
 
-            std::vector<mat4> get_final_bone_matrices();
+            // Reduced rate updates: advance by dt and blend from the current palette to the new pose
+            void update_blended_keyed(f32 dt);
+            void interpolate_palette(f32 alpha);
+
+            const std::vector<mat4> &get_final_bone_matrices();
             SkeletalAnimation *get_current_animation();
             f32 get_blend_factor();
 
         private:
             std::vector<mat4> final_bone_matrices;
+            std::vector<mat4> previous_key_matrices;
+            std::vector<mat4> next_key_matrices;
             SkeletalAnimation *current_animation;
             SkeletalAnimation *previous_animation;
             f32 current_time;
@@ -215,10 +237,14 @@ namespace bls
             std::map<str, std::unique_ptr<SkeletalAnimation>> animations;
             std::unique_ptr<Animator> animator;
             i32 bone_counter;
+            BoundingBox aabb;
+            BoundingSphere bounds;
 
         private:
             // Helper methods
             void process_node(aiNode *node, const aiScene *scene);
+            void calculate_bounds();
+            void expand_skinned_bounds();
             Mesh *process_mesh(aiMesh *mesh, const aiScene *scene);
             std::vector<std::shared_ptr<Texture>> load_material_textures(aiMaterial *mat, aiTextureType type);
 
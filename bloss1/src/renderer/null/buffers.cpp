@@ -0,0 +1,267 @@
+#include "renderer/null/buffers.hpp"
+
+#include "renderer/null/renderer.hpp"
+
+namespace bls
+{
+    // Vertex Buffer ---------------------------------------------------------------------------------------------------
+    NullVertexBuffer::NullVertexBuffer(void *, u32 size)
+    {
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += size;
+    }
+
+    NullVertexBuffer::NullVertexBuffer(u32)
+    {
+    }
+
+    void NullVertexBuffer::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullVertexBuffer::unbind()
+    {
+    }
+
+    void NullVertexBuffer::set_data(const void *, u32 size)
+    {
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += size;
+    }
+
+    void NullVertexBuffer::set_sub_data(const void *, u32, u32 size)
+    {
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += size;
+    }
+
+    // Index Buffer ----------------------------------------------------------------------------------------------------
+    NullIndexBuffer::NullIndexBuffer(const std::vector<u32> &, u32 count)
+    {
+        this->count = count;
+
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += count * sizeof(u32);
+    }
+
+    void NullIndexBuffer::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullIndexBuffer::unbind()
+    {
+    }
+
+    u32 NullIndexBuffer::get_count()
+    {
+        return count;
+    }
+
+    void NullIndexBuffer::set_data(const u32 *, u32 count)
+    {
+        this->count = count;
+
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += count * sizeof(u32);
+    }
+
+    void NullIndexBuffer::set_sub_data(const u32 *, u32 offset, u32 count)
+    {
+        this->count = std::max(this->count, offset + count);
+
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += count * sizeof(u32);
+    }
+
+    // Storage Buffer --------------------------------------------------------------------------------------------------
+    NullStorageBuffer::NullStorageBuffer(u32)
+    {
+    }
+
+    void NullStorageBuffer::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullStorageBuffer::unbind()
+    {
+    }
+
+    void NullStorageBuffer::bind_base(u32)
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullStorageBuffer::set_data(const void *, u32 size)
+    {
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += size;
+    }
+
+    // Uniform Buffer --------------------------------------------------------------------------------------------------
+    NullUniformBuffer::NullUniformBuffer(u32)
+    {
+    }
+
+    void NullUniformBuffer::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullUniformBuffer::unbind()
+    {
+    }
+
+    void NullUniformBuffer::bind_base(u32)
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullUniformBuffer::set_data(const void *, u32 size)
+    {
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += size;
+    }
+
+    // Indirect Buffer -------------------------------------------------------------------------------------------------
+    NullIndirectBuffer *NullIndirectBuffer::bound = nullptr;
+
+    NullIndirectBuffer::NullIndirectBuffer(u32)
+    {
+    }
+
+    NullIndirectBuffer::~NullIndirectBuffer()
+    {
+        if (bound == this) bound = nullptr;
+    }
+
+    void NullIndirectBuffer::bind()
+    {
+        bound = this;
+        NullRenderer::stats.binds++;
+    }
+
+    void NullIndirectBuffer::unbind()
+    {
+        bound = nullptr;
+    }
+
+    void NullIndirectBuffer::set_data(const void *data, u32 size)
+    {
+        const auto first = static_cast<const DrawIndirectCommand *>(data);
+        commands.assign(first, first + size / sizeof(DrawIndirectCommand));
+
+        NullRenderer::stats.buffer_uploads++;
+        NullRenderer::stats.buffer_bytes += size;
+    }
+
+    const std::vector<DrawIndirectCommand> &NullIndirectBuffer::get_commands() const
+    {
+        return commands;
+    }
+
+    NullIndirectBuffer *NullIndirectBuffer::get_bound()
+    {
+        return bound;
+    }
+
+    // Frame Buffer ----------------------------------------------------------------------------------------------------
+    void NullFrameBuffer::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullFrameBuffer::bind_read()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullFrameBuffer::bind_draw()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullFrameBuffer::unbind()
+    {
+    }
+
+    void NullFrameBuffer::blit(u32, u32, u32, u32)
+    {
+        NullRenderer::stats.state_changes++;
+    }
+
+    void NullFrameBuffer::bind_and_blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height)
+    {
+        bind_read();
+        blit(src_width, src_height, dst_width, dst_height);
+    }
+
+    void NullFrameBuffer::attach_texture(Texture *texture)
+    {
+        attachments.push_back(texture);
+    }
+
+    void NullFrameBuffer::attach_depth_texture(Texture *)
+    {
+    }
+
+    void NullFrameBuffer::draw()
+    {
+    }
+
+    bool NullFrameBuffer::check()
+    {
+        return true;
+    }
+
+    std::vector<Texture *> &NullFrameBuffer::get_attachments()
+    {
+        return attachments;
+    }
+
+    // Render Buffer ---------------------------------------------------------------------------------------------------
+    NullRenderBuffer::NullRenderBuffer(u32 width, u32 height, AttachmentType)
+    {
+        this->width = width;
+        this->height = height;
+    }
+
+    void NullRenderBuffer::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullRenderBuffer::unbind()
+    {
+    }
+
+    u32 NullRenderBuffer::get_width()
+    {
+        return width;
+    }
+
+    u32 NullRenderBuffer::get_height()
+    {
+        return height;
+    }
+
+    // Vertex Array ----------------------------------------------------------------------------------------------------
+    void NullVertexArray::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullVertexArray::unbind()
+    {
+    }
+
+    void NullVertexArray::add_vertex_buffer(u32, i32, ShaderDataType, bool, i32, void *)
+    {
+    }
+
+    void NullVertexArray::add_instance_buffer(u32, i32, ShaderDataType, bool, i32, void *)
+    {
+    }
+};  // namespace bls
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @brief The buffers implementation for the null renderer. Only the uploads and binds are counted.
+ */
+
+#include "renderer/buffers.hpp"
+
+namespace bls
+{
+    class NullVertexBuffer : public VertexBuffer
+    {
+        public:
+            NullVertexBuffer(void *vertices, u32 size);
+            NullVertexBuffer(u32 size);
+
+            void bind() override;
+            void unbind() override;
+            void set_data(const void *data, u32 size) override;
+            void set_sub_data(const void *data, u32 offset, u32 size) override;
+    };
+
+    class NullIndexBuffer : public IndexBuffer
+    {
+        public:
+            NullIndexBuffer(const std::vector<u32> &indices, u32 count);
+
+            void bind() override;
+            void unbind() override;
+            u32 get_count() override;
+            void set_data(const u32 *indices, u32 count) override;
+            void set_sub_data(const u32 *indices, u32 offset, u32 count) override;
+
+        private:
+            u32 count;
+    };
+
+    class NullStorageBuffer : public StorageBuffer
+    {
+        public:
+            NullStorageBuffer(u32 size);
+
+            void bind() override;
+            void unbind() override;
+            void bind_base(u32 binding) override;
+            void set_data(const void *data, u32 size) override;
+    };
+
+    class NullUniformBuffer : public UniformBuffer
+    {
+        public:
+            NullUniformBuffer(u32 size);
+
+            void bind() override;
+            void unbind() override;
+            void bind_base(u32 binding) override;
+            void set_data(const void *data, u32 size) override;
+    };
+
+    // Keeps a copy of the commands, the null renderer reads them to count what the indirect draws submit
+    class NullIndirectBuffer : public IndirectBuffer
+    {
+        public:
+            NullIndirectBuffer(u32 size);
+            ~NullIndirectBuffer();
+
+            void bind() override;
+            void unbind() override;
+            void set_data(const void *data, u32 size) override;
+
+            const std::vector<DrawIndirectCommand> &get_commands() const;
+            static NullIndirectBuffer *get_bound();
+
+        private:
+            std::vector<DrawIndirectCommand> commands;
+            static NullIndirectBuffer *bound;
+    };
+
+    class NullFrameBuffer : public FrameBuffer
+    {
+        public:
+            void bind() override;
+            void bind_read() override;
+            void bind_draw() override;
+            void unbind() override;
+            void blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height) override;
+            void bind_and_blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height) override;
+            void attach_texture(Texture *texture) override;
+            void attach_depth_texture(Texture *texture) override;
+            void draw() override;
+            bool check() override;
+            std::vector<Texture *> &get_attachments() override;
+
+        private:
+            std::vector<Texture *> attachments;
+    };
+
+    class NullRenderBuffer : public RenderBuffer
+    {
+        public:
+            NullRenderBuffer(u32 width, u32 height, AttachmentType type);
+
+            void bind() override;
+            void unbind() override;
+            u32 get_width() override;
+            u32 get_height() override;
+
+        private:
+            u32 width, height;
+    };
+
+    class NullVertexArray : public VertexArray
+    {
+        public:
+            void bind() override;
+            void unbind() override;
+            void add_vertex_buffer(
+                u32 index, i32 size, ShaderDataType type, bool normalized, i32 stride, void *pointer) override;
+            void add_instance_buffer(
+                u32 index, i32 size, ShaderDataType type, bool normalized, i32 stride, void *pointer) override;
+    };
+};  // namespace bls
@@ -0,0 +1,16 @@
+#include "renderer/null/font.hpp"
+
+#include "renderer/null/renderer.hpp"
+
+namespace bls
+{
+    void NullFont::render(str text, f32, f32, f32, vec3)
+    {
+        // The real backends draw a quad per glyph
+        NullRenderer::stats.draw_calls += text.size();
+        NullRenderer::stats.instances += text.size();
+        NullRenderer::stats.indices += text.size() * 6;
+        NullRenderer::stats.buffer_uploads += text.size();
+        NullRenderer::stats.buffer_bytes += text.size() * 6 * sizeof(vec4);
+    }
+};  // namespace bls
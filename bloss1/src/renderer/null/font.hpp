@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * @brief The font implementation for the null renderer. No glyphs are rasterized.
+ */
+
+#include "renderer/font.hpp"
+
+namespace bls
+{
+    class NullFont : public Font
+    {
+        public:
+            void render(str text, f32 x, f32 y, f32 scale, vec3 color) override;
+    };
+};  // namespace bls
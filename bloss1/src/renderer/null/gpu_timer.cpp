@@ -0,0 +1,17 @@
+#include "renderer/null/gpu_timer.hpp"
+
+namespace bls
+{
+    void NullGpuTimer::begin()
+    {
+    }
+
+    void NullGpuTimer::end()
+    {
+    }
+
+    f32 NullGpuTimer::get_elapsed_ms()
+    {
+        return 0.0f;
+    }
+};  // namespace bls
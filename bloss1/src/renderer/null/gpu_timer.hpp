@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * @brief The GPU timer implementation for the null renderer. Nothing runs on a GPU, so nothing is measured.
+ */
+
+#include "renderer/gpu_timer.hpp"
+
+namespace bls
+{
+    class NullGpuTimer : public GpuTimer
+    {
+        public:
+            void begin() override;
+            void end() override;
+
+            f32 get_elapsed_ms() override;
+    };
+};  // namespace bls
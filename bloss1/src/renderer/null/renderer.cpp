@@ -0,0 +1,275 @@
+#include "renderer/null/renderer.hpp"
+
+#include "config.hpp"
+#include "core/game.hpp"
+#include "renderer/null/buffers.hpp"
+#include "renderer/post/post_processing.hpp"
+#include "renderer/primitives/quad.hpp"
+#include "renderer/shadow_map.hpp"
+#include "renderer/skybox.hpp"
+
+namespace bls
+{
+    NullRendererStats NullRenderer::stats;
+
+    NullRenderer::~NullRenderer()
+    {
+        // There is no editor console in a headless run, so the summary goes to the terminal
+        const f64 frames = static_cast<f64>(max(stats.frames, static_cast<u64>(1)));
+        const auto per_frame = [frames](u64 value) { return static_cast<f64>(value) / frames; };
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "null renderer: " << stats.frames << " frames\n";
+        std::cout << "  draw calls:        " << per_frame(stats.draw_calls) << " / frame\n";
+        std::cout << "  indirect commands: " << per_frame(stats.indirect_commands) << " / frame\n";
+        std::cout << "  instances:         " << per_frame(stats.instances) << " / frame\n";
+        std::cout << "  indices:           " << per_frame(stats.indices) << " / frame\n";
+        std::cout << "  state changes:     " << per_frame(stats.state_changes) << " / frame\n";
+        std::cout << "  binds:             " << per_frame(stats.binds) << " / frame\n";
+        std::cout << "  uniform uploads:   " << per_frame(stats.uniform_uploads) << " / frame ("
+                  << per_frame(stats.uniform_bytes) << " bytes)\n";
+        std::cout << "  buffer uploads:    " << per_frame(stats.buffer_uploads) << " / frame ("
+                  << per_frame(stats.buffer_bytes) << " bytes)\n";
+        std::cout << "  texture uploads:   " << stats.texture_uploads << " (" << stats.texture_bytes << " bytes)\n";
+
+        std::cout << std::setprecision(3);
+        std::cout << "  simulation:        " << AppStats::sim_ms << " ms, render: " << AppStats::render_ms << " ms\n";
+        std::cout << "  submit wait:       " << AppStats::submit_wait_ms << " ms\n";
+        std::cout << "  latency:           " << AppStats::frame_latency_ms << " ms\n";
+        std::cout << "  present interval:  " << AppStats::frame_interval_ms << " ms (jitter "
+                  << AppStats::frame_jitter_ms << " ms)\n";
+
+        std::cout << "  gpu:               " << AppStats::gpu_ms << " ms (resolution scale "
+                  << AppStats::resolution_scale << ")\n";
+
+        std::cout << std::setprecision(1);
+        std::cout << "  render targets:    " << AppStats::render_target_bytes / (1024.0 * 1024.0) << " MB ("
+                  << AppStats::render_target_unaliased_bytes / (1024.0 * 1024.0) << " MB without aliasing)\n";
+    }
+
+    void NullRenderer::initialize()
+    {
+        auto &window = Game::get().get_window();
+        auto width = window.get_width();
+        auto height = window.get_height();
+
+        // Same resources as the other backends, so the render systems find everything they expect
+        // -------------------------------------------------------------------------------------------------------------
+        shaders["g_buffer"] =
+            Shader::create("g_buffer", "bloss1/assets/shaders/g_buffer.vs", "bloss1/assets/shaders/g_buffer.fs");
+
+        shaders["pbr"] = Shader::create("pbr", "bloss1/assets/shaders/pbr/pbr.vs", "bloss1/assets/shaders/pbr/pbr.fs");
+
+        shaders["f_pbr"] = Shader::create(
+            "f_pbr", "bloss1/assets/shaders/pbr/pbr_forward.vs", "bloss1/assets/shaders/pbr/pbr_forward.fs");
+
+        shaders["color"] = Shader::create(
+            "color", "bloss1/assets/shaders/test/base_color.vs", "bloss1/assets/shaders/test/base_color.fs");
+
+        shaders["ui"] =
+            Shader::create("ui", "bloss1/assets/shaders/post/base.vs", "bloss1/assets/shaders/post/base.fs");
+
+        g_buffer = std::unique_ptr<FrameBuffer>(FrameBuffer::create());
+
+        std::vector<std::pair<str, ImageFormat>> attachments = {{"normal", ImageFormat::RG16},
+                                                                {"albedo", ImageFormat::RGBA8},
+                                                                {"arm", ImageFormat::RGBA8},
+                                                                {"emissive", ImageFormat::RGBA8}};
+        for (const auto &[name, format] : attachments)
+        {
+            auto texture = Texture::create(width,
+                                           height,
+                                           format,
+                                           TextureParameter::Repeat,
+                                           TextureParameter::Repeat,
+                                           TextureParameter::Nearest,
+                                           TextureParameter::Nearest);
+
+            textures.push_back({name, texture});
+            g_buffer->attach_texture(texture.get());
+        }
+        g_buffer->draw();
+
+        auto depth_texture = Texture::create(width,
+                                             height,
+                                             ImageFormat::Depth24,
+                                             TextureParameter::ClampToEdge,
+                                             TextureParameter::ClampToEdge,
+                                             TextureParameter::Nearest,
+                                             TextureParameter::Nearest);
+
+        textures.push_back({"depth", depth_texture});
+        g_buffer->attach_depth_texture(depth_texture.get());
+
+        auto texture = Texture::create("ui_texture", "bloss1/assets/textures/crosshair.png", TextureType::Diffuse);
+        textures.push_back({"ui", texture});
+
+        g_buffer->unbind();
+
+        quad = std::make_unique<Quad>(*this);
+        post_processing = std::make_unique<PostProcessingSystem>(width, height);
+    }
+
+    void NullRenderer::set_viewport(u32, u32, u32, u32)
+    {
+        stats.state_changes++;
+    }
+
+    void NullRenderer::set_debug_mode(bool)
+    {
+        stats.state_changes++;
+    }
+
+    void NullRenderer::set_blending(bool)
+    {
+        stats.state_changes++;
+    }
+
+    void NullRenderer::set_face_culling(bool)
+    {
+        stats.state_changes++;
+    }
+
+    void NullRenderer::set_tesselation_patches(u32)
+    {
+        stats.state_changes++;
+    }
+
+    void NullRenderer::clear_color(const vec4 &)
+    {
+        stats.state_changes++;
+    }
+
+    void NullRenderer::clear()
+    {
+        stats.state_changes++;
+    }
+
+    void NullRenderer::draw_indexed(RenderingMode, u32 count, const void *)
+    {
+        stats.draw_calls++;
+        stats.instances++;
+        stats.indices += count;
+    }
+
+    void NullRenderer::draw_arrays(RenderingMode, u32 count)
+    {
+        stats.draw_calls++;
+        stats.instances++;
+        stats.indices += count;
+    }
+
+    void NullRenderer::draw_indexed_instanced(RenderingMode, u32 count, u32 instance_count, u32)
+    {
+        stats.draw_calls++;
+        stats.instances += instance_count;
+        stats.indices += static_cast<u64>(count) * instance_count;
+    }
+
+    void NullRenderer::draw_indexed_indirect(RenderingMode, u32 first_command, u32 command_count)
+    {
+        stats.draw_calls++;
+        stats.indirect_commands += command_count;
+
+        // The commands live on the cpu here, so the instances and indices can be counted like the direct draws
+        auto buffer = NullIndirectBuffer::get_bound();
+        if (!buffer) return;
+
+        const auto &commands = buffer->get_commands();
+        for (u32 i = first_command; i < first_command + command_count && i < commands.size(); i++)
+        {
+            stats.instances += commands[i].instance_count;
+            stats.indices += static_cast<u64>(commands[i].count) * commands[i].instance_count;
+        }
+    }
+
+    void NullRenderer::create_skybox(const str &file,
+                                     const u32 skybox_resolution,
+                                     const u32 irradiance_resolution,
+                                     const u32 brdf_resolution,
+                                     const u32 prefilter_resolution,
+                                     const u32 max_mip_levels)
+    {
+        skybox.reset();
+        skybox = std::unique_ptr<Skybox>(Skybox::create(
+            file, skybox_resolution, irradiance_resolution, brdf_resolution, prefilter_resolution, max_mip_levels));
+    }
+
+    void NullRenderer::create_shadow_map(ECS &)
+    {
+        // The shadow map uses OpenGL directly, the render systems skip the shadow passes without it
+    }
+
+    void NullRenderer::create_height_map(
+        u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 pixels_per_edge)
+    {
+        height_map = std::make_unique<HeightMap>(width, height, min_tess_level, max_tess_level, pixels_per_edge);
+    }
+
+    void NullRenderer::create_post_processing_passes(ECS &ecs)
+    {
+        auto &window = Game::get().get_window();
+        auto &camera = ecs.cameras[0];
+
+        auto width = window.get_width();
+        auto height = window.get_height();
+
+        u32 pass_position = 1;
+        post_processing->add_pass(new FXAAPass(width, height), pass_position++);
+        post_processing->add_pass(new BloomPass(width, height, 5, 7.0f, 0.4f, 0.325f), pass_position++);
+
+        post_processing->add_pass(new FogPass(width,
+                                              height,
+                                              vec3(0.0f),
+                                              vec2(camera->far / 3.0f, camera->far / 2.0f),
+                                              textures[G_BUFFER_DEPTH_ATTACHMENT].second.get()),
+                                  pass_position++);
+
+        post_processing->add_pass(new SharpenPass(width, height, 0.05f), pass_position++);
+        post_processing->add_pass(new PosterizationPass(width, height, 8.0f), pass_position++);
+        post_processing->add_pass(new PixelizationPass(width, height, 4), pass_position++);
+        post_processing->add_pass(new OutlinePass(width, height, vec3(0.0f), 0.8f), pass_position++);
+        post_processing->add_pass(new VignettePass(width, height, 0.85f, 0.45f), pass_position++);
+        post_processing->add_pass(new KuwaharaPass(width, height, 5), pass_position++);
+    }
+
+    std::map<str, std::shared_ptr<Shader>> &NullRenderer::get_shaders()
+    {
+        return shaders;
+    }
+
+    std::vector<std::pair<str, std::shared_ptr<Texture>>> &NullRenderer::get_textures()
+    {
+        return textures;
+    }
+
+    std::unique_ptr<FrameBuffer> &NullRenderer::get_gbuffer()
+    {
+        return g_buffer;
+    }
+
+    std::unique_ptr<Skybox> &NullRenderer::get_skybox()
+    {
+        return skybox;
+    }
+
+    std::unique_ptr<Quad> &NullRenderer::get_rendering_quad()
+    {
+        return quad;
+    }
+
+    std::unique_ptr<ShadowMap> &NullRenderer::get_shadow_map()
+    {
+        return shadow_map;
+    }
+
+    std::unique_ptr<HeightMap> &NullRenderer::get_height_map()
+    {
+        return height_map;
+    }
+
+    std::unique_ptr<PostProcessingSystem> &NullRenderer::get_post_processing()
+    {
+        return post_processing;
+    }
+};  // namespace bls
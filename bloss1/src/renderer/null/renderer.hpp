@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * @brief The renderer implementation that does no GPU work. Every call is only counted, so the game loop and
+ * the render systems can run (and be profiled) without a window or a graphics context.
+ */
+
+#include "renderer/buffers.hpp"
+#include "renderer/height_map.hpp"
+#include "renderer/post/post_processing.hpp"
+#include "renderer/renderer.hpp"
+#include "renderer/shader.hpp"
+#include "renderer/shadow_map.hpp"
+
+namespace bls
+{
+    // Work submitted to the null backend since startup
+    struct NullRendererStats
+    {
+            u64 frames = 0;
+            u64 draw_calls = 0;         // An indirect call counts once
+            u64 indirect_commands = 0;  // Commands read by the indirect calls
+            u64 instances = 0;
+            u64 indices = 0;  // Indices (or vertices) of every instance
+            u64 state_changes = 0;
+            u64 binds = 0;
+            u64 uniform_uploads = 0;
+            u64 uniform_bytes = 0;
+            u64 buffer_uploads = 0;
+            u64 buffer_bytes = 0;
+            u64 texture_uploads = 0;
+            u64 texture_bytes = 0;
+    };
+
+    class NullRenderer : public Renderer
+    {
+        public:
+            ~NullRenderer();
+
+            void initialize() override;
+
+            void set_viewport(u32 x, u32 y, u32 width, u32 height) override;
+            void set_debug_mode(bool active) override;
+            void set_blending(bool active) override;
+            void set_face_culling(bool active) override;
+            void set_tesselation_patches(u32 patches) override;
+
+            void clear_color(const vec4 &color) override;
+            void clear() override;
+            void draw_indexed(RenderingMode mode, u32 count, const void *indices) override;
+            void draw_arrays(RenderingMode mode, u32 count) override;
+            void draw_indexed_instanced(RenderingMode mode, u32 count, u32 instance_count, u32 base_instance) override;
+            void draw_indexed_indirect(RenderingMode mode, u32 first_command, u32 command_count) override;
+
+            void create_skybox(const str &file,
+                               const u32 skybox_resolution,
+                               const u32 irradiance_resolution,
+                               const u32 brdf_resolution,
+                               const u32 prefilter_resolution,
+                               const u32 max_mip_levels) override;
+            void create_shadow_map(ECS &ecs) override;
+            void create_height_map(
+                u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 pixels_per_edge) override;
+            void create_post_processing_passes(ECS &ecs) override;
+
+            std::map<str, std::shared_ptr<Shader>> &get_shaders() override;
+            std::vector<std::pair<str, std::shared_ptr<Texture>>> &get_textures() override;
+            std::unique_ptr<FrameBuffer> &get_gbuffer() override;
+            std::unique_ptr<Skybox> &get_skybox() override;
+            std::unique_ptr<Quad> &get_rendering_quad() override;
+            std::unique_ptr<ShadowMap> &get_shadow_map() override;
+            std::unique_ptr<HeightMap> &get_height_map() override;
+            std::unique_ptr<PostProcessingSystem> &get_post_processing() override;
+
+            static NullRendererStats stats;
+
+        private:
+            std::unique_ptr<Quad> quad;
+            std::unique_ptr<FrameBuffer> g_buffer;
+            std::map<str, std::shared_ptr<Shader>> shaders;
+
+            std::vector<std::pair<str, std::shared_ptr<Texture>>> textures;
+
+            std::unique_ptr<Skybox> skybox;
+            std::unique_ptr<ShadowMap> shadow_map;  // Always empty: the shadow map talks to OpenGL directly
+            std::unique_ptr<HeightMap> height_map;
+            std::unique_ptr<PostProcessingSystem> post_processing;
+    };
+};  // namespace bls
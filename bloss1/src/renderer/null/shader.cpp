@@ -0,0 +1,133 @@
+#include "renderer/null/shader.hpp"
+
+#include "renderer/null/renderer.hpp"
+
+namespace bls
+{
+    void NullShader::bind()
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullShader::unbind()
+    {
+    }
+
+    UniformHandle NullShader::get_uniform_handle(const str &name)
+    {
+        // Every name gets a valid location, so the callers take the same paths as with a real backend
+        auto it = uniform_locations.find(name);
+        if (it != uniform_locations.end()) return {it->second};
+
+        const i32 location = static_cast<i32>(uniform_locations.size());
+        uniform_locations[name] = location;
+
+        return {location};
+    }
+
+    void NullShader::set_uniform1(const str &, bool)
+    {
+        upload(sizeof(i32));
+    }
+
+    void NullShader::set_uniform1(const str &, u32)
+    {
+        upload(sizeof(u32));
+    }
+
+    void NullShader::set_uniform1(const str &, f32)
+    {
+        upload(sizeof(f32));
+    }
+
+    void NullShader::set_uniform2(const str &, const vec2 &)
+    {
+        upload(sizeof(vec2));
+    }
+
+    void NullShader::set_uniform3(const str &, const vec3 &)
+    {
+        upload(sizeof(vec3));
+    }
+
+    void NullShader::set_uniform3(const str &, const mat3 &)
+    {
+        upload(sizeof(mat3));
+    }
+
+    void NullShader::set_uniform4(const str &, const vec4 &)
+    {
+        upload(sizeof(vec4));
+    }
+
+    void NullShader::set_uniform4(const str &, const mat4 &)
+    {
+        upload(sizeof(mat4));
+    }
+
+    void NullShader::set_uniform1(UniformHandle, bool)
+    {
+        upload(sizeof(i32));
+    }
+
+    void NullShader::set_uniform1(UniformHandle, u32)
+    {
+        upload(sizeof(u32));
+    }
+
+    void NullShader::set_uniform1(UniformHandle, f32)
+    {
+        upload(sizeof(f32));
+    }
+
+    void NullShader::set_uniform2(UniformHandle, const vec2 &)
+    {
+        upload(sizeof(vec2));
+    }
+
+    void NullShader::set_uniform3(UniformHandle, const vec3 &)
+    {
+        upload(sizeof(vec3));
+    }
+
+    void NullShader::set_uniform3(UniformHandle, const vec3 *, u32 count)
+    {
+        upload(sizeof(vec3) * count);
+    }
+
+    void NullShader::set_uniform3(UniformHandle, const mat3 &)
+    {
+        upload(sizeof(mat3));
+    }
+
+    void NullShader::set_uniform4(UniformHandle, const vec4 &)
+    {
+        upload(sizeof(vec4));
+    }
+
+    void NullShader::set_uniform4(UniformHandle, const mat4 &)
+    {
+        upload(sizeof(mat4));
+    }
+
+    void NullShader::set_uniform4(UniformHandle, const mat4 *, u32 count)
+    {
+        upload(sizeof(mat4) * count);
+    }
+
+    vec3 NullShader::get_uniform3(const str &)
+    {
+        return vec3(0.0f);
+    }
+
+    mat4 NullShader::get_uniform4(const str &)
+    {
+        return mat4(1.0f);
+    }
+
+    void NullShader::upload(u64 size)
+    {
+        NullRenderer::stats.uniform_uploads++;
+        NullRenderer::stats.uniform_bytes += size;
+    }
+};  // namespace bls
@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @brief The shader implementation for the null renderer. Nothing is compiled, the uniform uploads are counted.
+ */
+
+#include "renderer/shader.hpp"
+
+namespace bls
+{
+    class NullShader : public Shader
+    {
+        public:
+            void bind() override;
+            void unbind() override;
+
+            UniformHandle get_uniform_handle(const str &name) override;
+
+            // Uniform functions
+            void set_uniform1(const str &name, bool value) override;
+            void set_uniform1(const str &name, u32 value) override;
+            void set_uniform1(const str &name, f32 value) override;
+
+            void set_uniform2(const str &name, const vec2 &vector) override;
+
+            void set_uniform3(const str &name, const vec3 &vector) override;
+            void set_uniform3(const str &name, const mat3 &matrix) override;
+
+            void set_uniform4(const str &name, const vec4 &vector) override;
+            void set_uniform4(const str &name, const mat4 &matrix) override;
+
+            // Uniform functions (handles)
+            void set_uniform1(UniformHandle handle, bool value) override;
+            void set_uniform1(UniformHandle handle, u32 value) override;
+            void set_uniform1(UniformHandle handle, f32 value) override;
+
+            void set_uniform2(UniformHandle handle, const vec2 &vector) override;
+
+            void set_uniform3(UniformHandle handle, const vec3 &vector) override;
+            void set_uniform3(UniformHandle handle, const vec3 *vectors, u32 count) override;
+            void set_uniform3(UniformHandle handle, const mat3 &matrix) override;
+
+            void set_uniform4(UniformHandle handle, const vec4 &vector) override;
+            void set_uniform4(UniformHandle handle, const mat4 &matrix) override;
+            void set_uniform4(UniformHandle handle, const mat4 *matrices, u32 count) override;
+
+            vec3 get_uniform3(const str &name) override;
+            mat4 get_uniform4(const str &name) override;
+
+        private:
+            void upload(u64 size);
+
+            std::unordered_map<str, i32> uniform_locations;
+    };
+};  // namespace bls
@@ -0,0 +1,29 @@
+#include "renderer/null/skybox.hpp"
+
+#include "renderer/null/renderer.hpp"
+
+namespace bls
+{
+    NullSkybox::NullSkybox(const str &path)
+    {
+        this->path = path;
+    }
+
+    void NullSkybox::bind(Shader &, u32)
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    void NullSkybox::draw()
+    {
+        // A unit cube, like the real backends
+        NullRenderer::stats.draw_calls++;
+        NullRenderer::stats.instances++;
+        NullRenderer::stats.indices += 36;
+    }
+
+    str NullSkybox::get_path() const
+    {
+        return path;
+    }
+};  // namespace bls
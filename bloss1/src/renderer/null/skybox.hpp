@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * @brief The skybox implementation for the null renderer. The environment maps are never generated.
+ */
+
+#include "renderer/skybox.hpp"
+
+namespace bls
+{
+    class NullSkybox : public Skybox
+    {
+        public:
+            NullSkybox(const str &path);
+
+            void bind(Shader &shader, u32 slot) override;
+            void draw() override;
+            str get_path() const override;
+
+        private:
+            str path;
+    };
+};  // namespace bls
@@ -0,0 +1,66 @@
+#include "renderer/null/texture.hpp"
+
+#include "renderer/null/renderer.hpp"
+#include "stb/stb_image.h"
+
+namespace bls
+{
+    u32 NullTexture::next_id = 1;  // 0 is never a valid texture
+
+    NullTexture::NullTexture(u32 width, u32 height, ImageFormat format)
+    {
+        this->texture_id = next_id++;
+        this->type = TextureType::None;
+        this->width = width;
+        this->height = height;
+        this->pixel_size = Texture::get_format_size(format);
+    }
+
+    NullTexture::NullTexture(const str &path, TextureType texture_type)
+    {
+        // Only the header is read, the pixels are never decoded
+        i32 image_width, image_height, num_components;
+        if (!stbi_info(path.c_str(), &image_width, &image_height, &num_components))
+            throw std::runtime_error("failed to load texture: '" + path + "'");
+
+        this->texture_id = next_id++;
+        this->type = texture_type;
+        this->width = image_width;
+        this->height = image_height;
+        this->pixel_size = num_components * (stbi_is_hdr(path.c_str()) ? sizeof(f32) : sizeof(u8));
+
+        NullRenderer::stats.texture_uploads++;
+        NullRenderer::stats.texture_bytes += static_cast<u64>(width) * height * pixel_size;
+    }
+
+    void NullTexture::bind(u32)
+    {
+        NullRenderer::stats.binds++;
+    }
+
+    u32 NullTexture::get_id()
+    {
+        return texture_id;
+    }
+
+    u32 NullTexture::get_width()
+    {
+        return width;
+    }
+
+    u32 NullTexture::get_height()
+    {
+        return height;
+    }
+
+    TextureType NullTexture::get_type()
+    {
+        return type;
+    }
+
+    void NullTexture::set_data(void *)
+    {
+        NullRenderer::stats.texture_uploads++;
+        NullRenderer::stats.texture_bytes += static_cast<u64>(width) * height * pixel_size;
+    }
+};  // namespace bls
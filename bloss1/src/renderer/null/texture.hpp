@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @brief The texture implementation for the null renderer. Image files are only probed for their size.
+ */
+
+#include "renderer/texture.hpp"
+
+namespace bls
+{
+    class NullTexture : public Texture
+    {
+        public:
+            NullTexture(u32 width, u32 height, ImageFormat format);
+            NullTexture(const str &path, TextureType texture_type);
+
+            void bind(u32 slot) override;
+
+            u32 get_id() override;
+            u32 get_width() override;
+            u32 get_height() override;
+            TextureType get_type() override;
+
+            void set_data(void *pixels) override;
+
+        private:
+            u32 texture_id;
+            TextureType type;
+            u32 width, height;
+            u32 pixel_size;  // In bytes
+
+            static u32 next_id;
+    };
+};  // namespace bls
@@ -30,6 +30,15 @@ namespace bls
         glGenBuffers(1, &VBO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+        capacity = size;
+    }
+
+    OpenGLVertexBuffer::OpenGLVertexBuffer(u32 size)
+    {
+        glGenBuffers(1, &VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        capacity = size;
     }
 
     OpenGLVertexBuffer::~OpenGLVertexBuffer()
@@ -47,12 +56,33 @@ namespace bls
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    void OpenGLVertexBuffer::set_data(const void *data, u32 size)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+        // Orphan the old storage so the driver does not wait for draws still reading it
+        capacity = std::max(capacity, size);
+        glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+    }
+
+    void OpenGLVertexBuffer::set_sub_data(const void *data, u32 offset, u32 size)
+    {
+        if (offset + size > capacity) throw std::runtime_error("vertex buffer write out of bounds");
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+
     // Index Buffer ----------------------------------------------------------------------------------------------------
     OpenGLIndexBuffer::OpenGLIndexBuffer(const std::vector<u32> &indices, u32 count)
     {
         glGenBuffers(1, &IBO);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(u32), &indices[0], GL_STATIC_DRAW);
+
+        this->count = count;
+        this->capacity = count;
     }
 
     OpenGLIndexBuffer::~OpenGLIndexBuffer()
@@ -75,6 +105,146 @@ namespace bls
         return count;
     }
 
+    void OpenGLIndexBuffer::set_data(const u32 *indices, u32 count)
+    {
+        // Careful: the element buffer binding is part of the bound vertex array
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+
+        if (count > capacity)
+        {
+            capacity = count;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, capacity * sizeof(u32), indices, GL_STATIC_DRAW);
+        }
+
+        else
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, count * sizeof(u32), indices);
+
+        this->count = count;
+    }
+
+    void OpenGLIndexBuffer::set_sub_data(const u32 *indices, u32 offset, u32 count)
+    {
+        if (offset + count > capacity) throw std::runtime_error("index buffer write out of bounds");
+
+        // Careful: the element buffer binding is part of the bound vertex array
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(u32), count * sizeof(u32), indices);
+
+        this->count = std::max(this->count, offset + count);
+    }
+
+    // Storage Buffer --------------------------------------------------------------------------------------------------
+    OpenGLStorageBuffer::OpenGLStorageBuffer(u32 size)
+    {
+        glGenBuffers(1, &SSBO);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, SSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        capacity = size;
+    }
+
+    OpenGLStorageBuffer::~OpenGLStorageBuffer()
+    {
+        glDeleteBuffers(1, &SSBO);
+    }
+
+    void OpenGLStorageBuffer::bind()
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, SSBO);
+    }
+
+    void OpenGLStorageBuffer::unbind()
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void OpenGLStorageBuffer::bind_base(u32 binding)
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, SSBO);
+    }
+
+    void OpenGLStorageBuffer::set_data(const void *data, u32 size)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, SSBO);
+
+        // Orphan the old storage so the driver does not wait for draws still reading it
+        capacity = std::max(capacity, size);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+    }
+
+    // Uniform Buffer --------------------------------------------------------------------------------------------------
+    OpenGLUniformBuffer::OpenGLUniformBuffer(u32 size)
+    {
+        glGenBuffers(1, &UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        capacity = size;
+    }
+
+    OpenGLUniformBuffer::~OpenGLUniformBuffer()
+    {
+        glDeleteBuffers(1, &UBO);
+    }
+
+    void OpenGLUniformBuffer::bind()
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    }
+
+    void OpenGLUniformBuffer::unbind()
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void OpenGLUniformBuffer::bind_base(u32 binding)
+    {
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, UBO);
+    }
+
+    void OpenGLUniformBuffer::set_data(const void *data, u32 size)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+
+        // Orphan the old storage so the driver does not wait for draws still reading it
+        capacity = std::max(capacity, size);
+        glBufferData(GL_UNIFORM_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+    }
+
+    // Indirect Buffer -------------------------------------------------------------------------------------------------
+    OpenGLIndirectBuffer::OpenGLIndirectBuffer(u32 size)
+    {
+        glGenBuffers(1, &IDBO);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IDBO);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        capacity = size;
+    }
+
+    OpenGLIndirectBuffer::~OpenGLIndirectBuffer()
+    {
+        glDeleteBuffers(1, &IDBO);
+    }
+
+    void OpenGLIndirectBuffer::bind()
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IDBO);
+    }
+
+    void OpenGLIndirectBuffer::unbind()
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void OpenGLIndirectBuffer::set_data(const void *data, u32 size)
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IDBO);
+
+        // Orphan the old storage so the driver does not wait for draws still reading it
+        capacity = std::max(capacity, size);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, data);
+    }
+
     // Frame Buffer ----------------------------------------------------------------------------------------------------
     OpenGLFrameBuffer::OpenGLFrameBuffer()
     {
@@ -107,16 +277,17 @@ namespace bls
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
-    void OpenGLFrameBuffer::blit(u32 width, u32 height)
+    void OpenGLFrameBuffer::blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height)
     {
-        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        // Depth can only be scaled with nearest filtering
+        glBlitFramebuffer(0, 0, src_width, src_height, 0, 0, dst_width, dst_height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
     }
 
-    void OpenGLFrameBuffer::bind_and_blit(u32 width, u32 height)
+    void OpenGLFrameBuffer::bind_and_blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height)
     {
         bind_read();
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);  // Draw to default framebuffer
-        blit(width, height);
+        blit(src_width, src_height, dst_width, dst_height);
     }
 
     void OpenGLFrameBuffer::attach_texture(Texture *texture)
@@ -126,6 +297,11 @@ namespace bls
         attachments.push_back(texture);
     }
 
+    void OpenGLFrameBuffer::attach_depth_texture(Texture *texture)
+    {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture->get_id(), 0);
+    }
+
     void OpenGLFrameBuffer::draw()
     {
         u32 color_attachments[attachments.size()];
@@ -220,4 +396,11 @@ namespace bls
 
         glEnableVertexAttribArray(index);
     }
+
+    void OpenGLVertexArray::add_instance_buffer(
+        u32 index, i32 size, ShaderDataType type, bool normalized, i32 stride, void *pointer)
+    {
+        add_vertex_buffer(index, size, type, normalized, stride, pointer);
+        glVertexAttribDivisor(index, 1);
+    }
 };  // namespace bls
@@ -12,13 +12,17 @@ namespace bls
     {
         public:
             OpenGLVertexBuffer(void *vertices, u32 size);
+            OpenGLVertexBuffer(u32 size);
             ~OpenGLVertexBuffer();
 
             void bind() override;
             void unbind() override;
+            void set_data(const void *data, u32 size) override;
+            void set_sub_data(const void *data, u32 offset, u32 size) override;
 
         private:
             u32 VBO;
+            u32 capacity;
     };
 
     class OpenGLIndexBuffer : public IndexBuffer
@@ -30,10 +34,60 @@ namespace bls
             void bind() override;
             void unbind() override;
             u32 get_count() override;
+            void set_data(const u32 *indices, u32 count) override;
+            void set_sub_data(const u32 *indices, u32 offset, u32 count) override;
 
         private:
             u32 IBO;
             u32 count;
+            u32 capacity;
+    };
+
+    class OpenGLStorageBuffer : public StorageBuffer
+    {
+        public:
+            OpenGLStorageBuffer(u32 size);
+            ~OpenGLStorageBuffer();
+
+            void bind() override;
+            void unbind() override;
+            void bind_base(u32 binding) override;
+            void set_data(const void *data, u32 size) override;
+
+        private:
+            u32 SSBO;
+            u32 capacity;
+    };
+
+    class OpenGLUniformBuffer : public UniformBuffer
+    {
+        public:
+            OpenGLUniformBuffer(u32 size);
+            ~OpenGLUniformBuffer();
+
+            void bind() override;
+            void unbind() override;
+            void bind_base(u32 binding) override;
+            void set_data(const void *data, u32 size) override;
+
+        private:
+            u32 UBO;
+            u32 capacity;
+    };
+
+    class OpenGLIndirectBuffer : public IndirectBuffer
+    {
+        public:
+            OpenGLIndirectBuffer(u32 size);
+            ~OpenGLIndirectBuffer();
+
+            void bind() override;
+            void unbind() override;
+            void set_data(const void *data, u32 size) override;
+
+        private:
+            u32 IDBO;
+            u32 capacity;
     };
 
     class OpenGLFrameBuffer : public FrameBuffer
@@ -46,9 +100,10 @@ namespace bls
             void bind_read() override;
             void bind_draw() override;
             void unbind() override;
-            void blit(u32 width, u32 height) override;
-            void bind_and_blit(u32 width, u32 height) override;
+            void blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height) override;
+            void bind_and_blit(u32 src_width, u32 src_height, u32 dst_width, u32 dst_height) override;
             void attach_texture(Texture *texture) override;
+            void attach_depth_texture(Texture *texture) override;
             void draw() override;
             bool check() override;
             std::vector<Texture *> &get_attachments() override;
@@ -86,6 +141,8 @@ namespace bls
 
             void add_vertex_buffer(
                 u32 index, i32 size, ShaderDataType type, bool normalized, i32 stride, void *pointer) override;
+            void add_instance_buffer(
+                u32 index, i32 size, ShaderDataType type, bool normalized, i32 stride, void *pointer) override;
 
         private:
             u32 VAO;
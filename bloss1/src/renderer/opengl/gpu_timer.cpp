@@ -0,0 +1,51 @@
+#include "renderer/opengl/gpu_timer.hpp"
+
+#include <GL/glew.h>  // Include glew before glfw
+
+#include "GLFW/glfw3.h"
+
+namespace bls
+{
+    OpenGLGpuTimer::OpenGLGpuTimer()
+    {
+        glGenQueries(GPU_TIMER_QUERIES, queries);
+
+        for (u32 i = 0; i < GPU_TIMER_QUERIES; i++) issued[i] = false;
+        current = 0;
+        elapsed_ms = 0.0f;
+    }
+
+    OpenGLGpuTimer::~OpenGLGpuTimer()
+    {
+        glDeleteQueries(GPU_TIMER_QUERIES, queries);
+    }
+
+    void OpenGLGpuTimer::begin()
+    {
+        glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+    }
+
+    void OpenGLGpuTimer::end()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+
+        issued[current] = true;
+        current = (current + 1) % GPU_TIMER_QUERIES;
+
+        // The query reused next frame is the oldest one. Its result is dropped if the GPU is that far behind
+        if (!issued[current]) return;
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[current], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return;
+
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(queries[current], GL_QUERY_RESULT, &elapsed_ns);
+        elapsed_ms = static_cast<f32>(elapsed_ns) / 1'000'000.0f;
+    }
+
+    f32 OpenGLGpuTimer::get_elapsed_ms()
+    {
+        return elapsed_ms;
+    }
+};  // namespace bls
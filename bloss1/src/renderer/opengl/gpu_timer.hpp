@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * @brief GPU timer implementation for OpenGL (time elapsed queries).
+ */
+
+#include "renderer/gpu_timer.hpp"
+
+#define GPU_TIMER_QUERIES 3  // Measurements in flight, the oldest is read when its query is reused
+
+namespace bls
+{
+    class OpenGLGpuTimer : public GpuTimer
+    {
+        public:
+            OpenGLGpuTimer();
+            ~OpenGLGpuTimer();
+
+            void begin() override;
+            void end() override;
+
+            f32 get_elapsed_ms() override;
+
+        private:
+            u32 queries[GPU_TIMER_QUERIES];
+            bool issued[GPU_TIMER_QUERIES];
+            u32 current;
+            f32 elapsed_ms;
+    };
+};  // namespace bls
@@ -87,13 +87,17 @@ namespace bls
         // Create g_buffer framebuffer
         g_buffer = std::unique_ptr<FrameBuffer>(FrameBuffer::create());
 
-        // Create and attach framebuffer textures
-        std::vector<str> texture_names = {"position", "normal", "albedo", "arm", "emissive", "depth"};
-        for (const auto &name : texture_names)
+        // Create and attach framebuffer textures. The layout is packed (16 bytes per pixel): the position is rebuilt
+        // from the depth and the normal is octahedral encoded in two channels
+        std::vector<std::pair<str, ImageFormat>> attachments = {{"normal", ImageFormat::RG16},
+                                                                {"albedo", ImageFormat::RGBA8},
+                                                                {"arm", ImageFormat::RGBA8},
+                                                                {"emissive", ImageFormat::RGBA8}};
+        for (const auto &[name, format] : attachments)
         {
             auto texture = Texture::create(width,
                                            height,
-                                           ImageFormat::RGBA32F,
+                                           format,
                                            TextureParameter::Repeat,
                                            TextureParameter::Repeat,
                                            TextureParameter::Nearest,
@@ -104,14 +108,22 @@ namespace bls
         }
         g_buffer->draw();
 
+        // Create and attach the depth texture, the lighting and the fog sample it to rebuild the position
+        auto depth_texture = Texture::create(width,
+                                             height,
+                                             ImageFormat::Depth24,
+                                             TextureParameter::ClampToEdge,
+                                             TextureParameter::ClampToEdge,
+                                             TextureParameter::Nearest,
+                                             TextureParameter::Nearest);
+
+        textures.push_back({"depth", depth_texture});
+        g_buffer->attach_depth_texture(depth_texture.get());
+
         // Create UI Texture
         auto texture = Texture::create("ui_texture", "bloss1/assets/textures/crosshair.png", TextureType::Diffuse);
         textures.push_back({"ui", texture});
 
-        // Create and attach depth buffer
-        render_buffer = std::unique_ptr<RenderBuffer>(RenderBuffer::create(width, height, AttachmentType::Depth));
-        render_buffer->bind();
-
         // Check if framebuffer is complete
         if (!g_buffer->check()) throw std::runtime_error("framebuffer is not complete");
         g_buffer->unbind();
@@ -193,6 +205,19 @@ namespace bls
         glDrawArrays(opengl_mode, 0, count);
     }
 
+    void OpenGLRenderer::draw_indexed_instanced(RenderingMode mode, u32 count, u32 instance_count, u32 base_instance)
+    {
+        auto opengl_mode = convert_to_opengl_rendering_mode(mode);
+        glDrawElementsInstancedBaseInstance(opengl_mode, count, GL_UNSIGNED_INT, 0, instance_count, base_instance);
+    }
+
+    void OpenGLRenderer::draw_indexed_indirect(RenderingMode mode, u32 first_command, u32 command_count)
+    {
+        auto opengl_mode = convert_to_opengl_rendering_mode(mode);
+        const auto offset = reinterpret_cast<const void *>(first_command * sizeof(DrawIndirectCommand));
+        glMultiDrawElementsIndirect(opengl_mode, GL_UNSIGNED_INT, offset, command_count, 0);
+    }
+
     void OpenGLRenderer::create_skybox(const str &file,
                                        const u32 skybox_resolution,
                                        const u32 irradiance_resolution,
@@ -218,10 +243,9 @@ namespace bls
     }
 
     void OpenGLRenderer::create_height_map(
-        u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 min_distance, f32 max_distance)
+        u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 pixels_per_edge)
     {
-        height_map =
-            std::make_unique<HeightMap>(width, height, min_tess_level, max_tess_level, min_distance, max_distance);
+        height_map = std::make_unique<HeightMap>(width, height, min_tess_level, max_tess_level, pixels_per_edge);
     }
 
     void OpenGLRenderer::create_post_processing_passes(ECS &ecs)
@@ -240,8 +264,7 @@ namespace bls
                                               height,
                                               vec3(0.0f),
                                               vec2(camera->far / 3.0f, camera->far / 2.0f),
-                                              camera->position,
-                                              textures[0].second.get()),
+                                              textures[G_BUFFER_DEPTH_ATTACHMENT].second.get()),
                                   pass_position++);
 
         post_processing->add_pass(new SharpenPass(width, height, 0.05f), pass_position++);
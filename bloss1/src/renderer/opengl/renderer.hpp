@@ -30,6 +30,8 @@ namespace bls
             void clear() override;
             void draw_indexed(RenderingMode mode, u32 count, const void *indices) override;
             void draw_arrays(RenderingMode mode, u32 count) override;
+            void draw_indexed_instanced(RenderingMode mode, u32 count, u32 instance_count, u32 base_instance) override;
+            void draw_indexed_indirect(RenderingMode mode, u32 first_command, u32 command_count) override;
 
             void create_skybox(const str &file,
                                const u32 skybox_resolution,
@@ -38,12 +40,8 @@ namespace bls
                                const u32 prefilter_resolution,
                                const u32 max_mip_levels) override;
             void create_shadow_map(ECS &ecs) override;
-            void create_height_map(u32 width,
-                                   u32 height,
-                                   u32 min_tess_level,
-                                   u32 max_tess_level,
-                                   f32 min_distance,
-                                   f32 max_distance) override;
+            void create_height_map(
+                u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 pixels_per_edge) override;
             void create_post_processing_passes(ECS &ecs) override;
 
             std::map<str, std::shared_ptr<Shader>> &get_shaders() override;
@@ -58,7 +56,6 @@ namespace bls
         private:
             std::unique_ptr<Quad> quad;
             std::unique_ptr<FrameBuffer> g_buffer;
-            std::unique_ptr<RenderBuffer> render_buffer;
             std::map<str, std::shared_ptr<Shader>> shaders;
 
             std::vector<std::pair<str, std::shared_ptr<Texture>>> textures;
@@ -5,8 +5,6 @@
 #include "GLFW/glfw3.h"
 #include "core/logger.hpp"
 
-#define MAX_SHADER_ID 100000007
-
 namespace bls
 {
     OpenGLShader::OpenGLShader(const str &vertex_path,
@@ -14,60 +12,25 @@ namespace bls
                                const str &geometry_path,
                                const str &tess_ctrl_path,
                                const str &tess_eval_path)
+        : OpenGLShader(read_stages(vertex_path, fragment_path, geometry_path, tess_ctrl_path, tess_eval_path))
     {
-        // Create the shaders
-        GLuint vertex_shader_id = glCreateShader(GL_VERTEX_SHADER);
-        GLuint fragment_shader_id = glCreateShader(GL_FRAGMENT_SHADER);
-        GLuint geometry_shader_id = MAX_SHADER_ID;
-        GLuint tess_ctrl_shader_id = MAX_SHADER_ID;
-        GLuint tess_eval_shader_id = MAX_SHADER_ID;
-
-        if (geometry_path != "") geometry_shader_id = glCreateShader(GL_GEOMETRY_SHADER);
-        if (tess_ctrl_path != "") tess_ctrl_shader_id = glCreateShader(GL_TESS_CONTROL_SHADER);
-        if (tess_eval_path != "") tess_eval_shader_id = glCreateShader(GL_TESS_EVALUATION_SHADER);
-
-        str vertex_shader_code, fragment_shader_code, geometry_shader_code;
-        str tess_ctrl_shader_code, tess_eval_shader_code;
-
-        // Read the Vertex Shader code from the file
-        try
-        {
-            vertex_shader_code = get_code_from_file(vertex_path);
-            fragment_shader_code = get_code_from_file(fragment_path);
-
-            if (geometry_path != "") geometry_shader_code = get_code_from_file(geometry_path);
-            if (tess_ctrl_path != "") tess_ctrl_shader_code = get_code_from_file(tess_ctrl_path);
-            if (tess_eval_path != "") tess_eval_shader_code = get_code_from_file(tess_eval_path);
-        }
+    }
 
-        catch (...)
+    OpenGLShader::OpenGLShader(const std::vector<ShaderStage> &stages)
+    {
+        // Create and compile the shaders
+        std::vector<GLuint> shader_ids;
+        for (const auto &stage : stages)
         {
-            LOG_ERROR("error when reading files '%s' and '%s'", vertex_path.c_str(), fragment_path.c_str());
+            shader_ids.push_back(glCreateShader(stage.type));
+            compile_shader(stage.name, stage.code, shader_ids.back());
         }
 
-        // Compile shaders
-        compile_shader(vertex_path, vertex_shader_code, vertex_shader_id);
-        compile_shader(fragment_path, fragment_shader_code, fragment_shader_id);
-
-        if (geometry_path != "" && geometry_shader_id != MAX_SHADER_ID)
-            compile_shader(geometry_path, geometry_shader_code, geometry_shader_id);
-
-        if (tess_ctrl_path != "" && tess_ctrl_shader_id != MAX_SHADER_ID)
-            compile_shader(tess_ctrl_path, tess_ctrl_shader_code, tess_ctrl_shader_id);
-
-        if (tess_eval_path != "" && tess_eval_shader_id != MAX_SHADER_ID)
-            compile_shader(tess_eval_path, tess_eval_shader_code, tess_eval_shader_id);
-
         // Link the program
         LOG_INFO("linking program");
         id = glCreateProgram();
 
-        glAttachShader(id, vertex_shader_id);
-        glAttachShader(id, fragment_shader_id);
-
-        if (geometry_path != "") glAttachShader(id, geometry_shader_id);
-        if (tess_ctrl_path != "") glAttachShader(id, tess_ctrl_shader_id);
-        if (tess_eval_path != "") glAttachShader(id, tess_eval_shader_id);
+        for (const auto shader_id : shader_ids) glAttachShader(id, shader_id);
 
         glLinkProgram(id);
 
@@ -83,27 +46,111 @@ namespace bls
             glGetProgramInfoLog(id, log_length, NULL, &error_message[0]);
 
             LOG_ERROR("linking program");
-            LOG_ERROR("error when linking shader: '%s'", vertex_path.c_str());
+            LOG_ERROR("error when linking shader: '%s'", stages.front().name.c_str());
             LOG_ERROR("error when linking program: '%s'", error_message.data());
 
             throw std::runtime_error("failed to link program");
         }
 
-        glDetachShader(id, vertex_shader_id);
-        glDetachShader(id, fragment_shader_id);
+        for (const auto shader_id : shader_ids)
+        {
+            glDetachShader(id, shader_id);
+            glDeleteShader(shader_id);
+        }
 
-        if (geometry_path != "") glDetachShader(id, geometry_shader_id);
-        if (tess_ctrl_path != "") glDetachShader(id, tess_ctrl_shader_id);
-        if (tess_eval_path != "") glDetachShader(id, tess_eval_shader_id);
+        reflect_uniforms();
 
-        glDeleteShader(vertex_shader_id);
-        glDeleteShader(fragment_shader_id);
+        LOG_SUCCESS("shaders compiled & linked successfully");
+    }
 
-        if (geometry_path != "") glDeleteShader(geometry_shader_id);
-        if (tess_ctrl_path != "") glDeleteShader(tess_ctrl_shader_id);
-        if (tess_eval_path != "") glDeleteShader(tess_eval_shader_id);
+    std::vector<OpenGLShader::ShaderStage> OpenGLShader::get_generated_stages(const str &name,
+                                                                              const str &vertex_path,
+                                                                              const str &fragment_code)
+    {
+        return {{GL_VERTEX_SHADER, vertex_path, get_code_from_file(vertex_path)},
+                {GL_FRAGMENT_SHADER, name + " (generated)", fragment_code}};
+    }
 
-        LOG_SUCCESS("shaders compiled & linked successfully");
+    std::vector<OpenGLShader::ShaderStage> OpenGLShader::read_stages(const str &vertex_path,
+                                                                     const str &fragment_path,
+                                                                     const str &geometry_path,
+                                                                     const str &tess_ctrl_path,
+                                                                     const str &tess_eval_path)
+    {
+        std::vector<ShaderStage> stages = {{GL_VERTEX_SHADER, vertex_path, ""},
+                                           {GL_FRAGMENT_SHADER, fragment_path, ""}};
+
+        if (geometry_path != "") stages.push_back({GL_GEOMETRY_SHADER, geometry_path, ""});
+        if (tess_ctrl_path != "") stages.push_back({GL_TESS_CONTROL_SHADER, tess_ctrl_path, ""});
+        if (tess_eval_path != "") stages.push_back({GL_TESS_EVALUATION_SHADER, tess_eval_path, ""});
+
+        // Read the shader code from the files
+        try
+        {
+            for (auto &stage : stages) stage.code = get_code_from_file(stage.name);
+        }
+
+        catch (...)
+        {
+            LOG_ERROR("error when reading files '%s' and '%s'", vertex_path.c_str(), fragment_path.c_str());
+        }
+
+        return stages;
+    }
+
+    void OpenGLShader::reflect_uniforms()
+    {
+        GLint uniform_count = 0;
+        GLint max_name_length = 0;
+
+        glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &uniform_count);
+        glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+        std::vector<char> name_buffer(max_name_length + 1);
+        for (GLint i = 0; i < uniform_count; i++)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+
+            glGetActiveUniform(id, i, max_name_length, &length, &size, &type, name_buffer.data());
+
+            const str name = str(name_buffer.data(), length);
+            const i32 location = glGetUniformLocation(id, name.c_str());
+
+            // Uniform block members have no location
+            if (location < 0) continue;
+
+            uniform_locations[name] = location;
+
+            // Arrays are reported as 'name[0]': register the bare name and every element
+            if (name.size() > 3 && name.substr(name.size() - 3) == "[0]")
+            {
+                const str base_name = name.substr(0, name.size() - 3);
+                uniform_locations[base_name] = location;
+
+                for (GLint j = 1; j < size; j++)
+                {
+                    const str element_name = base_name + "[" + to_str(j) + "]";
+                    uniform_locations[element_name] = glGetUniformLocation(id, element_name.c_str());
+                }
+            }
+        }
+    }
+
+    i32 OpenGLShader::get_location(const str &name)
+    {
+        auto it = uniform_locations.find(name);
+        if (it != uniform_locations.end()) return it->second;
+
+        // Not an active uniform (optimized out or never declared): remember the miss, GL ignores location -1
+        uniform_locations[name] = -1;
+        return -1;
+    }
+
+    UniformHandle OpenGLShader::get_uniform_handle(const str &name)
+    {
+        return {get_location(name)};
     }
 
     void OpenGLShader::compile_shader(const str &path, const str &code, u32 ID)
@@ -157,55 +204,105 @@ namespace bls
 
     void OpenGLShader::set_uniform1(const str &name, bool value)
     {
-        glUniform1i(glGetUniformLocation(id, name.c_str()), (u32)value);
+        glUniform1i(get_location(name), (u32)value);
     }
 
     void OpenGLShader::set_uniform1(const str &name, u32 value)
     {
-        glUniform1i(glGetUniformLocation(id, name.c_str()), value);
+        glUniform1i(get_location(name), value);
     }
 
     void OpenGLShader::set_uniform1(const str &name, f32 value)
     {
-        glUniform1f(glGetUniformLocation(id, name.c_str()), value);
+        glUniform1f(get_location(name), value);
     }
 
     void OpenGLShader::set_uniform2(const str &name, const vec2 &vector)
     {
-        glUniform2f(glGetUniformLocation(id, name.c_str()), vector.x, vector.y);
+        glUniform2f(get_location(name), vector.x, vector.y);
     }
 
     void OpenGLShader::set_uniform3(const str &name, const vec3 &vector)
     {
-        glUniform3f(glGetUniformLocation(id, name.c_str()), vector.x, vector.y, vector.z);
+        glUniform3f(get_location(name), vector.x, vector.y, vector.z);
     }
 
     void OpenGLShader::set_uniform3(const str &name, const mat3 &matrix)
     {
-        glUniformMatrix3fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, value_ptr(matrix));
+        glUniformMatrix3fv(get_location(name), 1, GL_FALSE, value_ptr(matrix));
     }
 
     void OpenGLShader::set_uniform4(const str &name, const vec4 &vector)
     {
-        glUniform4f(glGetUniformLocation(id, name.c_str()), vector.x, vector.y, vector.z, vector.w);
+        glUniform4f(get_location(name), vector.x, vector.y, vector.z, vector.w);
     }
 
     void OpenGLShader::set_uniform4(const str &name, const mat4 &matrix)
     {
-        glUniformMatrix4fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, value_ptr(matrix));
+        glUniformMatrix4fv(get_location(name), 1, GL_FALSE, value_ptr(matrix));
+    }
+
+    void OpenGLShader::set_uniform1(UniformHandle handle, bool value)
+    {
+        glUniform1i(handle.location, (u32)value);
+    }
+
+    void OpenGLShader::set_uniform1(UniformHandle handle, u32 value)
+    {
+        glUniform1i(handle.location, value);
+    }
+
+    void OpenGLShader::set_uniform1(UniformHandle handle, f32 value)
+    {
+        glUniform1f(handle.location, value);
+    }
+
+    void OpenGLShader::set_uniform2(UniformHandle handle, const vec2 &vector)
+    {
+        glUniform2f(handle.location, vector.x, vector.y);
+    }
+
+    void OpenGLShader::set_uniform3(UniformHandle handle, const vec3 &vector)
+    {
+        glUniform3f(handle.location, vector.x, vector.y, vector.z);
+    }
+
+    void OpenGLShader::set_uniform3(UniformHandle handle, const vec3 *vectors, u32 count)
+    {
+        glUniform3fv(handle.location, count, glm::value_ptr(vectors[0]));
+    }
+
+    void OpenGLShader::set_uniform3(UniformHandle handle, const mat3 &matrix)
+    {
+        glUniformMatrix3fv(handle.location, 1, GL_FALSE, value_ptr(matrix));
+    }
+
+    void OpenGLShader::set_uniform4(UniformHandle handle, const vec4 &vector)
+    {
+        glUniform4f(handle.location, vector.x, vector.y, vector.z, vector.w);
+    }
+
+    void OpenGLShader::set_uniform4(UniformHandle handle, const mat4 &matrix)
+    {
+        glUniformMatrix4fv(handle.location, 1, GL_FALSE, value_ptr(matrix));
+    }
+
+    void OpenGLShader::set_uniform4(UniformHandle handle, const mat4 *matrices, u32 count)
+    {
+        glUniformMatrix4fv(handle.location, count, GL_FALSE, glm::value_ptr(matrices[0]));
     }
 
     vec3 OpenGLShader::get_uniform3(const str &name)
     {
         vec3 vector;
-        glGetUniformfv(id, glGetUniformLocation(id, name.c_str()), value_ptr(vector));
+        glGetUniformfv(id, get_location(name), value_ptr(vector));
         return vector;
     }
 
     mat4 OpenGLShader::get_uniform4(const str &name)
     {
         mat4 matrix;
-        glGetUniformfv(id, glGetUniformLocation(id, name.c_str()), value_ptr(matrix));
+        glGetUniformfv(id, get_location(name), value_ptr(matrix));
         return matrix;
     }
 };  // namespace bls
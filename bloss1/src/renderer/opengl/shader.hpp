@@ -11,16 +11,32 @@ namespace bls
     class OpenGLShader : public Shader
     {
         public:
+            // The stage code and the name shown in the logs (the file path, when read from a file)
+            struct ShaderStage
+            {
+                    u32 type;
+                    str name;
+                    str code;
+            };
+
             OpenGLShader(const str &vertex_path,
                          const str &fragment_path,
                          const str &geometry_path = "",
                          const str &tess_ctrl_path = "",
                          const str &tess_eval_path = "");
+            OpenGLShader(const std::vector<ShaderStage> &stages);
+
+            // Stages of a vertex shader file and generated fragment code
+            static std::vector<ShaderStage> get_generated_stages(const str &name,
+                                                                 const str &vertex_path,
+                                                                 const str &fragment_code);
 
             // Use/activate the shader
             void bind() override;
             void unbind() override;
 
+            UniformHandle get_uniform_handle(const str &name) override;
+
             // Uniform functions
             void set_uniform1(const str &name, bool value) override;
             void set_uniform1(const str &name, u32 value) override;
@@ -34,13 +50,37 @@ namespace bls
             void set_uniform4(const str &name, const vec4 &vector) override;
             void set_uniform4(const str &name, const mat4 &matrix) override;
 
+            // Uniform functions (handles)
+            void set_uniform1(UniformHandle handle, bool value) override;
+            void set_uniform1(UniformHandle handle, u32 value) override;
+            void set_uniform1(UniformHandle handle, f32 value) override;
+
+            void set_uniform2(UniformHandle handle, const vec2 &vector) override;
+
+            void set_uniform3(UniformHandle handle, const vec3 &vector) override;
+            void set_uniform3(UniformHandle handle, const vec3 *vectors, u32 count) override;
+            void set_uniform3(UniformHandle handle, const mat3 &matrix) override;
+
+            void set_uniform4(UniformHandle handle, const vec4 &vector) override;
+            void set_uniform4(UniformHandle handle, const mat4 &matrix) override;
+            void set_uniform4(UniformHandle handle, const mat4 *matrices, u32 count) override;
+
             vec3 get_uniform3(const str &name) override;
             mat4 get_uniform4(const str &name) override;
 
         private:
+            static std::vector<ShaderStage> read_stages(const str &vertex_path,
+                                                        const str &fragment_path,
+                                                        const str &geometry_path,
+                                                        const str &tess_ctrl_path,
+                                                        const str &tess_eval_path);
+
             void compile_shader(const str &path, const str &code, u32 ID);
-            str get_code_from_file(const str &path);
+            static str get_code_from_file(const str &path);
+            void reflect_uniforms();
+            i32 get_location(const str &name);
 
             u32 id;
+            std::unordered_map<str, i32> uniform_locations;
     };
 };  // namespace bls
@@ -5,15 +5,127 @@
 #include "GLFW/glfw3.h"
 #include "core/game.hpp"
 
+#define SKYBOX_CACHE_DIR "bloss1/cache/ibl/"
+#define SKYBOX_CACHE_MAGIC 0x4C424942U  // "BIBL"
+#define SKYBOX_CACHE_VERSION 2U         // Bump when the layout changes
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define FNV_PRIME 0x100000001B3ULL
+
 namespace bls
 {
+    // Sources of the map generation, a change to any of them invalidates the cache
+    static const char *ibl_shader_files[] = {"bloss1/assets/shaders/pbr/hdr_cubemap_converter.vs",
+                                             "bloss1/assets/shaders/pbr/hdr_cubemap_converter.fs",
+                                             "bloss1/assets/shaders/pbr/irradiance_map.vs",
+                                             "bloss1/assets/shaders/pbr/irradiance_map.fs",
+                                             "bloss1/assets/shaders/pbr/prefilter.vs",
+                                             "bloss1/assets/shaders/pbr/prefilter.fs",
+                                             "bloss1/assets/shaders/pbr/brdf.vs",
+                                             "bloss1/assets/shaders/pbr/brdf.fs"};
+
+    static u32 create_cubemap(u32 resolution, bool mipmaps)
+    {
+        u32 cubemap;
+        glGenTextures(1, &cubemap);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+        for (u32 i = 0; i < 6; i++)
+            glTexImage2D(
+                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB32F, resolution, resolution, 0, GL_RGB, GL_FLOAT, nullptr);
+
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // Allocate the whole chain
+        if (mipmaps) glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+
+        return cubemap;
+    }
+
+    // 64 bit FNV-1a
+    static u64 hash_bytes(const void *data, u64 size, u64 hash)
+    {
+        const u8 *bytes = static_cast<const u8 *>(data);
+        for (u64 i = 0; i < size; i++) hash = (hash ^ bytes[i]) * FNV_PRIME;
+
+        return hash;
+    }
+
+    static bool hash_file(const str &file, u64 &hash)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        if (!stream) return false;
+
+        std::vector<char> buffer(1 << 16);
+        while (stream)
+        {
+            stream.read(buffer.data(), buffer.size());
+            hash = hash_bytes(buffer.data(), static_cast<u64>(stream.gcount()), hash);
+        }
+
+        return true;
+    }
+
     OpenGLSkybox::OpenGLSkybox(const str &path,
                                const u32 skybox_resolution,
                                const u32 irradiance_resolution,
                                const u32 brdf_resolution,
                                const u32 prefilter_resolution,
                                const u32 max_mip_levels)
-        : path(path)
+        : path(path),
+          skybox_resolution(skybox_resolution),
+          irradiance_resolution(irradiance_resolution),
+          brdf_resolution(brdf_resolution),
+          prefilter_resolution(prefilter_resolution),
+          max_mip_levels(max_mip_levels)
+    {
+        skybox_shader =
+            Shader::create("skybox", "bloss1/assets/shaders/pbr/skybox.vs", "bloss1/assets/shaders/pbr/skybox.fs");
+
+        skybox_shader->bind();
+        skybox_shader->set_uniform1("environmentMap", 0U);
+
+        // Cube setup
+        cube = new Box(Game::get().get_renderer());
+        quad = new Quad(Game::get().get_renderer());
+
+        captureFBO = nullptr;
+        captureRBO = nullptr;
+
+        // Maps
+        env_cubemap = create_cubemap(skybox_resolution, false);
+        irradiance_map = create_cubemap(irradiance_resolution, false);
+        prefilter_map = create_cubemap(prefilter_resolution, true);  // Pre filtered for specular reflections
+
+        glGenTextures(1, &brdf_texture);
+        glBindTexture(GL_TEXTURE_2D, brdf_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, brdf_resolution, brdf_resolution, 0, GL_RG, GL_FLOAT, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // Fill them from the cache when it has them, or convolve the HDR image and cache the result
+        u64 key;
+        if (!get_cache_key(key))
+        {
+            generate_maps();
+            return;
+        }
+
+        std::stringstream cache_file;
+        cache_file << SKYBOX_CACHE_DIR << std::filesystem::path(path).stem().string() << "_" << std::hex
+                   << std::setw(16) << std::setfill('0') << key << ".ibl";
+
+        if (load_cache(cache_file.str(), key)) return;
+
+        generate_maps();
+        save_cache(cache_file.str(), key);
+    }
+
+    void OpenGLSkybox::generate_maps()
     {
         // Disable face culling during maps creation
         glDisable(GL_CULL_FACE);
@@ -22,21 +134,12 @@ namespace bls
         hdr_to_cubemap_shader = Shader::create("hdr_to_cubemap",
                                                "bloss1/assets/shaders/pbr/hdr_cubemap_converter.vs",
                                                "bloss1/assets/shaders/pbr/hdr_cubemap_converter.fs");
-        skybox_shader =
-            Shader::create("skybox", "bloss1/assets/shaders/pbr/skybox.vs", "bloss1/assets/shaders/pbr/skybox.fs");
         irradiance_shader = Shader::create(
             "irradiance", "bloss1/assets/shaders/pbr/irradiance_map.vs", "bloss1/assets/shaders/pbr/irradiance_map.fs");
         prefilter_shader = Shader::create(
             "prefilter", "bloss1/assets/shaders/pbr/prefilter.vs", "bloss1/assets/shaders/pbr/prefilter.fs");
         brdf_shader = Shader::create("brdf", "bloss1/assets/shaders/pbr/brdf.vs", "bloss1/assets/shaders/pbr/brdf.fs");
 
-        skybox_shader->bind();
-        skybox_shader->set_uniform1("environmentMap", 0U);
-
-        // Cube setup
-        cube = new Box(Game::get().get_renderer());
-        quad = new Quad(Game::get().get_renderer());
-
         // Setup framebuffers
         // -------------------------------------------------------------------------------------------------------------
         captureFBO = FrameBuffer::create();
@@ -44,27 +147,6 @@ namespace bls
 
         hdr_texture = Texture::create(path, path, TextureType::None);
 
-        // Setup cubemap to render to and attach to framebuffer
-        // -------------------------------------------------------------------------------------------------------------
-        glGenTextures(1, &env_cubemap);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, env_cubemap);
-        for (u32 i = 0; i < 6; i++)
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                         0,
-                         GL_RGB32F,
-                         skybox_resolution,
-                         skybox_resolution,
-                         0,
-                         GL_RGB,
-                         GL_FLOAT,
-                         nullptr);
-
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
         // Setup projection and view matrices for capturing data onto the 6 cubemap face directions
         // -------------------------------------------------------------------------------------------------------------
         const mat4 captureProjection = perspective(radians(90.0f), 1.0f, 0.1f, 10.0f);
@@ -105,27 +187,8 @@ namespace bls
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // Create an irradiance cubemap
+        // Irradiance convolution
         // -------------------------------------------------------------------------------------------------------------
-        glGenTextures(1, &irradiance_map);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, irradiance_map);
-        for (u32 i = 0; i < 6; i++)
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                         0,
-                         GL_RGB32F,
-                         irradiance_resolution,
-                         irradiance_resolution,
-                         0,
-                         GL_RGB,
-                         GL_FLOAT,
-                         nullptr);
-
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
         captureFBO->bind();
         captureRBO->bind();
         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, irradiance_resolution, irradiance_resolution);
@@ -160,30 +223,6 @@ namespace bls
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // Configure pre filtering map for specular reflections
-        // -------------------------------------------------------------------------------------------------------------
-        glGenTextures(1, &prefilter_map);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, prefilter_map);
-
-        for (u32 i = 0; i < 6; i++)
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                         0,
-                         GL_RGB32F,
-                         prefilter_resolution,
-                         prefilter_resolution,
-                         0,
-                         GL_RGB,
-                         GL_FLOAT,
-                         nullptr);
-
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-
         // Pre-filter the environment map
         // -------------------------------------------------------------------------------------------------------------
         prefilter_shader->bind();
@@ -223,18 +262,8 @@ namespace bls
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // Generate texture for the BRDF convolution
+        // BRDF convolution
         // -------------------------------------------------------------------------------------------------------------
-        glGenTextures(1, &brdf_texture);
-
-        // Pre-allocate enough memory for the BRDF texture.
-        glBindTexture(GL_TEXTURE_2D, brdf_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, brdf_resolution, brdf_resolution, 0, GL_RG, GL_FLOAT, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
         captureFBO->bind();
         captureRBO->bind();
         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, brdf_resolution, brdf_resolution);
@@ -259,6 +288,139 @@ namespace bls
         glEnable(GL_CULL_FACE);
     }
 
+    bool OpenGLSkybox::get_cache_key(u64 &key) const
+    {
+        key = FNV_OFFSET_BASIS;
+        if (!hash_file(path, key)) return false;
+
+        for (const auto *file : ibl_shader_files)
+            if (!hash_file(file, key)) return false;
+
+        const CacheHeader header = get_cache_header(0);
+        key = hash_bytes(&header, sizeof(header), key);
+
+        return true;
+    }
+
+    OpenGLSkybox::CacheHeader OpenGLSkybox::get_cache_header(u64 key) const
+    {
+        return {SKYBOX_CACHE_MAGIC,
+                SKYBOX_CACHE_VERSION,
+                skybox_resolution,
+                irradiance_resolution,
+                brdf_resolution,
+                prefilter_resolution,
+                max_mip_levels,
+                0,
+                key};
+    }
+
+    std::vector<OpenGLSkybox::CacheImage> OpenGLSkybox::get_cache_images() const
+    {
+        std::vector<CacheImage> images;
+        for (u32 i = 0; i < 6; i++)
+        {
+            const u32 face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
+
+            images.push_back({env_cubemap, face, 0, skybox_resolution, GL_RGB, 3});
+            images.push_back({irradiance_map, face, 0, irradiance_resolution, GL_RGB, 3});
+
+            for (u32 mip = 0; mip < max_mip_levels; mip++)
+                images.push_back({prefilter_map, face, mip, max(prefilter_resolution >> mip, 1U), GL_RGB, 3});
+        }
+
+        images.push_back({brdf_texture, GL_TEXTURE_2D, 0, brdf_resolution, GL_RG, 2});
+
+        return images;
+    }
+
+    bool OpenGLSkybox::load_cache(const str &file, u64 key)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        if (!stream) return false;
+
+        // The file name has the key, the header guards against collisions and files of another version
+        CacheHeader header = {};
+        const CacheHeader expected = get_cache_header(key);
+
+        stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!stream || std::memcmp(&header, &expected, sizeof(header)) != 0) return false;
+
+        const auto images = get_cache_images();
+
+        u64 count = 0;
+        for (const auto &image : images) count += static_cast<u64>(image.size) * image.size * image.channels;
+
+        std::vector<f32> data(count);
+        stream.read(reinterpret_cast<char *>(data.data()), count * sizeof(f32));
+        if (!stream || stream.peek() != std::ifstream::traits_type::eof())
+        {
+            LOG_WARNING("skybox cache '%s' is truncated", file.c_str());
+            return false;
+        }
+
+        LOG_INFO("loading skybox maps from cache '%s'", file.c_str());
+
+        // The driver converts the floats to the formats of the maps
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        const f32 *pixels = data.data();
+        for (const auto &image : images)
+        {
+            glBindTexture(image.target == GL_TEXTURE_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, image.texture);
+            glTexSubImage2D(
+                image.target, image.level, 0, 0, image.size, image.size, image.format, GL_FLOAT, pixels);
+
+            pixels += static_cast<u64>(image.size) * image.size * image.channels;
+        }
+
+        return true;
+    }
+
+    void OpenGLSkybox::save_cache(const str &file, u64 key)
+    {
+        const auto images = get_cache_images();
+
+        u64 count = 0;
+        for (const auto &image : images) count += static_cast<u64>(image.size) * image.size * image.channels;
+
+        // Read the maps back as full floats: bright texels of an HDR (e.g. the sun) go past the half float range
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        std::vector<f32> data(count);
+        f32 *pixels = data.data();
+        for (const auto &image : images)
+        {
+            glBindTexture(image.target == GL_TEXTURE_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, image.texture);
+            glGetTexImage(image.target, image.level, image.format, GL_FLOAT, pixels);
+
+            pixels += static_cast<u64>(image.size) * image.size * image.channels;
+        }
+
+        // Written under another name then renamed, so an interrupted write never leaves a file that looks complete
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(file).parent_path(), error);
+
+        const str temporary_file = file + ".tmp";
+        const CacheHeader header = get_cache_header(key);
+
+        std::ofstream stream(temporary_file, std::ios::binary);
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char *>(data.data()), count * sizeof(f32));
+        stream.close();
+
+        if (stream) std::filesystem::rename(temporary_file, file, error);
+
+        if (!stream || error)
+        {
+            LOG_WARNING("failed to write skybox cache '%s'", file.c_str());
+            std::filesystem::remove(temporary_file, error);
+            return;
+        }
+
+        LOG_INFO("saved skybox maps to cache '%s'", file.c_str());
+    }
+
     OpenGLSkybox::~OpenGLSkybox()
     {
         delete cube;
@@ -269,6 +431,7 @@ namespace bls
 
         glDeleteTextures(1, &env_cubemap);
         glDeleteTextures(1, &irradiance_map);
+        glDeleteTextures(1, &prefilter_map);
         glDeleteTextures(1, &brdf_texture);
     }
 
@@ -287,7 +450,7 @@ namespace bls
         glBindTextureUnit(slot + 2, brdf_texture);
     }
 
-    void OpenGLSkybox::draw(const mat4 &view, const mat4 &projection)
+    void OpenGLSkybox::draw()
     {
         // Disable face culling during drawing
         glDisable(GL_CULL_FACE);
@@ -295,8 +458,6 @@ namespace bls
 
         // Render cubemap
         skybox_shader->bind();
-        skybox_shader->set_uniform4("view", view);
-        skybox_shader->set_uniform4("projection", projection);
 
         glBindTextureUnit(0, env_cubemap);
 
@@ -24,11 +24,39 @@ namespace bls
             ~OpenGLSkybox();
 
             void bind(Shader &shader, u32 slot) override;
-            void draw(const mat4 &view, const mat4 &projection) override;
+            void draw() override;
             str get_path() const override;
 
         private:
+            // Convolve the HDR environment into the maps with GPU passes
+            void generate_maps();
+
+            // The precomputed maps are kept in a file keyed by a hash of the HDR image, the shaders that generate them
+            // and the resolutions. No key means the cache cannot be used (missing source file)
+            struct CacheHeader
+            {
+                    u32 magic, version;
+                    u32 skybox_resolution, irradiance_resolution, brdf_resolution, prefilter_resolution;
+                    u32 max_mip_levels, padding;
+                    u64 key;
+            };
+
+            // One level of one face of a map, in the order of the cache file (floats)
+            struct CacheImage
+            {
+                    u32 texture, target;  // Cube map face or 2D texture
+                    u32 level, size;
+                    u32 format, channels;
+            };
+
+            bool get_cache_key(u64 &key) const;
+            CacheHeader get_cache_header(u64 key) const;
+            std::vector<CacheImage> get_cache_images() const;
+            bool load_cache(const str &file, u64 key);
+            void save_cache(const str &file, u64 key);
+
             str path;
+            u32 skybox_resolution, irradiance_resolution, brdf_resolution, prefilter_resolution, max_mip_levels;
             std::shared_ptr<Shader> hdr_to_cubemap_shader;
             std::shared_ptr<Shader> skybox_shader;
             std::shared_ptr<Shader> irradiance_shader, prefilter_shader, brdf_shader;
@@ -19,10 +19,18 @@ namespace bls
                 return GL_RGB8;
             case ImageFormat::RGBA8:
                 return GL_RGBA8;
+            case ImageFormat::RGBA16F:
+                return GL_RGBA16F;
+            case ImageFormat::RG16:
+                return GL_RG16;
+            case ImageFormat::R32F:
+                return GL_R32F;
             case ImageFormat::RGB32F:
                 return GL_RGB32F;
             case ImageFormat::RGBA32F:
                 return GL_RGBA32F;
+            case ImageFormat::Depth24:
+                return GL_DEPTH_COMPONENT24;
             default:
                 throw std::runtime_error("invalid image format\n");
         }
@@ -3,8 +3,13 @@
 #include "config.hpp"
 #include "core/game.hpp"
 #include "renderer/primitives/quad.hpp"
+#include "renderer/render_graph.hpp"
 #include "renderer/shader.hpp"
 
+#define POST_VERTEX_PATH "bloss1/assets/shaders/post/base.vs"
+#define POST_FUSED_HEADER_PATH "bloss1/assets/shaders/post/fused.glsl"
+#define BLOOM_MAX_LEVELS 8U
+
 namespace bls
 {
     class RenderPass
@@ -15,21 +20,7 @@ namespace bls
                 this->width = width;
                 this->height = height;
 
-                // Create a fbo and a color attachment texture to render the scene
-                fbo = std::unique_ptr<FrameBuffer>(FrameBuffer::create());
-                screen_texture = Texture::create(width,
-                                                 height,
-                                                 ImageFormat::RGB8,
-                                                 TextureParameter::Repeat,
-                                                 TextureParameter::Repeat,
-                                                 TextureParameter::Linear,
-                                                 TextureParameter::Linear);
-                fbo->attach_texture(screen_texture.get());
-                rbo_depth = std::unique_ptr<RenderBuffer>(RenderBuffer::create(width, height, AttachmentType::Depth));
-
-                fbo->check();
-                fbo->unbind();
-
+                // The input and output targets belong to the render graph
                 quad = std::make_unique<Quad>(Game::get().get_renderer());
             }
 
@@ -37,38 +28,120 @@ namespace bls
             {
             }
 
-            virtual void bind()
+            // Draw 'input' through the pass into the bound target
+            virtual void render(Texture &input)
             {
-                auto &renderer = Game::get().get_renderer();
+                shader->bind();
 
-                fbo->bind();
+                // A per pixel pass runs its snippet alone
+                u32 texture_slot = 1;
+                set_fused_uniforms(*shader, get_fused_prefix(0), texture_slot);
 
-                renderer.clear();
-                renderer.clear_color(vec4(0.0f, 0.0f, 0.0f, 1.0f));
+                draw_input(input);
             }
 
-            virtual void unbind()
+            virtual str get_name() = 0;
+
+            // Declare the draws of the pass: 'reads' starts with 'input', 'output' is written last. A pass drawing
+            // once renders the input into the output, the ones drawing more add their own passes and targets
+            virtual void add_to_graph(RenderGraph &graph,
+                                      RenderResource input,
+                                      RenderResource output,
+                                      const std::vector<RenderResource> &reads)
             {
-                fbo->unbind();
+                graph.add_pass(get_name(),
+                               reads,
+                               {output},
+                               [this, input](RenderGraph &frame_graph) { render(frame_graph.get_texture(input)); });
             }
 
-            virtual void render()
+            // Passes sampling the G-buffer (e.g. its depth) are ordered after the geometry pass
+            virtual bool reads_g_buffer()
             {
-                shader->bind();
-                screen_texture->bind(0);
+                return false;
+            }
+
+            // Per pixel passes (a pixel only reads the same input pixel) can be fused with their neighbours in a
+            // single shader. Their GLSL snippet defines 'vec4 $apply(vec4 color, vec2 uv)' where '$' is replaced by a
+            // prefix per pass. Passes that read a neighbourhood return no snippet and are never fused
+            virtual str get_fused_snippet_path()
+            {
+                return "";
+            }
+
+            // Set the uniforms of the snippet, the extra textures are bound from 'texture_slot' on
+            virtual void set_fused_uniforms(Shader &, const str &, u32 &)
+            {
+            }
+
+            bool is_fusable()
+            {
+                return !get_fused_snippet_path().empty();
+            }
+
+            // Draw the full screen quad reading the input (the bound shader writes the output)
+            void draw_input(Texture &input)
+            {
+                input.bind(0);
                 quad->render();
             }
 
-            virtual str get_name() = 0;
+            static str get_fused_prefix(u64 index)
+            {
+                return "pass" + to_str(index) + "_";
+            }
+
+            // Fragment shader applying the passes in order to the sampled input, so the run costs one full screen
+            // read and write instead of one per pass
+            static str get_fused_code(const std::vector<RenderPass *> &passes)
+            {
+                str code = read_code(POST_FUSED_HEADER_PATH);
+                str body;
+
+                for (u64 i = 0; i < passes.size(); i++)
+                {
+                    const str prefix = get_fused_prefix(i);
+
+                    str snippet = read_code(passes[i]->get_fused_snippet_path());
+                    for (u64 pos = snippet.find('$'); pos != str::npos; pos = snippet.find('$', pos + prefix.size()))
+                        snippet.replace(pos, 1, prefix);
+
+                    code += "\n" + snippet;
+                    body += "    color = " + prefix + "apply(color, fs_in.TexCoords);\n";
+                }
+
+                code += "\nvoid main() {\n";
+                code += "    vec4 color = texture(screenTexture, fs_in.TexCoords);\n";
+                code += body;
+                code += "    fragColor = color;\n}\n";
+
+                return code;
+            }
+
+            // Shaders are kept by name, the same run of pass types reuses its shader
+            static std::shared_ptr<Shader> create_fused_shader(const std::vector<RenderPass *> &passes)
+            {
+                str name = "fused";
+                for (auto *pass : passes) name += "_" + pass->get_name();
+
+                return Shader::create_generated(name, POST_VERTEX_PATH, get_fused_code(passes));
+            }
 
         protected:
+            static str read_code(const str &path)
+            {
+                std::ifstream stream(path);
+                if (!stream) throw std::runtime_error("failed to read shader snippet: '" + path + "'");
+
+                std::stringstream sstr;
+                sstr << stream.rdbuf();
+                return sstr.str();
+            }
+
             u32 width, height;
 
             std::shared_ptr<Shader> shader;
             std::unique_ptr<Quad> quad;
-            std::unique_ptr<FrameBuffer> fbo;
-            std::shared_ptr<Texture> screen_texture;
-            std::unique_ptr<RenderBuffer> rbo_depth;
     };
 
     class BasePass : public RenderPass
@@ -76,12 +149,16 @@ namespace bls
         public:
             BasePass(u32 width, u32 height) : RenderPass(width, height)
             {
-                shader = Shader::create(
-                    "base_pass", "bloss1/assets/shaders/post/base.vs", "bloss1/assets/shaders/post/base.fs");
+                shader = create_fused_shader({this});
                 shader->bind();
                 shader->set_uniform1("screenTexture", 0U);
             }
 
+            str get_fused_snippet_path() override
+            {
+                return "bloss1/assets/shaders/post/base.glsl";
+            }
+
             str get_name() override
             {
                 return "BasePass";
@@ -95,33 +172,34 @@ namespace bls
                     u32 height,
                     const vec3 &fog_color,
                     const vec2 &min_max,
-                    const vec3 &camera_position,
-                    Texture *position_texture)
+                    Texture *depth_texture)
                 : RenderPass(width, height),
                   fog_color(fog_color),
                   min_max(min_max),
-                  camera_position(camera_position),
-                  position_texture(position_texture)
+                  depth_texture(depth_texture)
             {
-                shader =
-                    Shader::create("fog", "bloss1/assets/shaders/post/base.vs", "bloss1/assets/shaders/post/fog.fs");
+                shader = create_fused_shader({this});
                 shader->bind();
-                shader->set_uniform1("textures.screenTexture", 0U);
-                shader->set_uniform1("textures.positionTexture", 1U);
+                shader->set_uniform1("screenTexture", 0U);
             }
 
-            void render()
+            str get_fused_snippet_path() override
             {
-                shader->bind();
+                return "bloss1/assets/shaders/post/fog.glsl";
+            }
 
-                shader->set_uniform2("fogMinMax", min_max);
-                shader->set_uniform3("fogColor", fog_color);
-                shader->set_uniform3("viewPos", camera_position);
+            void set_fused_uniforms(Shader &shader, const str &prefix, u32 &texture_slot) override
+            {
+                shader.set_uniform2(prefix + "fogMinMax", min_max);
+                shader.set_uniform3(prefix + "fogColor", fog_color);
 
-                screen_texture->bind(0);
-                position_texture->bind(1);
+                shader.set_uniform1(prefix + "depthTexture", texture_slot);
+                depth_texture->bind(texture_slot++);
+            }
 
-                quad->render();
+            bool reads_g_buffer() override
+            {
+                return true;
             }
 
             str get_name() override
@@ -131,8 +209,7 @@ namespace bls
 
             vec3 fog_color;
             vec2 min_max;
-            const vec3 &camera_position;
-            Texture *position_texture;
+            Texture *depth_texture;  // G-buffer depth, the position is rebuilt from it
     };
 
     class BloomPass : public RenderPass
@@ -145,20 +222,103 @@ namespace bls
                     "bloom", "bloss1/assets/shaders/post/base.vs", "bloss1/assets/shaders/post/bloom.fs");
                 shader->bind();
                 shader->set_uniform1("screenTexture", 0U);
-            }
+                shader->set_uniform1("bloomTexture", 1U);
+
+                downsample_shader = Shader::create("bloom_downsample",
+                                                   "bloss1/assets/shaders/post/base.vs",
+                                                   "bloss1/assets/shaders/post/bloom_downsample.fs");
+                downsample_shader->bind();
+                downsample_shader->set_uniform1("screenTexture", 0U);
+
+                upsample_shader = Shader::create("bloom_upsample",
+                                                 "bloss1/assets/shaders/post/base.vs",
+                                                 "bloss1/assets/shaders/post/bloom_upsample.fs");
+                upsample_shader->bind();
+                upsample_shader->set_uniform1("screenTexture", 0U);
+                upsample_shader->set_uniform1("levelTexture", 1U);
+            }
+
+            // Mip chain: the bright pixels are downsampled level by level, then each level is upsampled and added to
+            // the one above it. Every level widens the blur, so a larger radius costs a level, not a wider kernel
+            void add_to_graph(RenderGraph &graph,
+                              RenderResource input,
+                              RenderResource output,
+                              const std::vector<RenderResource> &reads) override
+            {
+                const auto input_desc = graph.get_desc(input);
+                const u32 levels = get_levels();
+
+                std::vector<RenderResource> down_levels;
+                RenderResource source = input;
+                for (u32 i = 0; i < levels; i++)
+                {
+                    const RenderTargetDesc desc = {max(input_desc.width >> (i + 1), 1U),
+                                                   max(input_desc.height >> (i + 1), 1U),
+                                                   ImageFormat::RGBA16F,
+                                                   false};
+
+                    const auto level = graph.create_texture("bloom_down_" + to_str(i), desc);
+                    graph.add_pass("bloom_downsample",
+                                   {source},
+                                   {level},
+                                   [this, source, i](RenderGraph &frame_graph)
+                                   {
+                                       downsample_shader->bind();
+                                       downsample_shader->set_uniform1("prefilter", i == 0);
+                                       downsample_shader->set_uniform1("threshold", threshold);
+
+                                       frame_graph.get_texture(source).bind(0);
+                                       quad->render();
+                                   });
+
+                    down_levels.push_back(level);
+                    source = level;
+                }
 
-            void render()
-            {
-                shader->bind();
+                // Back up to the first level, each one adds its own blur to the wider ones below
+                RenderResource bloom = down_levels.back();
+                for (u32 i = levels - 1; i-- > 0;)
+                {
+                    const auto level = down_levels[i];
+                    const auto level_desc = graph.get_desc(level);
+                    const auto target = graph.create_texture("bloom_up_" + to_str(i), level_desc);
+                    graph.add_pass("bloom_upsample",
+                                   {bloom, level},
+                                   {target},
+                                   [this, bloom, level](RenderGraph &frame_graph)
+                                   {
+                                       upsample_shader->bind();
+
+                                       frame_graph.get_texture(bloom).bind(0);
+                                       frame_graph.get_texture(level).bind(1);
+                                       quad->render();
+                                   });
+
+                    bloom = target;
+                }
 
-                shader->set_uniform1("samples", samples);
-                shader->set_uniform1("spread", spread);
-                shader->set_uniform1("threshold", threshold);
-                shader->set_uniform1("amount", amount);
+                auto composite_reads = reads;
+                composite_reads.push_back(bloom);
 
-                screen_texture->bind(0);
+                graph.add_pass(get_name(),
+                               composite_reads,
+                               {output},
+                               [this, input, bloom, levels](RenderGraph &frame_graph)
+                               {
+                                   shader->bind();
+                                   shader->set_uniform1("levels", levels);
+                                   shader->set_uniform1("amount", amount);
 
-                quad->render();
+                                   frame_graph.get_texture(bloom).bind(1);
+                                   draw_input(frame_graph.get_texture(input));
+                               });
+            }
+
+            // Enough levels for the blur to reach the old kernel extent ('samples' taps 'spread' pixels apart)
+            u32 get_levels() const
+            {
+                const f32 extent = max(static_cast<f32>(samples) * spread, 2.0f);
+                return glm::clamp(static_cast<u32>(std::ceil(std::log2(extent))), 1U, BLOOM_MAX_LEVELS);
             }
 
             str get_name() override
@@ -170,6 +330,9 @@ namespace bls
             f32 spread;
             f32 threshold;
             f32 amount;
+
+        private:
+            std::shared_ptr<Shader> downsample_shader, upsample_shader;
     };
 
     class SharpenPass : public RenderPass
@@ -183,12 +346,12 @@ namespace bls
                 shader->set_uniform1("screenTexture", 0U);
             }
 
-            void render()
+            void render(Texture &input) override
             {
                 shader->bind();
                 shader->set_uniform1("amount", amount);
 
-                screen_texture->bind(0);
+                input.bind(0);
                 quad->render();
             }
 
@@ -205,20 +368,19 @@ namespace bls
         public:
             PosterizationPass(u32 width, u32 height, f32 levels) : RenderPass(width, height), levels(levels)
             {
-                shader = Shader::create("posterization",
-                                        "bloss1/assets/shaders/post/base.vs",
-                                        "bloss1/assets/shaders/post/posterization.fs");
+                shader = create_fused_shader({this});
                 shader->bind();
                 shader->set_uniform1("screenTexture", 0U);
             }
 
-            void render()
+            str get_fused_snippet_path() override
             {
-                shader->bind();
-                shader->set_uniform1("levels", levels);
+                return "bloss1/assets/shaders/post/posterization.glsl";
+            }
 
-                screen_texture->bind(0);
-                quad->render();
+            void set_fused_uniforms(Shader &shader, const str &prefix, u32 &) override
+            {
+                shader.set_uniform1(prefix + "levels", levels);
             }
 
             str get_name() override
@@ -240,12 +402,12 @@ namespace bls
                 shader->set_uniform1("screenTexture", 0U);
             }
 
-            void render()
+            void render(Texture &input) override
             {
                 shader->bind();
                 shader->set_uniform1("pixelSize", pixel_size);
 
-                screen_texture->bind(0);
+                input.bind(0);
                 quad->render();
             }
 
@@ -268,10 +430,10 @@ namespace bls
                 shader->set_uniform1("screenTexture", 0U);
             }
 
-            void render()
+            void render(Texture &input) override
             {
                 shader->bind();
-                screen_texture->bind(0);
+                input.bind(0);
                 quad->render();
             }
 
@@ -293,14 +455,14 @@ namespace bls
                 shader->set_uniform1("textures.screenTexture", 0U);
             }
 
-            void render()
+            void render(Texture &input) override
             {
                 shader->bind();
 
                 shader->set_uniform3("edge_color", color);
                 shader->set_uniform1("threshold", threshold);
 
-                screen_texture->bind(0);
+                input.bind(0);
 
                 quad->render();
             }
@@ -320,22 +482,20 @@ namespace bls
             VignettePass(u32 width, u32 height, f32 lens_radius, f32 lens_feathering)
                 : RenderPass(width, height), lens_radius(lens_radius), lens_feathering(lens_feathering)
             {
-                shader = Shader::create(
-                    "vignette", "bloss1/assets/shaders/post/base.vs", "bloss1/assets/shaders/post/vignette.fs");
+                shader = create_fused_shader({this});
                 shader->bind();
-                shader->set_uniform1("textures.screenTexture", 0U);
+                shader->set_uniform1("screenTexture", 0U);
             }
 
-            void render()
+            str get_fused_snippet_path() override
             {
-                shader->bind();
-
-                shader->set_uniform1("lens_radius", lens_radius);
-                shader->set_uniform1("lens_feathering", lens_feathering);
-
-                screen_texture->bind(0);
+                return "bloss1/assets/shaders/post/vignette.glsl";
+            }
 
-                quad->render();
+            void set_fused_uniforms(Shader &shader, const str &prefix, u32 &) override
+            {
+                shader.set_uniform1(prefix + "lens_radius", lens_radius);
+                shader.set_uniform1(prefix + "lens_feathering", lens_feathering);
             }
 
             str get_name() override
@@ -354,18 +514,66 @@ namespace bls
                 shader = Shader::create(
                     "kuwahara", "bloss1/assets/shaders/post/base.vs", "bloss1/assets/shaders/post/kuwahara.fs");
                 shader->bind();
-                shader->set_uniform1("textures.screenTexture", 0U);
-            }
-
-            void render()
-            {
-                shader->bind();
+                shader->set_uniform1("screenTexture", 0U);
+                shader->set_uniform1("leftTexture", 1U);
+                shader->set_uniform1("rightTexture", 2U);
+
+                rows_shader = Shader::create("kuwahara_rows",
+                                             "bloss1/assets/shaders/post/base.vs",
+                                             "bloss1/assets/shaders/post/kuwahara_rows.fs");
+                rows_shader->bind();
+                rows_shader->set_uniform1("screenTexture", 0U);
+            }
+
+            // The quadrant sums are box filters, so they are split in rows and columns: the left and right half rows
+            // of every pixel are averaged first, then the vertical pass sums them above and below the pixel. The cost
+            // is linear in the radius. The result is approximately the full kernel's: the variance is taken over the
+            // summed channels (mean squared length minus squared mean) instead of per channel
+            void add_to_graph(RenderGraph &graph,
+                              RenderResource input,
+                              RenderResource output,
+                              const std::vector<RenderResource> &reads) override
+            {
+                auto desc = graph.get_desc(input);
+                // Mean color and mean squared length. The variance subtracts one from the other, half floats
+                // lose it in flat regions and the quadrant choice would flip
+                desc.format = ImageFormat::RGBA32F;
+                desc.depth = false;
+
+                RenderResource halves[2];
+                for (u32 side = 0; side < 2; side++)
+                {
+                    halves[side] = graph.create_texture(side == 0 ? "kuwahara_left" : "kuwahara_right", desc);
+                    graph.add_pass("kuwahara_rows",
+                                   {input},
+                                   {halves[side]},
+                                   [this, input, side](RenderGraph &frame_graph)
+                                   {
+                                       rows_shader->bind();
+                                       rows_shader->set_uniform1("radius", radius);
+                                       rows_shader->set_uniform1("side", side == 0 ? -1.0f : 1.0f);
+
+                                       frame_graph.get_texture(input).bind(0);
+                                       quad->render();
+                                   });
+                }
 
-                shader->set_uniform1("radius", radius);
+                auto columns_reads = reads;
+                columns_reads.push_back(halves[0]);
+                columns_reads.push_back(halves[1]);
 
-                screen_texture->bind(0);
+                graph.add_pass(get_name(),
+                               columns_reads,
+                               {output},
+                               [this, input, left = halves[0], right = halves[1]](RenderGraph &frame_graph)
+                               {
+                                   shader->bind();
+                                   shader->set_uniform1("radius", radius);
 
-                quad->render();
+                                   frame_graph.get_texture(left).bind(1);
+                                   frame_graph.get_texture(right).bind(2);
+                                   draw_input(frame_graph.get_texture(input));
+                               });
             }
 
             str get_name() override
@@ -374,6 +582,9 @@ namespace bls
             }
 
             u32 radius;
+
+        private:
+            std::shared_ptr<Shader> rows_shader;
     };
 
     class PostProcessingSystem
@@ -386,6 +597,13 @@ namespace bls
                     bool enabled;
             };
 
+            // One draw of the chain: a pass alone, or a run of per pixel passes fused in one shader
+            struct ChainStep
+            {
+                    std::vector<RenderPass *> passes;
+                    std::shared_ptr<Shader> shader;  // Only set for fused runs
+            };
+
         public:
             // Always add a base pass
             PostProcessingSystem(u32 width, u32 height)
@@ -412,6 +630,8 @@ namespace bls
                 {
                     if (pass.id == id)
                     {
+                        if (pass.position == position && pass.enabled == enabled) return;
+
                         pass.position = position;
                         pass.enabled = enabled;
                         break;
@@ -421,38 +641,108 @@ namespace bls
                 sort_render_passes();
             }
 
-            void begin()
+            // Declare the chain in the graph: the first step reads 'input', each other step reads the output of the
+            // step before and the last one writes 'output'. The targets in between are transient, so the graph
+            // ping-pongs them between two targets however long the chain is. When the input is smaller than the
+            // output (dynamic resolution) the chain runs at the input size and a last draw upscales it
+            void add_to_graph(RenderGraph &graph, RenderResource input, RenderResource output, RenderResource g_buffer)
+            {
+                // The chain follows the enabled passes and their order
+                if (get_chain_signature() != chain_signature) build_chain();
+
+                auto desc = graph.get_desc(input);
+                desc.depth = false;
+
+                const auto output_desc = graph.get_desc(output);
+                const bool upscale = desc.width != output_desc.width || desc.height != output_desc.height;
+
+                for (u64 i = 0; i < chain.size(); i++)
+                {
+                    const bool last = i + 1 == chain.size() && !upscale;
+                    const auto target = last ? output : graph.create_texture("post_" + to_str(i), desc);
+
+                    std::vector<RenderResource> reads = {input};
+                    for (auto *pass : chain[i].passes)
+                        if (pass->reads_g_buffer() && g_buffer != RENDER_RESOURCE_NONE) reads.push_back(g_buffer);
+
+                    // A pass alone declares its own draws, a fused run is one draw
+                    if (!chain[i].shader)
+                        chain[i].passes.front()->add_to_graph(graph, input, target, reads);
+
+                    else
+                        graph.add_pass(chain[i].passes.front()->get_name(),
+                                       reads,
+                                       {target},
+                                       [this, i, input](RenderGraph &frame_graph)
+                                       { render_step(chain[i], frame_graph.get_texture(input)); });
+
+                    input = target;
+                }
+
+                // The base pass only copies its input, drawn to the larger output it filters it bilinearly
+                if (upscale)
+                    graph.add_pass("upscale",
+                                   {input},
+                                   {output},
+                                   [this, input](RenderGraph &frame_graph)
+                                   { passes.front().render_pass->render(frame_graph.get_texture(input)); });
+            }
+
+            // Number of full screen draws of the chain
+            u32 get_chain_size() const
             {
-                passes.front().render_pass->bind();
+                return static_cast<u32>(chain.size());
             }
 
-            void end()
+        private:
+            std::vector<u32> get_chain_signature() const
             {
-                passes.front().render_pass->unbind();
+                std::vector<u32> signature;
+                for (const auto &pass : passes)
+                    if (pass.enabled) signature.push_back(pass.id);
+
+                return signature;
+            }
 
-                // Make a copy with only enabled passes
-                std::vector<PostProcessingPass> enabled_passes;
+            void build_chain()
+            {
+                chain.clear();
+                chain_signature = get_chain_signature();
 
-                // Filter passes
+                // A per pixel pass joins the run before it, any other pass is a step of its own
                 for (const auto &pass : passes)
-                    if (pass.enabled) enabled_passes.push_back(pass);
+                {
+                    if (!pass.enabled) continue;
 
-                // Render all passes in the provided order
-                for (u64 i = 1; i < enabled_passes.size(); i++)
+                    auto *render_pass = pass.render_pass;
+                    if (!chain.empty() && render_pass->is_fusable() && chain.back().passes.back()->is_fusable())
+                        chain.back().passes.push_back(render_pass);
+
+                    else
+                        chain.push_back({{render_pass}, nullptr});
+                }
+
+                for (auto &step : chain)
                 {
-                    auto &prev_pass = enabled_passes[i - 1];
-                    auto &curr_pass = enabled_passes[i];
+                    if (step.passes.size() < 2) continue;
 
-                    curr_pass.render_pass->bind();    // Bind texture for post processing
-                    prev_pass.render_pass->render();  // Render scene to texture
-                    curr_pass.render_pass->unbind();  // Unbind post processing texture
+                    step.shader = RenderPass::create_fused_shader(step.passes);
+                    step.shader->bind();
+                    step.shader->set_uniform1("screenTexture", 0U);
                 }
+            }
+
+            void render_step(ChainStep &step, Texture &input)
+            {
+                step.shader->bind();
 
-                // Render final pass
-                enabled_passes.back().render_pass->render();
+                u32 texture_slot = 1;
+                for (u64 i = 0; i < step.passes.size(); i++)
+                    step.passes[i]->set_fused_uniforms(*step.shader, RenderPass::get_fused_prefix(i), texture_slot);
+
+                step.passes.front()->draw_input(input);
             }
 
-        private:
             void sort_render_passes()
             {
                 // Sort in ascending order
@@ -485,5 +775,8 @@ namespace bls
 
             std::set<u32> available_ids;
             std::vector<PostProcessingPass> passes;
+
+            std::vector<ChainStep> chain;
+            std::vector<u32> chain_signature;
     };
 };  // namespace bls
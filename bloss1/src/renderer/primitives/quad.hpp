@@ -43,6 +43,18 @@ namespace bls
                 vao->unbind();
             };
 
+            void render_instanced(u32 instance_count)
+            {
+                vao->bind();
+                renderer.draw_indexed_instanced(RenderingMode::Triangles, indices.size(), instance_count);
+                vao->unbind();
+            };
+
+            VertexArray *get_vertex_array()
+            {
+                return vao;
+            };
+
         private:
             Renderer &renderer;
             VertexArray *vao;
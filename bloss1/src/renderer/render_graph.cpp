@@ -0,0 +1,265 @@
+#include "renderer/render_graph.hpp"
+
+#include "core/game.hpp"
+#include "tools/profiler.hpp"
+
+namespace bls
+{
+    RenderGraph::RenderGraph()
+    {
+        width = height = 0;
+        compiled = false;
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+    }
+
+    void RenderGraph::reset(u32 width, u32 height)
+    {
+        this->width = width;
+        this->height = height;
+
+        resources.clear();
+        passes.clear();
+        compiled = false;
+    }
+
+    RenderResource RenderGraph::create_texture(const str &name, const RenderTargetDesc &desc)
+    {
+        return add_resource(name, ResourceKind::Transient, desc, get_target_size(desc));
+    }
+
+    RenderResource RenderGraph::import_resource(const str &name, u64 size)
+    {
+        return add_resource(name, ResourceKind::Imported, {}, size);
+    }
+
+    RenderResource RenderGraph::get_backbuffer()
+    {
+        for (u32 i = 0; i < resources.size(); i++)
+            if (resources[i].kind == ResourceKind::Backbuffer) return i;
+
+        return add_resource("backbuffer", ResourceKind::Backbuffer, {width, height, ImageFormat::RGBA8, true}, 0);
+    }
+
+    void RenderGraph::add_pass(const str &name,
+                               const std::vector<RenderResource> &reads,
+                               const std::vector<RenderResource> &writes,
+                               RenderPassFunction execute)
+    {
+        u32 transient_writes = 0;
+        for (auto resource : writes)
+            if (resources[resource].kind == ResourceKind::Transient) transient_writes++;
+
+        if (transient_writes > 1)
+            throw std::runtime_error("render pass '" + name + "' writes more than one transient target");
+
+        passes.push_back({name, reads, writes, execute, false});
+        compiled = false;
+    }
+
+    void RenderGraph::compile()
+    {
+        BLS_PROFILE_SCOPE("render_graph_compile");
+
+        // Walk back from the passes with side effects (backbuffer or imported writes): a pass is only kept when a
+        // kept pass reads what it writes
+        std::vector<bool> needed(resources.size(), false);
+        for (u32 i = static_cast<u32>(passes.size()); i-- > 0;)
+        {
+            auto &pass = passes[i];
+
+            pass.culled = true;
+            for (auto resource : pass.writes)
+                if (resources[resource].kind != ResourceKind::Transient || needed[resource]) pass.culled = false;
+
+            if (pass.culled) continue;
+            for (auto resource : pass.reads) needed[resource] = true;
+        }
+
+        // Lifetimes over the kept passes
+        for (auto &resource : resources)
+        {
+            resource.first_use = RENDER_RESOURCE_NONE;
+            resource.last_use = 0;
+            resource.target = RENDER_RESOURCE_NONE;
+        }
+
+        for (u32 i = 0; i < passes.size(); i++)
+        {
+            if (passes[i].culled) continue;
+
+            for (const auto *list : {&passes[i].reads, &passes[i].writes})
+            {
+                for (auto resource : *list)
+                {
+                    resources[resource].first_use = min(resources[resource].first_use, i);
+                    resources[resource].last_use = max(resources[resource].last_use, i);
+                }
+            }
+        }
+
+        // Place the transient resources in the order they start, each one takes a free target of the same kind
+        std::vector<u32> order;
+        for (u32 i = 0; i < resources.size(); i++)
+            if (resources[i].kind == ResourceKind::Transient && resources[i].first_use != RENDER_RESOURCE_NONE)
+                order.push_back(i);
+
+        std::sort(order.begin(),
+                  order.end(),
+                  [this](u32 a, u32 b) { return resources[a].first_use < resources[b].first_use; });
+
+        for (auto &target : targets) target.used = false;
+        for (auto index : order) resources[index].target = acquire_target(resources[index]);
+
+        // The pool only keeps what this frame needs (e.g. after a resize)
+        std::vector<u32> remap(targets.size(), RENDER_RESOURCE_NONE);
+        std::vector<Target> kept;
+        for (u32 i = 0; i < targets.size(); i++)
+        {
+            if (!targets[i].used) continue;
+
+            remap[i] = static_cast<u32>(kept.size());
+            kept.push_back(std::move(targets[i]));
+        }
+
+        targets = std::move(kept);
+        for (auto index : order) resources[index].target = remap[resources[index].target];
+
+        compiled = true;
+    }
+
+    void RenderGraph::execute()
+    {
+        BLS_PROFILE_SCOPE("render_graph_execute");
+
+        if (!compiled) compile();
+
+        auto &renderer = Game::get().get_renderer();
+        for (auto &pass : passes)
+        {
+            if (pass.culled) continue;
+
+            Target *target = nullptr;
+            bool backbuffer = false;
+            for (auto resource : pass.writes)
+            {
+                if (resources[resource].kind == ResourceKind::Transient)
+                    target = &targets[resources[resource].target];
+
+                else if (resources[resource].kind == ResourceKind::Backbuffer)
+                    backbuffer = true;
+            }
+
+            if (target)
+            {
+                target->fbo->bind();
+                renderer.set_viewport(0, 0, target->desc.width, target->desc.height);
+                renderer.clear_color({0.0f, 0.0f, 0.0f, 1.0f});
+                renderer.clear();
+            }
+
+            else if (backbuffer)
+                renderer.set_viewport(0, 0, width, height);
+
+            pass.execute(*this);
+
+            if (target) target->fbo->unbind();
+        }
+    }
+
+    const RenderTargetDesc &RenderGraph::get_desc(RenderResource resource)
+    {
+        return resources[resource].desc;
+    }
+
+    Texture &RenderGraph::get_texture(RenderResource resource)
+    {
+        const auto &entry = resources[resource];
+        if (entry.kind != ResourceKind::Transient || entry.target == RENDER_RESOURCE_NONE)
+            throw std::runtime_error("render resource '" + entry.name + "' has no texture");
+
+        return *targets[entry.target].texture;
+    }
+
+    u64 RenderGraph::get_pool_memory() const
+    {
+        u64 size = 0;
+        for (const auto &target : targets) size += get_target_size(target.desc);
+
+        return size;
+    }
+
+    u64 RenderGraph::get_unaliased_memory() const
+    {
+        u64 size = 0;
+        for (const auto &resource : resources)
+            if (resource.kind == ResourceKind::Transient && resource.first_use != RENDER_RESOURCE_NONE)
+                size += resource.size;
+
+        return size;
+    }
+
+    u64 RenderGraph::get_imported_memory() const
+    {
+        u64 size = 0;
+        for (const auto &resource : resources)
+            if (resource.kind == ResourceKind::Imported) size += resource.size;
+
+        return size;
+    }
+
+    RenderResource RenderGraph::add_resource(const str &name,
+                                             ResourceKind kind,
+                                             const RenderTargetDesc &desc,
+                                             u64 size)
+    {
+        resources.push_back({name, kind, desc, size, RENDER_RESOURCE_NONE, 0, RENDER_RESOURCE_NONE});
+        compiled = false;
+
+        return static_cast<RenderResource>(resources.size() - 1);
+    }
+
+    u32 RenderGraph::acquire_target(const Resource &resource)
+    {
+        // A target is free once the last pass of its current resource ran
+        for (u32 i = 0; i < targets.size(); i++)
+        {
+            auto &target = targets[i];
+            if (!(target.desc == resource.desc) || (target.used && target.free_after >= resource.first_use)) continue;
+
+            target.used = true;
+            target.free_after = resource.last_use;
+            return i;
+        }
+
+        Target target = {resource.desc, nullptr, nullptr, nullptr, resource.last_use, true};
+
+        target.fbo = std::unique_ptr<FrameBuffer>(FrameBuffer::create());
+        target.texture = Texture::create(resource.desc.width,
+                                         resource.desc.height,
+                                         resource.desc.format,
+                                         TextureParameter::Repeat,
+                                         TextureParameter::Repeat,
+                                         TextureParameter::Linear,
+                                         TextureParameter::Linear);
+        target.fbo->attach_texture(target.texture.get());
+
+        if (resource.desc.depth)
+            target.depth = std::unique_ptr<RenderBuffer>(
+                RenderBuffer::create(resource.desc.width, resource.desc.height, AttachmentType::Depth));
+
+        if (!target.fbo->check()) throw std::runtime_error("render target '" + resource.name + "' is not complete");
+        target.fbo->unbind();
+
+        targets.push_back(std::move(target));
+        return static_cast<u32>(targets.size() - 1);
+    }
+
+    u64 RenderGraph::get_target_size(const RenderTargetDesc &desc)
+    {
+        const u64 pixels = static_cast<u64>(desc.width) * desc.height;
+        return pixels * Texture::get_format_size(desc.format) + (desc.depth ? pixels * 4 : 0);  // D24 in 4 bytes
+    }
+};  // namespace bls
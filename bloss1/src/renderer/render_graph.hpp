@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @brief Frame graph of render passes. Each frame the passes are declared in order with the resources they read
+ * and write, then the graph culls the passes nothing depends on and places the transient render targets in a pool
+ * of framebuffers: a target is reused by any later resource with the same description once its last reader ran,
+ * so a chain of post passes ping-pongs between two targets instead of owning one each. Imported resources (the
+ * G-buffer, the shadow atlas) are persistent and owned elsewhere, the graph only orders the passes around them.
+ */
+
+#include "renderer/buffers.hpp"
+#include "renderer/texture.hpp"
+
+#define RENDER_RESOURCE_NONE 0xFFFFFFFFU
+
+namespace bls
+{
+    class RenderGraph;
+
+    using RenderResource = u32;
+    using RenderPassFunction = std::function<void(RenderGraph &graph)>;
+
+    struct RenderTargetDesc
+    {
+            u32 width, height;
+            ImageFormat format;
+            bool depth;  // Also has a depth buffer
+
+            bool operator==(const RenderTargetDesc &other) const
+            {
+                return width == other.width && height == other.height && format == other.format &&
+                       depth == other.depth;
+            }
+    };
+
+    class RenderGraph
+    {
+        public:
+            RenderGraph();
+            ~RenderGraph();
+
+            // Start declaring a new frame drawn to a backbuffer of the given size. The pool is kept
+            void reset(u32 width, u32 height);
+
+            // A render target that only lives during the frame (its content is undefined before the first write)
+            RenderResource create_texture(const str &name, const RenderTargetDesc &desc);
+
+            // A persistent resource of 'size' bytes, bound and cleared by the passes that write it
+            RenderResource import_resource(const str &name, u64 size);
+
+            // The default framebuffer
+            RenderResource get_backbuffer();
+
+            // A pass writes at most one transient target: it is bound and cleared before 'execute' is called.
+            // Passes writing imported resources bind them themselves
+            void add_pass(const str &name,
+                          const std::vector<RenderResource> &reads,
+                          const std::vector<RenderResource> &writes,
+                          RenderPassFunction execute);
+
+            // Cull the passes, compute the resource lifetimes and assign the pool targets
+            void compile();
+            void execute();
+
+            const RenderTargetDesc &get_desc(RenderResource resource);
+            Texture &get_texture(RenderResource resource);  // Transient resources only
+
+            // Memory of the pool targets, of the transient resources if each had its own target and of the
+            // imported resources (bytes)
+            u64 get_pool_memory() const;
+            u64 get_unaliased_memory() const;
+            u64 get_imported_memory() const;
+
+        private:
+            enum class ResourceKind
+            {
+                Transient,
+                Imported,
+                Backbuffer
+            };
+
+            struct Resource
+            {
+                    str name;
+                    ResourceKind kind;
+                    RenderTargetDesc desc;
+                    u64 size;
+                    u32 first_use, last_use;  // Live passes
+                    u32 target;               // Pool index
+            };
+
+            struct Pass
+            {
+                    str name;
+                    std::vector<RenderResource> reads, writes;
+                    RenderPassFunction execute;
+                    bool culled;
+            };
+
+            struct Target
+            {
+                    RenderTargetDesc desc;
+                    std::unique_ptr<FrameBuffer> fbo;
+                    std::shared_ptr<Texture> texture;
+                    std::unique_ptr<RenderBuffer> depth;
+                    u32 free_after;  // Last pass reading the current resource
+                    bool used;
+            };
+
+            RenderResource add_resource(const str &name, ResourceKind kind, const RenderTargetDesc &desc, u64 size);
+            u32 acquire_target(const Resource &resource);
+            static u64 get_target_size(const RenderTargetDesc &desc);
+
+            u32 width, height;
+            std::vector<Resource> resources;
+            std::vector<Pass> passes;
+            std::vector<Target> targets;
+            bool compiled;
+    };
+};  // namespace bls
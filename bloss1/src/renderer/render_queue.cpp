@@ -0,0 +1,247 @@
+#include "renderer/render_queue.hpp"
+
+#include "config.hpp"
+#include "renderer/geometry_buffer.hpp"
+#include "renderer/model.hpp"
+#include "renderer/renderer.hpp"
+#include "tools/profiler.hpp"
+
+#define RENDER_QUEUE_DRAW_DATA_BINDING 2  // Matches the DrawData block of the scene shaders
+#define RENDER_QUEUE_DRAW_CAPACITY 1024
+
+namespace bls
+{
+    RenderQueue::RenderQueue()
+    {
+    }
+
+    RenderQueue::~RenderQueue()
+    {
+    }
+
+    u64 RenderQueue::make_key(u32 pass, u32 shader_id, const Mesh *mesh, f32 depth, f32 far) const
+    {
+        const u64 pass_bits = pass & 0xF;
+        const u64 shader_bits = shader_id;
+        const u64 material_bits = min(mesh->material->get_id(), 0xFFFFU);
+        const u64 mesh_bits = min(mesh->id, 0xFFFFU);
+        const u64 depth_bits = static_cast<u64>(clamp(depth / far, 0.0f, 1.0f) * 0xFFFFF);
+
+        return (pass_bits << 60) | (shader_bits << 52) | (material_bits << 36) | (mesh_bits << 20) | depth_bits;
+    }
+
+    void RenderQueue::submit(const DrawItem &item)
+    {
+        items.push_back(item);
+    }
+
+    void RenderQueue::submit(const std::vector<DrawItem> &items)
+    {
+        this->items.insert(this->items.end(), items.begin(), items.end());
+    }
+
+    u32 RenderQueue::get_shader_id(Shader *shader)
+    {
+        return get_id(shader_ids, shader, 0xFF);
+    }
+
+    void RenderQueue::flush(Renderer &renderer)
+    {
+        BLS_PROFILE_SCOPE("render_queue_flush");
+
+        sort();
+
+        // Binding places the meshes added since the last frame, so their offsets are known when building
+        auto &geometry = GeometryBuffer::get();
+        geometry.reserve_draw_indices(static_cast<u32>(sorted.size()));
+        geometry.bind();
+
+        build_commands();
+
+        if (batches.empty())
+        {
+            geometry.unbind();
+            items.clear();
+            return;
+        }
+
+        draw_data_buffer->bind_base(RENDER_QUEUE_DRAW_DATA_BINDING);
+        indirect_buffer->bind();
+
+        // Nothing is assumed to be bound when the queue starts
+        Shader *curr_shader = nullptr;
+        Material *curr_material = nullptr;
+        ShaderHandles *handles = nullptr;
+        const mat4 *curr_bones = nullptr;
+        std::vector<Texture *> bound_textures(MATERIAL_SLOTS, nullptr);
+
+        for (const auto &batch : batches)
+        {
+            const auto &item = items[sorted[batch.first_item]];
+
+            // Shader
+            if (item.shader != curr_shader)
+            {
+                curr_shader = item.shader;
+                curr_shader->bind();
+                handles = &get_handles(curr_shader);
+
+                // Uniforms belong to the program, so they must be set again
+                curr_bones = nullptr;
+            }
+
+            else
+                AppStats::render_stats.binds_avoided++;
+
+            // Bone matrices
+            if (item.bone_matrices != curr_bones)
+            {
+                curr_bones = item.bone_matrices;
+                curr_shader->set_uniform4(handles->bones, curr_bones, MAX_BONE_MATRICES);
+            }
+
+            else
+                AppStats::render_stats.binds_avoided++;
+
+            // Material: the samplers already point to their slots, so only the changed textures are bound
+            auto material = item.mesh->material.get();
+            if (material != curr_material)
+            {
+                curr_material = material;
+                for (u32 slot = 0; slot < MATERIAL_SLOTS; slot++)
+                {
+                    auto texture = material->get_texture(slot);
+                    if (!texture) continue;
+
+                    if (bound_textures[slot] != texture)
+                    {
+                        bound_textures[slot] = texture;
+                        texture->bind(slot);
+                    }
+
+                    else
+                        AppStats::render_stats.binds_avoided++;
+                }
+            }
+
+            else
+                AppStats::render_stats.binds_avoided++;
+
+            renderer.draw_indexed_indirect(RenderingMode::Triangles, batch.first_command, batch.command_count);
+
+            // Update stats
+            AppStats::render_stats.draw_calls++;
+        }
+
+        indirect_buffer->unbind();
+        geometry.unbind();
+
+        items.clear();
+    }
+
+    void RenderQueue::build_commands()
+    {
+        draw_data.clear();
+        commands.clear();
+        batches.clear();
+
+        const u32 count = static_cast<u32>(sorted.size());
+        for (u32 first = 0, last = 0; first < count; first = last)
+        {
+            const auto &item = items[sorted[first]];
+
+            // A batch shares the bound state: shader, bone matrices and material
+            Batch batch = {first, static_cast<u32>(commands.size()), 0};
+            for (last = first; last < count; last++)
+            {
+                const auto &next = items[sorted[last]];
+                if (next.shader != item.shader || next.bone_matrices != item.bone_matrices ||
+                    next.mesh->material != item.mesh->material)
+                    break;
+
+                // Consecutive items of the same mesh become the instances of one command
+                auto mesh = next.mesh;
+                if (last == first || items[sorted[last - 1]].mesh != mesh)
+                {
+                    const auto index_count = static_cast<u32>(mesh->indices.size());
+                    const auto base_vertex = static_cast<i32>(mesh->base_vertex);
+                    commands.push_back({index_count, 0, mesh->first_index, base_vertex, last});
+                    batch.command_count++;
+                }
+
+                commands.back().instance_count++;
+                AppStats::render_stats.vertices += mesh->vertices.size();
+            }
+
+            batches.push_back(batch);
+        }
+
+        // The instances read their model matrix through the draw index, which is the position in sorted order
+        for (const auto index : sorted) draw_data.push_back(items[index].model_matrix);
+
+        if (commands.empty()) return;
+
+        if (!draw_data_buffer)
+            draw_data_buffer.reset(StorageBuffer::create(RENDER_QUEUE_DRAW_CAPACITY * sizeof(mat4)));
+
+        if (!indirect_buffer)
+            indirect_buffer.reset(IndirectBuffer::create(RENDER_QUEUE_DRAW_CAPACITY * sizeof(DrawIndirectCommand)));
+
+        draw_data_buffer->set_data(draw_data.data(), draw_data.size() * sizeof(mat4));
+        indirect_buffer->set_data(commands.data(), commands.size() * sizeof(DrawIndirectCommand));
+    }
+
+    void RenderQueue::sort()
+    {
+        const u32 count = static_cast<u32>(items.size());
+
+        sorted.resize(count);
+        scratch.resize(count);
+        for (u32 i = 0; i < count; i++) sorted[i] = i;
+
+        // LSD radix sort, one byte at a time (stable, so previous passes are kept)
+        for (u32 shift = 0; shift < 64; shift += 8)
+        {
+            u32 offsets[257] = {};
+            for (u32 i = 0; i < count; i++) offsets[((items[i].key >> shift) & 0xFF) + 1]++;
+
+            // Every key has the same byte: nothing to reorder
+            bool same_byte = false;
+            for (u32 b = 1; b < 257; b++)
+                if (offsets[b] == count) same_byte = true;
+
+            if (same_byte) continue;
+
+            for (u32 b = 1; b < 257; b++) offsets[b] += offsets[b - 1];
+            for (const auto index : sorted) scratch[offsets[(items[index].key >> shift) & 0xFF]++] = index;
+
+            std::swap(sorted, scratch);
+        }
+    }
+
+    RenderQueue::ShaderHandles &RenderQueue::get_handles(Shader *shader)
+    {
+        auto it = shader_handles.find(shader);
+        if (it != shader_handles.end()) return it->second;
+
+        auto &handles = shader_handles[shader];
+        handles.bones = shader->get_uniform_handle("finalBonesMatrices");
+
+        // The shader is bound by now
+        Material::set_sampler_slots(*shader);
+
+        return handles;
+    }
+
+    u32 RenderQueue::get_id(std::unordered_map<const void *, u32> &ids, const void *object, u32 max_id)
+    {
+        auto it = ids.find(object);
+        if (it != ids.end()) return it->second;
+
+        // Ids past the limit share the last one: the sort gets coarser but the state tracking is still exact
+        const u32 id = min(static_cast<u32>(ids.size()), max_id);
+        ids[object] = id;
+
+        return id;
+    }
+};  // namespace bls
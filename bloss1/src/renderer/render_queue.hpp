@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @brief Collects draw items, sorts them by a 64 bit key and submits them issuing only the state changes
+ * that differ from the previous item. Consecutive items that share the shader, bone matrices and material
+ * form a batch drawn with one multi draw indirect call over the shared geometry buffer: each run of the same
+ * mesh is one command and the model matrices are streamed in sorted order to a storage buffer.
+ *
+ * Key layout (msb -> lsb): pass (4) | shader (8) | material (16) | mesh (16) | depth (20). Ids past the limit
+ * share the last one: the sort gets coarser but the state tracking is still exact.
+ */
+
+#include "renderer/buffers.hpp"
+#include "renderer/shader.hpp"
+
+namespace bls
+{
+    class Material;
+    class Mesh;
+    class Renderer;
+
+    struct DrawItem
+    {
+            u64 key;
+            Shader *shader;
+            Mesh *mesh;
+            const mat4 *bone_matrices;  // MAX_BONE_MATRICES matrices
+            mat4 model_matrix;
+    };
+
+    class RenderQueue
+    {
+        public:
+            RenderQueue();
+            ~RenderQueue();
+
+            // Build a key from the item state. Depth is the view space distance, normalized by 'far'. Only reads the
+            // mesh and material, so items can be recorded from several threads
+            u64 make_key(u32 pass, u32 shader_id, const Mesh *mesh, f32 depth, f32 far) const;
+            u32 get_shader_id(Shader *shader);
+
+            void submit(const DrawItem &item);
+            void submit(const std::vector<DrawItem> &items);
+            void flush(Renderer &renderer);
+
+        private:
+            // Cached per shader so the handles are resolved (and the material samplers set) only once
+            struct ShaderHandles
+            {
+                    UniformHandle bones;
+            };
+
+            // Items [first_item, ...) drawn by the commands [first_command, first_command + command_count)
+            struct Batch
+            {
+                    u32 first_item;
+                    u32 first_command;
+                    u32 command_count;
+            };
+
+            void sort();
+            void build_commands();  // Expects the geometry buffer to be up to date
+            ShaderHandles &get_handles(Shader *shader);
+
+            u32 get_id(std::unordered_map<const void *, u32> &ids, const void *object, u32 max_id);
+
+            std::vector<DrawItem> items;
+            std::vector<u32> sorted, scratch;
+
+            std::vector<Batch> batches;
+            std::vector<DrawIndirectCommand> commands;
+            std::vector<mat4> draw_data;
+            std::unique_ptr<IndirectBuffer> indirect_buffer;
+            std::unique_ptr<StorageBuffer> draw_data_buffer;
+
+            std::unordered_map<const void *, u32> shader_ids;
+            std::unordered_map<Shader *, ShaderHandles> shader_handles;
+    };
+};  // namespace bls
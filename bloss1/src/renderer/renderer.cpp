@@ -1,14 +1,24 @@
 #include "renderer/renderer.hpp"
 
 #include "core/logger.hpp"
+#include "core/render_thread.hpp"
 #include "managers/font_manager.hpp"
+#include "managers/material_manager.hpp"
 #include "managers/model_manager.hpp"
 #include "managers/shader_manager.hpp"
 #include "managers/texture_manager.hpp"
 #include "renderer/font.hpp"
 #include "renderer/model.hpp"
+#include "renderer/null/buffers.hpp"
+#include "renderer/null/font.hpp"
+#include "renderer/null/gpu_timer.hpp"
+#include "renderer/null/renderer.hpp"
+#include "renderer/null/shader.hpp"
+#include "renderer/null/skybox.hpp"
+#include "renderer/null/texture.hpp"
 #include "renderer/opengl/buffers.hpp"
 #include "renderer/opengl/font.hpp"
+#include "renderer/opengl/gpu_timer.hpp"
 #include "renderer/opengl/renderer.hpp"
 #include "renderer/opengl/shader.hpp"
 #include "renderer/opengl/skybox.hpp"
@@ -17,8 +27,26 @@
 
 namespace bls
 {
+#ifdef _OPENGL
+    static RendererBackend backend = RendererBackend::OpenGL;
+#else
+    static RendererBackend backend = RendererBackend::Null;
+#endif
+
+    void Renderer::set_backend(RendererBackend selected)
+    {
+        backend = selected;
+    }
+
+    RendererBackend Renderer::get_backend()
+    {
+        return backend;
+    }
+
     Renderer *Renderer::create()
     {
+        if (backend == RendererBackend::Null) return new NullRenderer();
+
 #ifdef _OPENGL
         return new OpenGLRenderer();
 #else
@@ -33,6 +61,11 @@ namespace bls
                            const u32 prefilter_resolution,
                            const u32 max_mip_levels)
     {
+        // Resources are created with the rendering context current (the render thread may be holding it)
+        RenderContextScope context;
+
+        if (backend == RendererBackend::Null) return new NullSkybox(path);
+
 #ifdef _OPENGL
         return new OpenGLSkybox(
             path, skybox_resolution, irradiance_resolution, brdf_resolution, prefilter_resolution, max_mip_levels);
@@ -50,6 +83,15 @@ namespace bls
     {
         if (ShaderManager::get().exists(name)) return ShaderManager::get().get_shader(name);
 
+        RenderContextScope context;
+
+        if (backend == RendererBackend::Null)
+        {
+            auto shader = std::make_shared<NullShader>();
+            ShaderManager::get().load(name, shader);
+            return shader;
+        }
+
 #ifdef _OPENGL
         auto shader =
             std::make_shared<OpenGLShader>(vertex_path, fragment_path, geometry_path, tess_ctrl_path, tess_eval_path);
@@ -60,15 +102,55 @@ namespace bls
 #endif
     }
 
+    std::shared_ptr<Shader> Shader::create_generated(const str &name,
+                                                     const str &vertex_path,
+                                                     const str &fragment_code)
+    {
+        if (ShaderManager::get().exists(name)) return ShaderManager::get().get_shader(name);
+
+        RenderContextScope context;
+
+        if (backend == RendererBackend::Null)
+        {
+            auto shader = std::make_shared<NullShader>();
+            ShaderManager::get().load(name, shader);
+            return shader;
+        }
+
+#ifdef _OPENGL
+        auto shader =
+            std::make_shared<OpenGLShader>(OpenGLShader::get_generated_stages(name, vertex_path, fragment_code));
+        ShaderManager::get().load(name, shader);
+        return shader;
+#else
+        return nullptr;
+#endif
+    }
+
     std::shared_ptr<Model> Model::create(const str &name, const str &path, bool flip_uvs)
     {
         if (ModelManager::get().exists(name)) return ModelManager::get().get_model(name);
 
+        RenderContextScope context;
+
         auto model = std::make_shared<Model>(path, flip_uvs);
         ModelManager::get().load(name, model);
         return model;
     }
 
+    std::shared_ptr<Material> Material::create(const std::vector<std::shared_ptr<Texture>> &textures)
+    {
+        // Identified by its textures
+        str name = "material";
+        for (const auto &texture : textures) name += "_" + to_str(texture->get_id());
+
+        if (MaterialManager::get().exists(name)) return MaterialManager::get().get_material(name);
+
+        auto material = std::make_shared<Material>(textures);
+        MaterialManager::get().load(name, material);
+        return material;
+    }
+
     std::shared_ptr<Texture> Texture::create(u32 width,
                                              u32 height,
                                              ImageFormat format,
@@ -77,6 +159,10 @@ namespace bls
                                              TextureParameter min_filter,
                                              TextureParameter mag_filter)
     {
+        RenderContextScope context;
+
+        if (backend == RendererBackend::Null) return std::make_shared<NullTexture>(width, height, format);
+
 #ifdef _OPENGL
         auto texture = std::make_shared<OpenGLTexture>(width, height, format, wrap_s, wrap_t, min_filter, mag_filter);
         return texture;
@@ -89,6 +175,15 @@ namespace bls
     {
         if (TextureManager::get().exists(name)) return TextureManager::get().get_texture(name);
 
+        RenderContextScope context;
+
+        if (backend == RendererBackend::Null)
+        {
+            auto texture = std::make_shared<NullTexture>(path, texture_type);
+            TextureManager::get().load(name, texture);
+            return texture;
+        }
+
 #ifdef _OPENGL
         auto texture = std::make_shared<OpenGLTexture>(path, texture_type);
         TextureManager::get().load(name, texture);
@@ -98,6 +193,33 @@ namespace bls
 #endif
     }
 
+    u32 Texture::get_format_size(ImageFormat format)
+    {
+        switch (format)
+        {
+            case ImageFormat::RGB8:
+                return 3;
+            case ImageFormat::RGBA8:
+                return 4;
+            case ImageFormat::RGBA16F:
+                return 8;
+            case ImageFormat::RG16:
+                return 4;
+            case ImageFormat::R32F:
+                return 4;
+            case ImageFormat::RGB32F:
+                return 12;
+            case ImageFormat::RGBA32F:
+                return 16;
+            case ImageFormat::Depth24:
+                return 4;  // Stored padded
+            default:
+                throw std::runtime_error("invalid image format\n");
+        }
+
+        return 0;
+    }
+
     std::shared_ptr<Texture> Texture::get_default(TextureType texture_type)
     {
         str name = "";
@@ -145,6 +267,15 @@ namespace bls
     {
         if (FontManager::get().exists(name)) return FontManager::get().get_font(name);
 
+        RenderContextScope context;
+
+        if (backend == RendererBackend::Null)
+        {
+            auto font = std::make_shared<NullFont>();
+            FontManager::get().load(name, font);
+            return font;
+        }
+
 #ifdef _OPENGL
         auto font = std::make_shared<OpenGLFont>(path);
         FontManager::get().load(name, font);
@@ -156,6 +287,8 @@ namespace bls
 
     VertexBuffer *VertexBuffer::create(void *vertices, u32 size)
     {
+        if (backend == RendererBackend::Null) return new NullVertexBuffer(vertices, size);
+
 #ifdef _OPENGL
         return new OpenGLVertexBuffer(vertices, size);
 #else
@@ -163,8 +296,21 @@ namespace bls
 #endif
     }
 
+    VertexBuffer *VertexBuffer::create(u32 size)
+    {
+        if (backend == RendererBackend::Null) return new NullVertexBuffer(size);
+
+#ifdef _OPENGL
+        return new OpenGLVertexBuffer(size);
+#else
+        return nullptr;
+#endif
+    }
+
     IndexBuffer *IndexBuffer::create(const std::vector<u32> &indices, u32 count)
     {
+        if (backend == RendererBackend::Null) return new NullIndexBuffer(indices, count);
+
 #ifdef _OPENGL
         return new OpenGLIndexBuffer(indices, count);
 #else
@@ -172,8 +318,43 @@ namespace bls
 #endif
     }
 
+    StorageBuffer *StorageBuffer::create(u32 size)
+    {
+        if (backend == RendererBackend::Null) return new NullStorageBuffer(size);
+
+#ifdef _OPENGL
+        return new OpenGLStorageBuffer(size);
+#else
+        return nullptr;
+#endif
+    }
+
+    UniformBuffer *UniformBuffer::create(u32 size)
+    {
+        if (backend == RendererBackend::Null) return new NullUniformBuffer(size);
+
+#ifdef _OPENGL
+        return new OpenGLUniformBuffer(size);
+#else
+        return nullptr;
+#endif
+    }
+
+    IndirectBuffer *IndirectBuffer::create(u32 size)
+    {
+        if (backend == RendererBackend::Null) return new NullIndirectBuffer(size);
+
+#ifdef _OPENGL
+        return new OpenGLIndirectBuffer(size);
+#else
+        return nullptr;
+#endif
+    }
+
     FrameBuffer *FrameBuffer::create()
     {
+        if (backend == RendererBackend::Null) return new NullFrameBuffer();
+
 #ifdef _OPENGL
         return new OpenGLFrameBuffer();
 #else
@@ -183,6 +364,8 @@ namespace bls
 
     RenderBuffer *RenderBuffer::create(u32 width, u32 height, AttachmentType type)
     {
+        if (backend == RendererBackend::Null) return new NullRenderBuffer(width, height, type);
+
 #ifdef _OPENGL
         return new OpenGLRenderBuffer(width, height, type);
 #else
@@ -190,8 +373,21 @@ namespace bls
 #endif
     }
 
+    GpuTimer *GpuTimer::create()
+    {
+        if (backend == RendererBackend::Null) return new NullGpuTimer();
+
+#ifdef _OPENGL
+        return new OpenGLGpuTimer();
+#else
+        return nullptr;
+#endif
+    }
+
     VertexArray *VertexArray::create()
     {
+        if (backend == RendererBackend::Null) return new NullVertexArray();
+
 #ifdef _OPENGL
         return new OpenGLVertexArray();
 #else
@@ -6,6 +6,10 @@
 
 #include "math/math.hpp"
 
+// Index of the depth in the g-buffer textures (normal, albedo, arm, emissive, depth)
+#define G_BUFFER_DEPTH_ATTACHMENT 4
+#define G_BUFFER_BYTES_PER_PIXEL 20U  // The color attachments (16) and the depth texture (4)
+
 namespace bls
 {
     enum class RenderingMode
@@ -16,6 +20,13 @@ namespace bls
         Patches
     };
 
+    // Backends that can be selected at startup
+    enum class RendererBackend
+    {
+        OpenGL,
+        Null  // No GPU work, the submitted work is only counted (headless runs)
+    };
+
     class Skybox;
     class Quad;
     class ShadowMap;
@@ -46,6 +57,13 @@ namespace bls
             virtual void clear() = 0;
             virtual void draw_indexed(RenderingMode mode, u32 count, const void *indices = 0) = 0;
             virtual void draw_arrays(RenderingMode mode, u32 count) = 0;
+            virtual void draw_indexed_instanced(RenderingMode mode,
+                                                u32 count,
+                                                u32 instance_count,
+                                                u32 base_instance = 0) = 0;
+
+            // Draw 'command_count' DrawIndirectCommands from the bound indirect buffer, starting at 'first_command'
+            virtual void draw_indexed_indirect(RenderingMode mode, u32 first_command, u32 command_count) = 0;
 
             virtual void create_skybox(const str &file,
                                        const u32 skybox_resolution,
@@ -57,7 +75,7 @@ namespace bls
             virtual void create_shadow_map(ECS &ecs) = 0;
 
             virtual void create_height_map(
-                u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 min_distance, f32 max_distance) = 0;
+                u32 width, u32 height, u32 min_tess_level, u32 max_tess_level, f32 pixels_per_edge) = 0;
 
             virtual void create_post_processing_passes(ECS &ecs) = 0;
 
@@ -72,5 +90,9 @@ namespace bls
 
             // Must be implemented by the platform
             static Renderer *create();
+
+            // Must be set before any renderer resource is created
+            static void set_backend(RendererBackend selected);
+            static RendererBackend get_backend();
     };
 };  // namespace bls
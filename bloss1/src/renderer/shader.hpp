@@ -8,6 +8,17 @@
 
 namespace bls
 {
+    // Pre-resolved uniform location. Store it once and reuse it to skip name lookups on hot paths
+    struct UniformHandle
+    {
+            i32 location = -1;
+
+            bool is_valid() const
+            {
+                return location >= 0;
+            }
+    };
+
     class Shader
     {
         public:
@@ -17,6 +28,9 @@ namespace bls
             virtual void bind() = 0;
             virtual void unbind() = 0;
 
+            // Resolve a uniform name (arrays can be set entirely through the handle of their first element)
+            virtual UniformHandle get_uniform_handle(const str &name) = 0;
+
             // Uniform functions
             virtual void set_uniform1(const str &name, bool value) = 0;
             virtual void set_uniform1(const str &name, u32 value) = 0;
@@ -30,6 +44,21 @@ namespace bls
             virtual void set_uniform4(const str &name, const vec4 &vector) = 0;
             virtual void set_uniform4(const str &name, const mat4 &matrix) = 0;
 
+            // Uniform functions (handles)
+            virtual void set_uniform1(UniformHandle handle, bool value) = 0;
+            virtual void set_uniform1(UniformHandle handle, u32 value) = 0;
+            virtual void set_uniform1(UniformHandle handle, f32 value) = 0;
+
+            virtual void set_uniform2(UniformHandle handle, const vec2 &vector) = 0;
+
+            virtual void set_uniform3(UniformHandle handle, const vec3 &vector) = 0;
+            virtual void set_uniform3(UniformHandle handle, const vec3 *vectors, u32 count) = 0;
+            virtual void set_uniform3(UniformHandle handle, const mat3 &matrix) = 0;
+
+            virtual void set_uniform4(UniformHandle handle, const vec4 &vector) = 0;
+            virtual void set_uniform4(UniformHandle handle, const mat4 &matrix) = 0;
+            virtual void set_uniform4(UniformHandle handle, const mat4 *matrices, u32 count) = 0;
+
             virtual vec3 get_uniform3(const str &name) = 0;
             virtual mat4 get_uniform4(const str &name) = 0;
 
@@ -39,5 +68,10 @@ namespace bls
                                                   const str &geometry_path = "",
                                                   const str &tess_ctrl_path = "",
                                                   const str &tess_eval_path = "");
+
+            // Same as above, but the fragment shader is GLSL code built at runtime
+            static std::shared_ptr<Shader> create_generated(const str &name,
+                                                            const str &vertex_path,
+                                                            const str &fragment_code);
     };
 };  // namespace bls
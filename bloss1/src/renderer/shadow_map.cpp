@@ -3,8 +3,10 @@
 #include <GL/glew.h>  // Include glew before glfw
 
 #include "GLFW/glfw3.h"
+#include "config.hpp"
 #include "core/game.hpp"
 #include "core/input.hpp"
+#include "core/logger.hpp"
 
 namespace bls
 {
@@ -17,12 +19,10 @@ namespace bls
                                  camera.far / (2.5f * zoom_factor),
                                  camera.far / (1.0f * zoom_factor),
                                  camera.far / (0.2f * zoom_factor)};
-        depth_map_resolution = 4096;
 
         shadow_map_depth = Shader::create("shadow_map_depth",
                                           "bloss1/assets/shaders/shadow_map_depth.vs",
-                                          "bloss1/assets/shaders/shadow_map_depth.fs",
-                                          "bloss1/assets/shaders/shadow_map_depth.gs");
+                                          "bloss1/assets/shaders/shadow_map_depth.fs");
 
         debug_depth = Shader::create(
             "debug_depth", "bloss1/assets/shaders/test/debug_depth.vs", "bloss1/assets/shaders/test/debug_depth.fs");
@@ -35,36 +35,11 @@ namespace bls
         // Create light depth buffers
         glGenFramebuffers(1, &light_FBO);
 
-        glGenTextures(1, &light_depth_maps);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, light_depth_maps);
-        glTexImage3D(GL_TEXTURE_2D_ARRAY,
-                     0,
-                     GL_DEPTH_COMPONENT32F,
-                     depth_map_resolution,
-                     depth_map_resolution,
-                     static_cast<i32>(shadow_cascade_levels.size()) + 1,
-                     0,
-                     GL_DEPTH_COMPONENT,
-                     GL_FLOAT,
-                     nullptr);
-
-        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        light_depth_maps = 0;
+        static_depth_maps = 0;
+        frame_counter = 0;
 
-        constexpr f32 bordercolor[] = {1.0f, 1.0f, 1.0f, 1.0f};
-        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, bordercolor);
-
-        glBindFramebuffer(GL_FRAMEBUFFER, light_FBO);
-        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, light_depth_maps, 0);
-        glDrawBuffer(GL_NONE);
-        glReadBuffer(GL_NONE);
-
-        int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-        if (status != GL_FRAMEBUFFER_COMPLETE) throw std::runtime_error("lightFBO framebuffer is not complete");
-
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        create_atlas();
 
         // Configure UBO
         glGenBuffers(1, &matrices_UBO);
@@ -79,45 +54,202 @@ namespace bls
         glDeleteFramebuffers(1, &light_FBO);
         glDeleteBuffers(1, &matrices_UBO);
         glDeleteTextures(1, &light_depth_maps);
+        glDeleteTextures(1, &static_depth_maps);
     }
 
     void ShadowMap::bind(const Camera &camera)
     {
-        // UBO setup
-        const auto lightMatrices = get_light_space_matrices(camera);
+        const auto &config = AppConfig::shadow_config;
+
+        // The static casters atlas only exists while caching is enabled
+        if (config.cache_static_casters && !static_depth_maps)
+        {
+            static_depth_maps = create_depth_texture();
+            invalidate();
+        }
+
+        else if (!config.cache_static_casters && static_depth_maps)
+        {
+            glDeleteTextures(1, &static_depth_maps);
+            static_depth_maps = 0;
+        }
+
+        const auto matrices = get_light_space_matrices(camera);
+        const u32 cascade_count = static_cast<u32>(matrices.size());
 
+        // Every cascade is rendered on the first frame
+        const bool first_frame = light_space_matrices.size() != cascade_count;
+        if (first_frame)
+        {
+            light_space_matrices = matrices;
+            static_matrices.assign(cascade_count, mat4(0.0f));
+            updating.assign(cascade_count, true);
+        }
+
+        // UBO setup (the cascades that are not updated keep the matrices their layers were rendered with)
         glBindBuffer(GL_UNIFORM_BUFFER, matrices_UBO);
-        for (size_t i = 0; i < lightMatrices.size(); i++)
-            glBufferSubData(GL_UNIFORM_BUFFER, i * sizeof(glm::mat4x4), sizeof(glm::mat4x4), &lightMatrices[i]);
+        for (u32 i = 0; i < cascade_count; i++)
+        {
+            u32 interval = 1;
+            if (i < config.cascade_update_intervals.size()) interval = max(config.cascade_update_intervals[i], 1U);
+
+            // Offset by the cascade so the far cascades do not all update on the same frame
+            updating[i] = first_frame || (frame_counter + i) % interval == 0;
+            if (!updating[i]) continue;
+
+            light_space_matrices[i] = matrices[i];
+            glBufferSubData(GL_UNIFORM_BUFFER, i * sizeof(glm::mat4x4), sizeof(glm::mat4x4), &light_space_matrices[i]);
+        }
 
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        frame_counter++;
 
         // Render depth of scene to texture (from light's perspective)
         shadow_map_depth->bind();
         glBindFramebuffer(GL_FRAMEBUFFER, light_FBO);
-        glViewport(0, 0, depth_map_resolution, depth_map_resolution);
+        glEnable(GL_SCISSOR_TEST);  // Clears must only touch the cascade region
+        glCullFace(GL_FRONT);       // peter panning (dont forget to reset after render)
+    }
+
+    bool ShadowMap::should_update(u32 cascade) const
+    {
+        return updating[cascade];
+    }
+
+    bool ShadowMap::should_update_static(u32 cascade) const
+    {
+        // The cascades are texel snapped, so the cached region stays valid until the matrix moves by a whole texel
+        return updating[cascade] && static_depth_maps && static_matrices[cascade] != light_space_matrices[cascade];
+    }
+
+    void ShadowMap::bind_static_cascade(u32 cascade)
+    {
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, static_depth_maps, 0);
+        set_cascade_region(cascade);
         glClear(GL_DEPTH_BUFFER_BIT);
-        glCullFace(GL_FRONT);  // peter panning (dont forget to reset after render)
+
+        shadow_map_depth->bind();
+        shadow_map_depth->set_uniform1("cascade", cascade);
+
+        static_matrices[cascade] = light_space_matrices[cascade];
+    }
+
+    void ShadowMap::bind_cascade(u32 cascade)
+    {
+        // Each cascade is a separate pass into its own atlas region, so casters are only drawn where they are visible
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, light_depth_maps, 0);
+        set_cascade_region(cascade);
+
+        // Start from the cached static casters (the dynamic ones are drawn on top)
+        if (static_depth_maps)
+        {
+            const auto &rect = cascade_rects[cascade];
+            glCopyImageSubData(static_depth_maps,
+                               GL_TEXTURE_2D,
+                               0,
+                               rect.x,
+                               rect.y,
+                               0,
+                               light_depth_maps,
+                               GL_TEXTURE_2D,
+                               0,
+                               rect.x,
+                               rect.y,
+                               0,
+                               rect.size,
+                               rect.size,
+                               1);
+        }
+
+        else
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+        shadow_map_depth->bind();
+        shadow_map_depth->set_uniform1("cascade", cascade);
+    }
+
+    void ShadowMap::invalidate()
+    {
+        static_matrices.assign(static_matrices.size(), mat4(0.0f));
     }
 
     void ShadowMap::unbind()
     {
         glCullFace(GL_BACK);
+        glDisable(GL_SCISSOR_TEST);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         shadow_map_depth->unbind();
     }
 
+    void ShadowMap::apply_config()
+    {
+        const auto old_rects = cascade_rects;
+        const u32 old_width = atlas_width, old_height = atlas_height;
+
+        pack_atlas();
+        if (atlas_width > get_max_atlas_size() || atlas_height > get_max_atlas_size())
+        {
+            LOG_WARNING("shadow atlas of %ux%u is larger than the max texture size, keeping the current one",
+                        atlas_width,
+                        atlas_height);
+
+            cascade_rects = old_rects;
+            atlas_width = old_width;
+            atlas_height = old_height;
+            return;
+        }
+
+        glDeleteTextures(1, &light_depth_maps);
+        glDeleteTextures(1, &static_depth_maps);
+        light_depth_maps = 0;
+        static_depth_maps = 0;
+
+        create_atlas();
+
+        // Render every cascade again
+        light_space_matrices.clear();
+    }
+
+    u32 ShadowMap::get_max_atlas_size()
+    {
+        i32 max_size = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+
+        return static_cast<u32>(max(max_size, 1));
+    }
+
+    u64 ShadowMap::get_memory_usage() const
+    {
+        u64 bytes_per_texel = AppConfig::shadow_config.depth_bits == 16 ? 2 : 4;
+        u64 atlas_bytes = static_cast<u64>(atlas_width) * atlas_height * bytes_per_texel;
+
+        return static_depth_maps ? atlas_bytes * 2 : atlas_bytes;
+    }
+
+    u32 ShadowMap::get_atlas_width() const
+    {
+        return atlas_width;
+    }
+
+    u32 ShadowMap::get_atlas_height() const
+    {
+        return atlas_height;
+    }
+
     void ShadowMap::bind_maps(Shader &shader, u32 slot)
     {
         // Set shadow map uniforms
         shader.set_uniform1("textures.shadowMap", slot);
         glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, light_depth_maps);
+        glBindTexture(GL_TEXTURE_2D, light_depth_maps);
 
         shader.set_uniform1("cascadeCount", static_cast<u32>(shadow_cascade_levels.size()));
 
         for (u64 i = 0; i < shadow_cascade_levels.size(); i++)
             shader.set_uniform1("cascadePlaneDistances[" + to_str(i) + "]", shadow_cascade_levels[i]);
+
+        for (u64 i = 0; i < cascade_rects.size(); i++)
+            shader.set_uniform4("cascadeAtlasRects[" + to_str(i) + "]", get_atlas_rect(i));
     }
 
     u32 layer = 0;
@@ -126,7 +258,7 @@ namespace bls
     {
         if (Input::is_key_pressed(KEY_SPACE) && released)
         {
-            layer = (layer + 1) % 5;
+            layer = (layer + 1) % cascade_rects.size();
             released = false;
         }
 
@@ -134,10 +266,10 @@ namespace bls
 
         // Render Depth map for visual debugging
         debug_depth->bind();
-        debug_depth->set_uniform1("layer", layer);
+        debug_depth->set_uniform4("atlasRect", get_atlas_rect(layer));
 
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, light_depth_maps);
+        glBindTexture(GL_TEXTURE_2D, light_depth_maps);
         debug_quad->render();
     }
 
@@ -156,6 +288,16 @@ namespace bls
         return *shadow_map_depth;
     }
 
+    u32 ShadowMap::get_cascade_count() const
+    {
+        return static_cast<u32>(light_space_matrices.size());
+    }
+
+    const mat4 &ShadowMap::get_light_space_matrix(u32 cascade) const
+    {
+        return light_space_matrices[cascade];
+    }
+
     std::vector<vec4> ShadowMap::get_frustum_corners_world_space(const mat4 &projview)
     {
         const mat4 inv = inverse(projview);
@@ -181,7 +323,7 @@ namespace bls
         return get_frustum_corners_world_space(proj * view);
     }
 
-    mat4 ShadowMap::get_light_space_matrix(const Camera &camera, f32 near, f32 far)
+    mat4 ShadowMap::get_light_space_matrix(const Camera &camera, f32 near, f32 far, u32 resolution)
     {
         auto &window = Game::get().get_window();
         f32 width = window.get_width();
@@ -196,42 +338,175 @@ namespace bls
 
         center /= corners.size();
 
-        const mat4 lightView = lookAt(center + light_dir, center, vec3(0.0f, 1.0f, 0.0f));
+        // Fit a sphere instead of a box: its size does not change when the camera rotates
+        f32 radius = 0.0f;
+        for (const vec4 &v : corners) radius = max(radius, distance(vec3(v), center));
+
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // Snap the center to whole texels in light space so the cascade only moves in texel steps. The view is
+        // anchored at the origin, otherwise it would move with the camera
+        const mat4 lightView = lookAt(vec3(0.0f), -light_dir, vec3(0.0f, 1.0f, 0.0f));
+        const f32 texel_size = (2.0f * radius) / resolution;
+
+        vec3 light_center = vec3(lightView * vec4(center, 1.0f));
+        light_center = floor(light_center / texel_size) * texel_size;
+
+        // Tune this parameter according to the scene (extends the depth range towards the light)
+        constexpr f32 zMult = 10.0f;
+
+        const mat4 lightProjection = glm::ortho(light_center.x - radius,
+                                                light_center.x + radius,
+                                                light_center.y - radius,
+                                                light_center.y + radius,
+                                                -light_center.z - radius * zMult,
+                                                -light_center.z + radius);
+
+        return lightProjection * lightView;
+    }
+
+    void ShadowMap::create_atlas()
+    {
+        pack_atlas();
+
+        if (atlas_width > get_max_atlas_size() || atlas_height > get_max_atlas_size())
+            throw std::runtime_error("shadow atlas is larger than the max texture size");
+
+        light_depth_maps = create_depth_texture();
+        if (AppConfig::shadow_config.cache_static_casters) static_depth_maps = create_depth_texture();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, light_FBO);
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, light_depth_maps, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
 
-        f32 minX = std::numeric_limits<f32>::max();
-        f32 maxX = std::numeric_limits<f32>::lowest();
-        f32 minY = std::numeric_limits<f32>::max();
-        f32 maxY = std::numeric_limits<f32>::lowest();
-        f32 minZ = std::numeric_limits<f32>::max();
-        f32 maxZ = std::numeric_limits<f32>::lowest();
+        int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) throw std::runtime_error("lightFBO framebuffer is not complete");
 
-        for (const vec4 &v : corners)
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        LOG_INFO("shadow atlas: %ux%u, %u bit depth, %.1f MB",
+                 atlas_width,
+                 atlas_height,
+                 AppConfig::shadow_config.depth_bits,
+                 get_memory_usage() / (1024.0f * 1024.0f));
+    }
+
+    void ShadowMap::pack_atlas()
+    {
+        const auto &resolutions = AppConfig::shadow_config.cascade_resolutions;
+        const u32 cascade_count = static_cast<u32>(shadow_cascade_levels.size()) + 1;
+
+        // Cascades past the configured ones use the last resolution
+        cascade_rects.resize(cascade_count);
+        for (u32 i = 0; i < cascade_count; i++)
         {
-            const vec4 trf = lightView * v;
-            minX = min(minX, trf.x);
-            maxX = max(maxX, trf.x);
-            minY = min(minY, trf.y);
-            maxY = max(maxY, trf.y);
-            minZ = min(minZ, trf.z);
-            maxZ = max(maxZ, trf.z);
+            u32 size = SHADOW_DEFAULT_RESOLUTION;
+            if (!resolutions.empty()) size = resolutions[min(i, static_cast<u32>(resolutions.size()) - 1)];
+
+            cascade_rects[i] = {0, 0, max(size, 1U)};
         }
 
-        // Tune this parameter according to the scene
-        constexpr f32 zMult = 10.0f;
-        if (minZ < 0)
-            minZ *= zMult;
+        // Place the largest cascades first
+        std::vector<u32> order;
+        for (u32 i = 0; i < cascade_count; i++) order.push_back(i);
 
-        else
-            minZ /= zMult;
+        std::sort(order.begin(),
+                  order.end(),
+                  [this](u32 a, u32 b) { return cascade_rects[a].size > cascade_rects[b].size; });
 
-        if (maxZ < 0)
-            maxZ /= zMult;
+        // Guillotine packing: the atlas is as wide as the largest cascade and grows downwards. Each placed cascade
+        // splits its free rect into the space to its right and the space below it
+        struct FreeRect
+        {
+                u32 x, y, width, height;
+        };
 
-        else
-            maxZ *= zMult;
+        atlas_width = cascade_rects[order[0]].size;
+        atlas_height = 0;
 
-        const mat4 lightProjection = glm::ortho(minX, maxX, minY, maxY, minZ, maxZ);
-        return lightProjection * lightView;
+        std::vector<FreeRect> free_rects = {{0, 0, atlas_width, std::numeric_limits<u32>::max()}};
+        for (const auto index : order)
+        {
+            auto &rect = cascade_rects[index];
+
+            // The topmost free rect that fits (the bottom one always does)
+            u32 best = free_rects.size();
+            for (u32 i = 0; i < free_rects.size(); i++)
+            {
+                const auto &free_rect = free_rects[i];
+                if (free_rect.width < rect.size || free_rect.height < rect.size) continue;
+                if (best == free_rects.size() || free_rect.y < free_rects[best].y) best = i;
+            }
+
+            const auto free_rect = free_rects[best];
+            free_rects.erase(free_rects.begin() + best);
+
+            rect.x = free_rect.x;
+            rect.y = free_rect.y;
+
+            if (free_rect.width > rect.size)
+                free_rects.push_back({rect.x + rect.size, rect.y, free_rect.width - rect.size, rect.size});
+
+            if (free_rect.height > rect.size)
+                free_rects.push_back({rect.x, rect.y + rect.size, free_rect.width, free_rect.height - rect.size});
+
+            atlas_height = max(atlas_height, rect.y + rect.size);
+        }
+    }
+
+    u32 ShadowMap::create_depth_texture()
+    {
+        // 16 bit depth halves the memory, 32 bit float is the most precise
+        u32 internal_format = GL_DEPTH_COMPONENT32F, type = GL_FLOAT;
+        switch (AppConfig::shadow_config.depth_bits)
+        {
+            case 16:
+                internal_format = GL_DEPTH_COMPONENT16;
+                type = GL_UNSIGNED_SHORT;
+                break;
+
+            case 24:
+                internal_format = GL_DEPTH_COMPONENT24;
+                type = GL_UNSIGNED_INT;
+                break;
+
+            default:
+                break;
+        }
+
+        u32 depth_map = 0;
+
+        glGenTextures(1, &depth_map);
+        glBindTexture(GL_TEXTURE_2D, depth_map);
+        glTexImage2D(
+            GL_TEXTURE_2D, 0, internal_format, atlas_width, atlas_height, 0, GL_DEPTH_COMPONENT, type, nullptr);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+        constexpr f32 bordercolor[] = {1.0f, 1.0f, 1.0f, 1.0f};
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, bordercolor);
+
+        return depth_map;
+    }
+
+    void ShadowMap::set_cascade_region(u32 cascade)
+    {
+        const auto &rect = cascade_rects[cascade];
+        glViewport(rect.x, rect.y, rect.size, rect.size);
+        glScissor(rect.x, rect.y, rect.size, rect.size);
+    }
+
+    vec4 ShadowMap::get_atlas_rect(u32 cascade) const
+    {
+        // Offset and scale in texture coordinates
+        const auto &rect = cascade_rects[cascade];
+        const vec2 atlas_size = vec2(atlas_width, atlas_height);
+
+        return vec4(vec2(rect.x, rect.y) / atlas_size, vec2(rect.size) / atlas_size);
     }
 
     std::vector<mat4> ShadowMap::get_light_space_matrices(const Camera &camera)
@@ -239,14 +514,16 @@ namespace bls
         std::vector<mat4> ret;
         for (size_t i = 0; i < shadow_cascade_levels.size() + 1; i++)
         {
+            const u32 resolution = cascade_rects[i].size;
             if (i == 0)
-                ret.push_back(get_light_space_matrix(camera, camera.near, shadow_cascade_levels[i]));
+                ret.push_back(get_light_space_matrix(camera, camera.near, shadow_cascade_levels[i], resolution));
 
             else if (i < shadow_cascade_levels.size())
-                ret.push_back(get_light_space_matrix(camera, shadow_cascade_levels[i - 1], shadow_cascade_levels[i]));
+                ret.push_back(get_light_space_matrix(
+                    camera, shadow_cascade_levels[i - 1], shadow_cascade_levels[i], resolution));
 
             else
-                ret.push_back(get_light_space_matrix(camera, shadow_cascade_levels[i - 1], camera.far));
+                ret.push_back(get_light_space_matrix(camera, shadow_cascade_levels[i - 1], camera.far, resolution));
         }
         return ret;
     }
@@ -9,6 +9,8 @@
 #include "renderer/primitives/quad.hpp"
 #include "renderer/shader.hpp"
 
+#define SHADOW_DEFAULT_RESOLUTION 2048U
+
 namespace bls
 {
     class ShadowMap
@@ -17,30 +19,67 @@ namespace bls
             ShadowMap(const Camera &camera, const vec3 &light_dir);
             ~ShadowMap();
 
+            // Update the cascades for the camera, then render each one in its own pass with 'bind_cascade'.
+            // Cascades are only re-rendered on their update frame, and the cached static casters layer of a cascade
+            // is only re-rendered (with 'bind_static_cascade') when it was invalidated
             void bind(const Camera &camera);
+            bool should_update(u32 cascade) const;
+            bool should_update_static(u32 cascade) const;
+            void bind_static_cascade(u32 cascade);
+            void bind_cascade(u32 cascade);
             void unbind();
+
+            // Force the static casters to be rendered again (e.g. a static caster moved)
+            void invalidate();
             void bind_maps(Shader &shader, u32 slot);
 
+            // Recreate the atlas after the resolutions or the depth format changed. An atlas larger than the max
+            // texture size is rejected and the current one is kept
+            void apply_config();
+            static u32 get_max_atlas_size();
+            u64 get_memory_usage() const;
+            u32 get_atlas_width() const;
+            u32 get_atlas_height() const;
+
             void set_light_dir(const vec3 &light_dir);
             vec3 get_light_dir();
             Shader &get_shadow_depth_shader() const;
+            u32 get_cascade_count() const;
+            const mat4 &get_light_space_matrix(u32 cascade) const;
             void render_debug();
 
         private:
             std::vector<vec4> get_frustum_corners_world_space(const mat4 &projview);
             std::vector<vec4> get_frustum_corners_world_space(const mat4 &proj, const mat4 &view);
-            mat4 get_light_space_matrix(const Camera &camera, f32 near, f32 far);
+            mat4 get_light_space_matrix(const Camera &camera, f32 near, f32 far, u32 resolution);
             std::vector<mat4> get_light_space_matrices(const Camera &camera);
 
+            void create_atlas();
+            void pack_atlas();
+            u32 create_depth_texture();
+            void set_cascade_region(u32 cascade);
+            vec4 get_atlas_rect(u32 cascade) const;
+
+            // Square region of a cascade in the atlas (in texels)
+            struct CascadeRect
+            {
+                    u32 x, y, size;
+            };
+
             std::shared_ptr<Shader> shadow_map_depth;
             std::shared_ptr<Shader> debug_depth;
 
             vec3 light_dir;
 
             std::vector<f32> shadow_cascade_levels;
+            std::vector<mat4> light_space_matrices;  // Matrices the live layers were rendered with
+            std::vector<mat4> static_matrices;       // Matrices the cached static layers were rendered with
+            std::vector<bool> updating;
+            u64 frame_counter;
             u32 light_FBO, matrices_UBO;
-            u32 light_depth_maps;
-            u32 depth_map_resolution;
+            u32 light_depth_maps, static_depth_maps;
+            std::vector<CascadeRect> cascade_rects;
+            u32 atlas_width, atlas_height;
             std::unique_ptr<Quad> debug_quad;
     };
 };  // namespace bls
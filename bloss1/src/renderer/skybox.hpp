@@ -15,7 +15,7 @@ namespace bls
             virtual ~Skybox(){};
 
             virtual void bind(Shader &shader, u32 slot) = 0;
-            virtual void draw(const mat4 &view, const mat4 &projection) = 0;
+            virtual void draw() = 0;  // The camera comes from the FrameData block
             virtual str get_path() const = 0;
 
             static Skybox *create(const str &path,
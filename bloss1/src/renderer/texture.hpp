@@ -24,8 +24,12 @@ namespace bls
     {
         RGB8,
         RGBA8,
+        RGBA16F,
+        RG16,  // Unsigned normalized
+        R32F,
         RGB32F,
-        RGBA32F
+        RGBA32F,
+        Depth24  // Depth component, sampled in the red channel
     };
 
     enum class TextureParameter
@@ -59,5 +63,7 @@ namespace bls
                                                    TextureParameter min_filter,
                                                    TextureParameter mag_filter);
             static std::shared_ptr<Texture> create(const str &name, const str &path, TextureType texture_type);
+
+            static u32 get_format_size(ImageFormat format);  // Bytes per pixel
     };
 };  // namespace bls
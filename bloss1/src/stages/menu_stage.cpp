@@ -31,7 +31,7 @@ namespace bls
         SceneParser::parse_scene(*ecs, "bloss1/assets/scenes/menu.bloss");
 
         auto &renderer = Game::get().get_renderer();
-        if (renderer.get_shadow_map() == nullptr)
+        if (renderer.get_skybox() == nullptr)
         {
             renderer.create_skybox("bloss1/assets/textures/satara_night_no_lamps_4k.hdr",
                                    AppConfig::skybox_config.skybox_resolution,
@@ -41,7 +41,7 @@ namespace bls
                                    AppConfig::skybox_config.max_mip_levels);
 
             renderer.create_shadow_map(*ecs);
-            renderer.create_height_map(2048, 2048, 4, 64, 20.0f, 1000.0f);
+            renderer.create_height_map(2048, 2048, 4, 64, 16.0f);
             renderer.create_post_processing_passes(*ecs);
         }
 
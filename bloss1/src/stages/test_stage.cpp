@@ -34,7 +34,7 @@ namespace bls
         SceneParser::parse_scene(*ecs, "bloss1/assets/scenes/test_stage.bloss");
 
         auto &renderer = Game::get().get_renderer();
-        if (renderer.get_shadow_map() == nullptr)
+        if (renderer.get_skybox() == nullptr)
         {
             renderer.create_skybox("bloss1/assets/textures/satara_night_no_lamps_4k.hdr",
                                    AppConfig::skybox_config.skybox_resolution,